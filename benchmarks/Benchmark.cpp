@@ -0,0 +1,116 @@
+#include "Benchmark.hpp"
+
+#include <fmt/format.h>
+#include <fstream>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace tek::benchmarks {
+    namespace {
+        struct Entry
+        {
+            std::string name;
+            BenchmarkFn benchmark;
+        };
+
+        struct Report
+        {
+            Measurement measurement;
+            double      seconds;
+            std::size_t start_rss_kb;
+        };
+
+        std::vector<Entry> &registry()
+        {
+            static std::vector<Entry> entries;
+            return entries;
+        }
+
+        std::string format_rate(const double amount, const double seconds, const std::string &unit)
+        {
+            if (amount == 0 || seconds <= 0) { return "-"; }
+            return fmt::format("{:.1f} {}/s", amount / seconds, unit);
+        }
+
+        bool run_one(const Entry &entry, const Options &options)
+        {
+            int channel[2];
+            if (pipe(channel) != 0) { return false; }
+
+            const pid_t pid = fork();
+            if (pid < 0) { return false; }
+
+            if (pid == 0) {
+                close(channel[0]);
+                Stopwatch    stopwatch;
+                const Report report{ entry.benchmark(options, stopwatch),
+                                     stopwatch.seconds(),
+                                     stopwatch.rss_at_start_kb() };
+                const auto   written = write(channel[1], &report, sizeof(report));
+                _exit(written == sizeof(report) ? 0 : 1);
+            }
+
+            close(channel[1]);
+            Report     report{};
+            const auto received = read(channel[0], &report, sizeof(report));
+            close(channel[0]);
+
+            int           status = 0;
+            struct rusage usage {};
+            wait4(pid, &status, 0, &usage);
+
+            if (received != sizeof(report) || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                fmt::print("{:<40} FAILED\n", entry.name);
+                return false;
+            }
+
+            const auto peak_rss_kb = static_cast<std::size_t>(usage.ru_maxrss);
+            const auto growth_kb   = peak_rss_kb > report.start_rss_kb ? peak_rss_kb - report.start_rss_kb : 0;
+            fmt::print(
+              "{:<40} {:>10.3f} ms {:>14} {:>16} {:>10} KiB peak {:>10} KiB growth\n",
+              entry.name,
+              report.seconds * 1000,
+              format_rate(static_cast<double>(report.measurement.bytes) / (1024 * 1024), report.seconds, "MB"),
+              format_rate(static_cast<double>(report.measurement.items), report.seconds, "op"),
+              peak_rss_kb,
+              growth_kb);
+            return true;
+        }
+    }// namespace
+
+    void Stopwatch::start()
+    {
+        this->start_rss_kb = current_rss_kb();
+        this->started      = std::chrono::steady_clock::now();
+    }
+
+    void Stopwatch::stop() { this->elapsed += std::chrono::steady_clock::now() - this->started; }
+
+    bool register_benchmark(std::string name, BenchmarkFn benchmark)
+    {
+        registry().push_back(Entry{ std::move(name), benchmark });
+        return true;
+    }
+
+    int run_benchmarks(const Options &options)
+    {
+        bool succeeded = true;
+        for (const auto &entry : registry()) {
+            if (entry.name.find(options.filter) == std::string::npos) { continue; }
+            succeeded = run_one(entry, options) && succeeded;
+        }
+        return succeeded ? 0 : 1;
+    }
+
+    std::size_t current_rss_kb()
+    {
+        std::ifstream statm{ "/proc/self/statm" };
+        std::size_t   size     = 0;
+        std::size_t   resident = 0;
+        statm >> size >> resident;
+        return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE)) / 1024;
+    }
+}// namespace tek::benchmarks
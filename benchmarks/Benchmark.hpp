@@ -0,0 +1,48 @@
+#ifndef TEK_BENCHMARK_HPP
+#define TEK_BENCHMARK_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace tek::benchmarks {
+    struct Options
+    {
+        std::string filter;
+        std::size_t size_mb = 16;
+    };
+
+    // What a benchmark went through while the stopwatch was running, used to derive throughput.
+    struct Measurement
+    {
+        std::size_t bytes = 0;
+        std::size_t items = 0;
+    };
+
+    class Stopwatch
+    {
+      public:
+        void start();
+        void stop();
+
+        [[nodiscard]] double      seconds() const { return this->elapsed.count(); }
+        [[nodiscard]] std::size_t rss_at_start_kb() const { return this->start_rss_kb; }
+
+      private:
+        std::chrono::steady_clock::time_point started;
+        std::chrono::duration<double>         elapsed{ 0 };
+        std::size_t                           start_rss_kb = 0;
+    };
+
+    using BenchmarkFn = Measurement (*)(const Options &options, Stopwatch &stopwatch);
+
+    // Benchmarks register themselves at static initialization time, see the *Benchmarks.cpp files.
+    bool register_benchmark(std::string name, BenchmarkFn benchmark);
+
+    // Every benchmark runs in a forked child so that peak memory is accounted to it alone.
+    int run_benchmarks(const Options &options);
+
+    [[nodiscard]] std::size_t current_rss_kb();
+}// namespace tek::benchmarks
+
+#endif// TEK_BENCHMARK_HPP
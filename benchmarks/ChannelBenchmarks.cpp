@@ -0,0 +1,77 @@
+#include "../src/interpreter/Channels.hpp"
+#include "Benchmark.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tek::benchmarks {
+    namespace {
+        // Room for a few messages only, so that senders and receivers keep running into a full or empty channel.
+        constexpr std::size_t capacity = 64;
+
+        // Long enough not to fit the small string buffer, copying them on the way through would show.
+        constexpr std::size_t message_size = 256;
+
+        // `producers` threads sending strings through one channel to `consumers` threads, closed once all were sent.
+        Measurement channels(
+          const std::size_t producers,
+          const std::size_t consumers,
+          const Options    &options,
+          Stopwatch        &stopwatch)
+        {
+            const std::size_t per_producer = options.size_mb * 1024 * 1024 / message_size / producers;
+
+            interpreter::ChannelState channel(capacity);
+            std::vector<std::size_t>  received(consumers, 0);
+            const std::atomic<bool>   cancelled{ false };
+
+            std::vector<std::thread> senders;
+            std::vector<std::thread> receivers;
+            stopwatch.start();
+            for (std::size_t i = 0; i < consumers; ++i) {
+                receivers.emplace_back([&, i]() {
+                    while (channel.receive(cancelled)) { ++received[i]; }
+                });
+            }
+            for (std::size_t i = 0; i < producers; ++i) {
+                senders.emplace_back([&]() {
+                    for (std::size_t sent = 0; sent < per_producer; ++sent) {
+                        types::Literal message(std::string(message_size, 'x'));
+                        if (!channel.send(message, cancelled)) { std::abort(); }
+                    }
+                });
+            }
+            for (auto &sender : senders) { sender.join(); }
+            channel.close();
+            for (auto &receiver : receivers) { receiver.join(); }
+            stopwatch.stop();
+
+            std::size_t messages = 0;
+            for (const auto count : received) { messages += count; }
+            if (messages != per_producer * producers) { std::abort(); }
+            return Measurement{ messages * message_size, messages };
+        }
+
+        Measurement channels_1to1(const Options &options, Stopwatch &stopwatch)
+        {
+            return channels(1, 1, options, stopwatch);
+        }
+
+        Measurement channels_Nto1(const Options &options, Stopwatch &stopwatch)
+        {
+            return channels(4, 1, options, stopwatch);
+        }
+
+        Measurement channels_NtoM(const Options &options, Stopwatch &stopwatch)
+        {
+            return channels(4, 4, options, stopwatch);
+        }
+
+        const bool registered = register_benchmark("channels/1to1", &channels_1to1)
+                                && register_benchmark("channels/Nto1", &channels_Nto1)
+                                && register_benchmark("channels/NtoM", &channels_NtoM);
+    }// namespace
+}// namespace tek::benchmarks
@@ -0,0 +1,113 @@
+#include "../src/engine/Engine.hpp"
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tek::benchmarks {
+    namespace {
+        // A handler sized script, the kind a host runs on every request with a few inputs bound.
+        constexpr std::string_view handler = R"(
+            fun clamp(value, low, high) {
+                if (value < low) return low;
+                if (value > high) return high;
+                return value;
+            }
+            var price = clamp(base * quantity, 0, 1000);
+            var label = "order " + name;
+        )";
+
+        // Per-run overhead of the Engine: fresh globals, bindings, running the compiled tree and tearing it down.
+        Measurement engine_run(const Options &options, Stopwatch &stopwatch)
+        {
+            const std::size_t runs = options.size_mb * 16 * 1024;
+
+            const auto compiled = engine::Engine::compile(handler);
+            if (!compiled.script) { std::abort(); }
+
+            engine::Engine   engine;
+            engine::Bindings bindings{ { "base", types::Literal(12.5) },
+                                       { "quantity", types::Literal(3.0) },
+                                       { "name", types::Literal(std::string("widget")) } };
+
+            stopwatch.start();
+            for (std::size_t i = 0; i < runs; ++i) {
+                if (!engine.run(*compiled.script, bindings).ok()) { std::abort(); }
+            }
+            stopwatch.stop();
+
+            return Measurement{ handler.size() * runs, runs };
+        }
+
+        // Compiling the same script every time instead, what running it through the command line amounts to.
+        Measurement engine_compile_and_run(const Options &options, Stopwatch &stopwatch)
+        {
+            const std::size_t runs = options.size_mb * 16 * 1024;
+
+            engine::Engine   engine;
+            engine::Bindings bindings{ { "base", types::Literal(12.5) },
+                                       { "quantity", types::Literal(3.0) },
+                                       { "name", types::Literal(std::string("widget")) } };
+
+            stopwatch.start();
+            for (std::size_t i = 0; i < runs; ++i) {
+                const auto compiled = engine::Engine::compile(handler);
+                if (!compiled.script || !engine.run(*compiled.script, bindings).ok()) { std::abort(); }
+            }
+            stopwatch.stop();
+
+            return Measurement{ handler.size() * runs, runs };
+        }
+
+        // Recursion heavy, every call allocates environments and copies values inside the isolate.
+        constexpr std::string_view workload = R"(
+            fun fib(n) { if (n < 2) return n; return fib(n - 1) + fib(n - 2); }
+            print fib(depth);
+        )";
+
+        // One isolate per thread all running the same compiled script, runs per second should grow with the threads
+        // up to the number of cores.
+        Measurement isolates(const std::size_t threads, const Options &options, Stopwatch &stopwatch)
+        {
+            const std::size_t runs = std::max<std::size_t>(options.size_mb / 4, 1);
+
+            const auto compiled = engine::Engine::compile(workload);
+            if (!compiled.script) { std::abort(); }
+
+            std::vector<std::thread> workers;
+            stopwatch.start();
+            for (std::size_t i = 0; i < threads; ++i) {
+                workers.emplace_back([&]() {
+                    engine::Isolate isolate;
+                    for (std::size_t run = 0; run < runs; ++run) {
+                        const auto result = isolate.run(*compiled.script, { { "depth", types::Literal(20.0) } });
+                        if (!result.ok() || result.output != "6765.000000\n") { std::abort(); }
+                    }
+                });
+            }
+            for (auto &worker : workers) { worker.join(); }
+            stopwatch.stop();
+
+            return Measurement{ 0, runs * threads };
+        }
+
+        Measurement isolates_1(const Options &options, Stopwatch &stopwatch) { return isolates(1, options, stopwatch); }
+        Measurement isolates_2(const Options &options, Stopwatch &stopwatch) { return isolates(2, options, stopwatch); }
+        Measurement isolates_4(const Options &options, Stopwatch &stopwatch) { return isolates(4, options, stopwatch); }
+
+        Measurement isolates_all(const Options &options, Stopwatch &stopwatch)
+        {
+            return isolates(std::max(std::thread::hardware_concurrency(), 1U), options, stopwatch);
+        }
+
+        const bool registered = register_benchmark("engine/run", &engine_run)
+                                && register_benchmark("engine/compile_and_run", &engine_compile_and_run)
+                                && register_benchmark("isolates/1", &isolates_1)
+                                && register_benchmark("isolates/2", &isolates_2)
+                                && register_benchmark("isolates/4", &isolates_4)
+                                && register_benchmark("isolates/all", &isolates_all);
+    }// namespace
+}// namespace tek::benchmarks
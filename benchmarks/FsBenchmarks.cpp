@@ -0,0 +1,67 @@
+#include "../src/tokenizer/Tokenizer.hpp"
+#include "../src/utils/fs.hpp"
+#include "Benchmark.hpp"
+#include "Generators.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+namespace tek::benchmarks {
+    namespace {
+        // A generated script on disk, removed once the benchmark is done.
+        class ScriptFile
+        {
+          public:
+            explicit ScriptFile(const std::size_t bytes)
+              : path{ std::filesystem::temp_directory_path() / fmt::format("tek_benchmark_{}.tek", getpid()) }
+            {
+                std::ofstream file{ this->path, std::ios::binary };
+                file << generate_flat_script(bytes);
+            }
+
+            ~ScriptFile() { std::filesystem::remove(this->path); }
+
+            [[nodiscard]] const std::filesystem::path &get() const { return this->path; }
+
+          private:
+            std::filesystem::path path;
+        };
+
+        // What loading used to cost: stream the file into a stringstream, copy it out, copy it into the tokenizer.
+        Measurement load_streamed(const Options &options, Stopwatch &stopwatch)
+        {
+            const ScriptFile script(options.size_mb * 1024 * 1024);
+
+            stopwatch.start();
+            std::ifstream     file{ script.get() };
+            std::stringstream ss{};
+            ss << file.rdbuf();
+            const std::string source = ss.str();
+            const std::string copy   = source;
+
+            tokenizer::Tokenizer tokenizer(copy);
+            const auto           first = tokenizer.next_token();
+            stopwatch.stop();
+
+            return Measurement{ copy.size(), first.type == tokenizer::TokenType::ENDOF ? 0U : 1U };
+        }
+
+        Measurement load_mapped(const Options &options, Stopwatch &stopwatch)
+        {
+            const ScriptFile script(options.size_mb * 1024 * 1024);
+
+            stopwatch.start();
+            const auto source = fs::read_file(script.get());
+
+            tokenizer::Tokenizer tokenizer(source.view());
+            const auto           first = tokenizer.next_token();
+            stopwatch.stop();
+
+            return Measurement{ source.view().size(), first.type == tokenizer::TokenType::ENDOF ? 0U : 1U };
+        }
+
+        const bool registered = register_benchmark("fs/load/streamed", &load_streamed)
+                                && register_benchmark("fs/load/mapped", &load_mapped);
+    }// namespace
+}// namespace tek::benchmarks
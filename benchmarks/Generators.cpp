@@ -0,0 +1,119 @@
+#include "Generators.hpp"
+
+#include <fmt/format.h>
+
+namespace tek::benchmarks {
+    std::string generate_flat_script(const std::size_t bytes)
+    {
+        std::string out;
+        out.reserve(bytes + 256);
+
+        for (std::size_t i = 0; out.size() < bytes; ++i) {
+            fmt::format_to(std::back_inserter(out), "var value{0} = {0} * 2 + (7 - 1) / 4;\n", i);
+            fmt::format_to(std::back_inserter(out), "value{0} = value{0} + 1; // bump it once\n", i);
+            fmt::format_to(std::back_inserter(out), "var text{0} = \"generated string \" + \"number {0}\";\n", i);
+        }
+
+        return out;
+    }
+
+    std::string generate_indented_script(const std::size_t bytes)
+    {
+        std::string out;
+        out.reserve(bytes + 512);
+
+        const std::string indent(24, ' ');
+        for (std::size_t i = 0; out.size() < bytes; ++i) {
+            fmt::format_to(
+              std::back_inserter(out),
+              "{0}// Generated accumulator number {1}, do not edit by hand.\n"
+              "{0}var generatedAccumulatorValueNumber{1} = {1} + 0.5;\n"
+              "{0}var generatedDescriptionNumber{1} = \"a fairly long generated description for entry {1}\";\n\n",
+              indent,
+              i);
+        }
+
+        return out;
+    }
+
+    std::string generate_expression_script(const std::size_t bytes)
+    {
+        std::string out;
+        out.reserve(bytes + 256);
+
+        for (std::size_t i = 0; out.size() < bytes; ++i) {
+            fmt::format_to(
+              std::back_inserter(out),
+              "total = !(a{0} < b * 2 or c(d, e + 1) >= {0}) and -f(g)(h) * (i - j / k) == l + m != nil;\n",
+              i);
+        }
+
+        return out;
+    }
+
+    std::string generate_nested_expression(const std::size_t depth)
+    {
+        std::string out;
+        out.reserve(depth * 4 + 16);
+
+        for (std::size_t i = 0; i < depth; ++i) { out += i % 2 == 0 ? "(" : "-("; }
+        out += "1";
+        for (std::size_t i = 0; i < depth; ++i) { out += ")"; }
+        out += ";\n";
+
+        return out;
+    }
+
+    namespace {
+        void append_balanced_expression(std::string &out, const std::size_t depth)
+        {
+            if (depth == 0) {
+                out += "x * 2 - x";
+                return;
+            }
+
+            out += "(";
+            append_balanced_expression(out, depth - 1);
+            out += depth % 2 == 0 ? " + " : " - ";
+            append_balanced_expression(out, depth - 1);
+            out += ")";
+        }
+    }// namespace
+
+    std::string generate_loop_script(const std::size_t bytes, const std::size_t passes)
+    {
+        // Each level doubles the size of the expression, stop at the first one reaching `bytes`.
+        std::size_t depth = 0;
+        while ((std::size_t{ 16 } << depth) < bytes) { ++depth; }
+
+        std::string out = fmt::format("var x = 3;\nvar pass = 0;\nwhile (pass < {}) pass = pass + 1 + 0 * ", passes);
+        out.reserve(out.size() + (std::size_t{ 16 } << depth) + 16);
+        append_balanced_expression(out, depth);
+        out += ";\n";
+
+        return out;
+    }
+
+    std::string generate_function_library(const std::size_t functions)
+    {
+        std::string out;
+        out.reserve(functions * 192 + 64);
+
+        for (std::size_t i = 0; i < functions; ++i) {
+            fmt::format_to(
+              std::back_inserter(out),
+              "fun helper{0}(a, b) {{\n"
+              "  var sum = a + b * {0};\n"
+              "  if (sum > 100) {{\n"
+              "    sum = sum - 100;\n"
+              "  }}\n"
+              "  while (sum < 10) sum = sum + 1;\n"
+              "  return sum / 2;\n"
+              "}}\n",
+              i);
+        }
+        fmt::format_to(std::back_inserter(out), "var result = helper0(1, 2) + helper{}(3, 4);\n", functions - 1);
+
+        return out;
+    }
+}// namespace tek::benchmarks
@@ -0,0 +1,28 @@
+#ifndef TEK_BENCHMARK_GENERATORS_HPP
+#define TEK_BENCHMARK_GENERATORS_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace tek::benchmarks {
+    // Flat machine-generated top-level statements of at least `bytes` characters. The script runs without output.
+    [[nodiscard]] std::string generate_flat_script(const std::size_t bytes);
+
+    // Deeply indented, comment heavy code with long identifiers and strings, the shape of most generated sources.
+    [[nodiscard]] std::string generate_indented_script(const std::size_t bytes);
+
+    // Operator heavy expression statements mixing every precedence level, calls and groupings.
+    [[nodiscard]] std::string generate_expression_script(const std::size_t bytes);
+
+    // A single expression statement nested `depth` levels deep through groupings and unary operators.
+    [[nodiscard]] std::string generate_nested_expression(const std::size_t depth);
+
+    // A loop evaluating one balanced expression of at least `bytes` characters `passes` times. The expression is the
+    // whole working set, its tree is meant to be larger than the caches.
+    [[nodiscard]] std::string generate_loop_script(const std::size_t bytes, const std::size_t passes);
+
+    // A library of `functions` small function declarations of which the script calls only the first and the last.
+    [[nodiscard]] std::string generate_function_library(const std::size_t functions);
+}// namespace tek::benchmarks
+
+#endif// TEK_BENCHMARK_GENERATORS_HPP
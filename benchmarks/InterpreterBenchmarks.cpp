@@ -0,0 +1,364 @@
+#include "../src/interpreter/Interpreter.hpp"
+#include "../src/interpreter/Resolver.hpp"
+#include "../src/parser/AstCache.hpp"
+#include "../src/parser/Parser.hpp"
+#include "../src/parser/StatementStream.hpp"
+#include "../src/tokenizer/Tokenizer.hpp"
+#include "Benchmark.hpp"
+#include "Generators.hpp"
+
+#include <cstdlib>
+#include <fmt/format.h>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <utility>
+
+namespace tek::benchmarks {
+    namespace {
+        struct Program
+        {
+            std::shared_ptr<parser::Ast>     ast = std::make_shared<parser::Ast>();
+            std::vector<parser::StatementId> statements;
+        };
+
+        Program parse(const std::string &source, const parser::ParseOptions options = {})
+        {
+            Program              program;
+            tokenizer::Tokenizer tokenizer(source);
+            parser::Parser       parser(tokenizer, *program.ast, options);
+            program.statements = parser.parse().value_or(std::vector<parser::StatementId>{});
+            return program;
+        }
+
+        // Runs a script far larger than the caches once, every node is visited exactly once in source order.
+        Measurement interpreter_flat(const Options &options, Stopwatch &stopwatch)
+        {
+            const auto source  = generate_flat_script(options.size_mb * 1024 * 1024);
+            const auto program = parse(source);
+
+            interpreter::Interpreter interpreter;
+            interpreter::Resolver    resolver(interpreter, *program.ast);
+            resolver.resolve(program.statements);
+
+            stopwatch.start();
+            interpreter.interpret(program.ast, program.statements);
+            stopwatch.stop();
+
+            return Measurement{ source.size(), program.statements.size() };
+        }
+
+        // The flat script parsed and run a declaration at a time, only the text is held in memory beforehand.
+        Measurement interpreter_stream(const Options &options, Stopwatch &stopwatch)
+        {
+            std::istringstream input(generate_flat_script(options.size_mb * 1024 * 1024));
+            const auto         bytes = input.str().size();
+
+            interpreter::Interpreter interpreter;
+            parser::StatementStream  stream(input);
+            std::size_t              statements = 0;
+
+            stopwatch.start();
+            while (const auto declaration = stream.next()) {
+                interpreter.interpret(declaration->ast, { declaration->statement });
+                ++statements;
+            }
+            stopwatch.stop();
+
+            return Measurement{ bytes, statements };
+        }
+
+        // Walks the same tree over and over, time goes into visiting nodes rather than into the environment.
+        Measurement interpreter_loop(const Options &options, Stopwatch &stopwatch)
+        {
+            constexpr std::size_t passes = 8;
+
+            const auto source  = generate_loop_script(options.size_mb * 1024 * 1024, passes);
+            const auto program = parse(source);
+
+            interpreter::Interpreter interpreter;
+            interpreter::Resolver    resolver(interpreter, *program.ast);
+            resolver.resolve(program.statements);
+
+            stopwatch.start();
+            interpreter.interpret(program.ast, program.statements);
+            stopwatch.stop();
+
+            return Measurement{ source.size() * passes, program.ast->node_count() * passes };
+        }
+
+        // A loop making a call on every iteration, both checked by the governor. Limits high enough never to be hit
+        // against none at all, the check runs either way.
+        Measurement governor(const bool limited, const Options &options, Stopwatch &stopwatch)
+        {
+            const std::size_t iterations = options.size_mb * 64 * 1024;
+            const auto        source     = fmt::format(
+              "fun add(a, b) {{ return a + b; }}\n"
+              "var sum = 0;\n"
+              "for (var i = 0; i < {}; i = i + 1) {{ sum = add(sum, i); }}\n",
+              iterations);
+            const auto program = parse(source, parser::ParseOptions{ true, false });
+
+            interpreter::Interpreter interpreter;
+            if (limited) { interpreter.governor.reset(interpreter::Limits{ iterations * 4, std::size_t{ 1 } << 40 }); }
+
+            stopwatch.start();
+            interpreter.interpret(program.ast, program.statements);
+            stopwatch.stop();
+
+            if (logger::Logger::had_runtime_error) { std::abort(); }
+            return Measurement{ source.size(), iterations };
+        }
+
+        Measurement governor_unlimited(const Options &options, Stopwatch &stopwatch)
+        {
+            return governor(false, options, stopwatch);
+        }
+
+        Measurement governor_limited(const Options &options, Stopwatch &stopwatch)
+        {
+            return governor(true, options, stopwatch);
+        }
+
+        // Recursion far deeper than the native stack holds, the calls past it run on heap segments. Bytes are the stack
+        // the recursion took, items the calls.
+        Measurement calls_deep(const Options &options, Stopwatch &stopwatch)
+        {
+            const std::size_t depth  = options.size_mb * 8 * 1024;
+            const auto        source = fmt::format(
+              "fun down(n) {{ if (n == 0) return 0; return down(n - 1) + 1; }}\n"
+              "down({});\n",
+              depth);
+            const auto program = parse(source, parser::ParseOptions{ true, false });
+
+            interpreter::Interpreter interpreter;
+            interpreter.governor.reset(interpreter::Limits{ 0, 0, std::uint64_t{ 8 } * 1024 * 1024 * 1024 });
+
+            stopwatch.start();
+            interpreter.interpret(program.ast, program.statements);
+            stopwatch.stop();
+
+            if (logger::Logger::had_runtime_error) { std::abort(); }
+            return Measurement{ interpreter.governor.stack_bytes_per_call() * depth, depth };
+        }
+
+        // Recursive fib, split into tasks down to `cutoff` so that every worker gets a share. Sequential with a cutoff
+        // above `n`, the two compare how the work scales with the cores.
+        Measurement fib_tasks(const Options &options, Stopwatch &stopwatch, const std::size_t cutoff)
+        {
+            const std::size_t n      = 20 + options.size_mb / 4;
+            const auto        source = fmt::format(
+              "fun fib(n) {{ if (n < 2) return n; return fib(n - 1) + fib(n - 2); }}\n"
+              "fun split(n) {{\n"
+              "  if (n < {}) return fib(n);\n"
+              "  var left = spawn split(n - 1);\n"
+              "  var right = spawn split(n - 2);\n"
+              "  return await left + await right;\n"
+              "}}\n"
+              "split({});\n",
+              cutoff,
+              n);
+            const auto program = parse(source, parser::ParseOptions{ true, false });
+
+            interpreter::Interpreter interpreter;
+            stopwatch.start();
+            interpreter.interpret(program.ast, program.statements);
+            stopwatch.stop();
+
+            if (logger::Logger::had_runtime_error) { std::abort(); }
+
+            // Calls to fib() and split() together.
+            std::size_t previous = 0;
+            std::size_t current  = 1;
+            for (std::size_t i = 0; i < n; ++i) { current = std::exchange(previous, current) + current; }
+            return Measurement{ 0, 2 * current - 1 };
+        }
+
+        Measurement tasks_sequential(const Options &options, Stopwatch &stopwatch)
+        {
+            return fib_tasks(options, stopwatch, 1000);
+        }
+
+        Measurement tasks_parallel(const Options &options, Stopwatch &stopwatch)
+        {
+            return fib_tasks(options, stopwatch, 16);
+        }
+
+        // Summing a sequence produced on demand, by a closure keeping its state in the environment it captured against
+        // a generator. Items are the values summed.
+        Measurement sequence(const std::string &producer, const Options &options, Stopwatch &stopwatch)
+        {
+            const std::size_t count   = options.size_mb * 64 * 1024;
+            const auto        program = parse(fmt::format(producer, count), parser::ParseOptions{ true, false });
+
+            interpreter::Interpreter interpreter;
+            stopwatch.start();
+            interpreter.interpret(program.ast, program.statements);
+            stopwatch.stop();
+
+            if (logger::Logger::had_runtime_error) { std::abort(); }
+            return Measurement{ 0, count };
+        }
+
+        Measurement sequence_closure(const Options &options, Stopwatch &stopwatch)
+        {
+            return sequence(
+              "fun counter() {{ var i = 0; fun next() {{ i = i + 1; return i; }} return next; }}\n"
+              "var next = counter();\n"
+              "var sum = 0;\n"
+              "for (var x = next(); x <= {0}; x = next()) sum = sum + x;\n",
+              options,
+              stopwatch);
+        }
+
+        Measurement sequence_generator(const Options &options, Stopwatch &stopwatch)
+        {
+            return sequence(
+              "fun* range(n) {{ for (var i = 1; i <= n; i = i + 1) yield i; }}\n"
+              "var sum = 0;\n"
+              "for (var x in range({0})) sum = sum + x;\n",
+              options,
+              stopwatch);
+        }
+
+        // The same pure function called for every index of a range, from a plain for loop and through parallel_for(),
+        // which spreads the calls over the workers. Items are the calls.
+        Measurement range_calls(const std::string &loop, const Options &options, Stopwatch &stopwatch)
+        {
+            const std::size_t count  = options.size_mb * 4 * 1024;
+            const auto        source = fmt::format(
+              "fun work(i) {{ var x = i; for (var j = 0; j < 20; j = j + 1) x = x * 1.0001 + j; return x; }}\n{}",
+              fmt::format(loop, count));
+            const auto program = parse(source, parser::ParseOptions{ true, false });
+
+            interpreter::Interpreter interpreter;
+            stopwatch.start();
+            interpreter.interpret(program.ast, program.statements);
+            stopwatch.stop();
+
+            if (logger::Logger::had_runtime_error) { std::abort(); }
+            return Measurement{ 0, count };
+        }
+
+        Measurement range_sequential(const Options &options, Stopwatch &stopwatch)
+        {
+            return range_calls("for (var i = 0; i < {0}; i = i + 1) work(i);\n", options, stopwatch);
+        }
+
+        Measurement range_parallel(const Options &options, Stopwatch &stopwatch)
+        {
+            return range_calls("parallel_for(0, {0}, work);\n", options, stopwatch);
+        }
+
+        // Parsing followed by the separate Resolver pass, against resolving names while parsing.
+        Measurement resolve_separate(const Options &options, Stopwatch &stopwatch)
+        {
+            const auto source = generate_expression_script(options.size_mb * 1024 * 1024);
+
+            stopwatch.start();
+            const auto               program = parse(source);
+            interpreter::Interpreter interpreter;
+            interpreter::Resolver    resolver(interpreter, *program.ast);
+            resolver.resolve(program.statements);
+            stopwatch.stop();
+
+            return Measurement{ source.size(), program.ast->node_count() };
+        }
+
+        Measurement resolve_fused(const Options &options, Stopwatch &stopwatch)
+        {
+            const auto source = generate_expression_script(options.size_mb * 1024 * 1024);
+
+            stopwatch.start();
+            const auto program = parse(source, parser::ParseOptions{ true, false });
+            stopwatch.stop();
+
+            return Measurement{ source.size(), program.ast->node_count() };
+        }
+
+        // Parsing and running a script that declares a large library and calls two functions out of it.
+        Measurement startup(const parser::ParseOptions options, Stopwatch &stopwatch)
+        {
+            constexpr std::size_t functions = 10'000;
+
+            const auto source = generate_function_library(functions);
+
+            stopwatch.start();
+            const auto               program = parse(source, options);
+            interpreter::Interpreter interpreter;
+            interpreter.interpret(program.ast, program.statements);
+            stopwatch.stop();
+
+            return Measurement{ source.size(), functions };
+        }
+
+        Measurement startup_eager(const Options &, Stopwatch &stopwatch)
+        {
+            return startup(parser::ParseOptions{ true, false }, stopwatch);
+        }
+
+        Measurement startup_lazy(const Options &, Stopwatch &stopwatch)
+        {
+            return startup(parser::ParseOptions{ true, true }, stopwatch);
+        }
+
+        // Bodies are parsed ahead on a pool with one worker per hardware thread, started beforehand.
+        Measurement startup_parallel(const Options &, Stopwatch &stopwatch)
+        {
+            utils::thread_pool body_pool;
+            return startup(parser::ParseOptions{ true, true, &body_pool }, stopwatch);
+        }
+
+        // Loading the resolved library out of a cache image instead, written beforehand.
+        Measurement startup_cached(const Options &, Stopwatch &stopwatch)
+        {
+            constexpr std::size_t functions = 10'000;
+
+            const auto source  = generate_function_library(functions);
+            const auto program = parse(source, parser::ParseOptions{ true, false });
+            const auto image   = parser::AstCache::serialize(parser::Program{ program.ast, program.statements }, source);
+
+            stopwatch.start();
+            const auto               cached = parser::AstCache::deserialize(image, source);
+            interpreter::Interpreter interpreter;
+            interpreter.interpret(cached->ast, cached->statements);
+            stopwatch.stop();
+
+            return Measurement{ source.size(), functions };
+        }
+
+        // Releasing the tree of a large script, node count is reported as items.
+        Measurement ast_teardown(const Options &options, Stopwatch &stopwatch)
+        {
+            const auto source     = generate_expression_script(options.size_mb * 1024 * 1024);
+            auto       program    = std::make_optional(parse(source));
+            const auto node_count = program->ast->node_count();
+
+            stopwatch.start();
+            program.reset();
+            stopwatch.stop();
+
+            return Measurement{ source.size(), node_count };
+        }
+
+        const bool registered = register_benchmark("interpreter/flat", &interpreter_flat)
+                                && register_benchmark("interpreter/stream", &interpreter_stream)
+                                && register_benchmark("interpreter/loop", &interpreter_loop)
+                                && register_benchmark("governor/unlimited", &governor_unlimited)
+                                && register_benchmark("governor/limited", &governor_limited)
+                                && register_benchmark("calls/deep", &calls_deep)
+                                && register_benchmark("tasks/sequential", &tasks_sequential)
+                                && register_benchmark("tasks/parallel", &tasks_parallel)
+                                && register_benchmark("generators/closure", &sequence_closure)
+                                && register_benchmark("generators/yield", &sequence_generator)
+                                && register_benchmark("parallel/sequential", &range_sequential)
+                                && register_benchmark("parallel/for", &range_parallel)
+                                && register_benchmark("resolve/separate", &resolve_separate)
+                                && register_benchmark("resolve/fused", &resolve_fused)
+                                && register_benchmark("startup/eager", &startup_eager)
+                                && register_benchmark("startup/lazy", &startup_lazy)
+                                && register_benchmark("startup/parallel", &startup_parallel)
+                                && register_benchmark("startup/cached", &startup_cached)
+                                && register_benchmark("ast/teardown", &ast_teardown);
+    }// namespace
+}// namespace tek::benchmarks
@@ -0,0 +1,87 @@
+#include "../src/parser/Document.hpp"
+#include "../src/parser/Parser.hpp"
+#include "../src/tokenizer/Tokenizer.hpp"
+#include "Benchmark.hpp"
+#include "Generators.hpp"
+
+namespace tek::benchmarks {
+    namespace {
+        Measurement parse(const std::string &source, Stopwatch &stopwatch)
+        {
+            stopwatch.start();
+            parser::Ast          ast;
+            tokenizer::Tokenizer tokenizer(source);
+            parser::Parser       parser(tokenizer, ast);
+            const auto           statements = parser.parse();
+            stopwatch.stop();
+
+            return Measurement{ source.size(), statements ? statements->size() : 0 };
+        }
+
+        Measurement parser_flat(const Options &options, Stopwatch &stopwatch)
+        {
+            return parse(generate_flat_script(options.size_mb * 1024 * 1024), stopwatch);
+        }
+
+        Measurement parser_expressions(const Options &options, Stopwatch &stopwatch)
+        {
+            return parse(generate_expression_script(options.size_mb * 1024 * 1024), stopwatch);
+        }
+
+        // Nesting deep enough to overflow a recursive descent parser.
+        Measurement parser_nested(const Options &options, Stopwatch &stopwatch)
+        {
+            return parse(generate_nested_expression(options.size_mb * 1024), stopwatch);
+        }
+
+        // A library of about 50k lines, edited in the middle one character at a time.
+        constexpr std::size_t edited_functions = 6250;
+        constexpr std::size_t edits            = 1000;
+
+        parser::TextEdit middle_edit(const std::string &source, const std::size_t edit)
+        {
+            // Alternately turns the multiplier of a function in the middle into a two digit number and back.
+            const auto offset = source.find(" * ", source.size() / 2) + 3;
+            return edit % 2 == 0 ? parser::TextEdit{ offset, 0, "7" } : parser::TextEdit{ offset, 1, "" };
+        }
+
+        Measurement parser_edit_incremental(const Options &, Stopwatch &stopwatch)
+        {
+            const auto       source = generate_function_library(edited_functions);
+            parser::Document document(source);
+
+            for (std::size_t i = 0; i < edits; ++i) {
+                const auto edit = middle_edit(source, i);
+                stopwatch.start();
+                document.apply(edit);
+                stopwatch.stop();
+            }
+
+            return Measurement{ source.size() * edits, edits };
+        }
+
+        // The same edits, each followed by scanning and parsing the whole source again.
+        Measurement parser_edit_full(const Options &, Stopwatch &stopwatch)
+        {
+            constexpr std::size_t full_edits = 20;
+
+            auto source = generate_function_library(edited_functions);
+            for (std::size_t i = 0; i < full_edits; ++i) {
+                const auto edit = middle_edit(source, i);
+                source.replace(edit.offset, edit.removed, edit.inserted);
+
+                stopwatch.start();
+                const parser::Document document(source);
+                stopwatch.stop();
+            }
+
+            return Measurement{ source.size() * full_edits, full_edits };
+        }
+
+        const bool registered = register_benchmark("parser/flat", &parser_flat)
+                                && register_benchmark("parser/expressions", &parser_expressions)
+                                && register_benchmark("parser/nested", &parser_nested)
+                                && register_benchmark("parser/edit/incremental", &parser_edit_incremental)
+                                && register_benchmark("parser/edit/full", &parser_edit_full);
+    }// namespace
+}// namespace tek::benchmarks
@@ -0,0 +1,114 @@
+#include "../src/tokenizer/ParallelTokenizer.hpp"
+#include "../src/tokenizer/Tokenizer.hpp"
+#include "../src/tokenizer/scan.hpp"
+#include "Benchmark.hpp"
+#include "Generators.hpp"
+
+namespace tek::benchmarks {
+    namespace {
+        std::size_t drain(tokenizer::Tokenizer &tokenizer)
+        {
+            std::size_t count = 0;
+            while (tokenizer.next_token().type != tokenizer::TokenType::ENDOF) { ++count; }
+            return count;
+        }
+
+        // Pulls tokens one at a time the way the parser does, memory should stay flat whatever the input size.
+        Measurement tokenizer_pull(const Options &options, Stopwatch &stopwatch)
+        {
+            const auto source = generate_flat_script(options.size_mb * 1024 * 1024);
+
+            stopwatch.start();
+            tokenizer::Tokenizer tokenizer(source);
+            const auto           count = drain(tokenizer);
+            stopwatch.stop();
+
+            return Measurement{ source.size(), count };
+        }
+
+        // Materializes the whole token stream, for comparison with the pull based interface.
+        Measurement tokenizer_materialized(const Options &options, Stopwatch &stopwatch)
+        {
+            const auto source = generate_flat_script(options.size_mb * 1024 * 1024);
+
+            stopwatch.start();
+            tokenizer::Tokenizer tokenizer(source);
+            const auto           tokens = tokenizer.tokenize();
+            stopwatch.stop();
+
+            return Measurement{ source.size(), tokens.size() };
+        }
+
+        // The same stream scanned in chunks on several threads.
+        template<std::size_t threads>
+        Measurement tokenizer_parallel(const Options &options, Stopwatch &stopwatch)
+        {
+            const auto source = generate_flat_script(options.size_mb * 1024 * 1024);
+
+            stopwatch.start();
+            const auto tokens = tokenizer::tokenize_parallel(source, threads);
+            stopwatch.stop();
+
+            return Measurement{ source.size(), tokens.size() };
+        }
+
+        template<tokenizer::scan::Isa isa>
+        Measurement tokenizer_isa(const Options &options, Stopwatch &stopwatch)
+        {
+            if (!tokenizer::scan::use_isa(isa)) { return Measurement{}; }
+
+            const auto source = generate_indented_script(options.size_mb * 1024 * 1024);
+
+            stopwatch.start();
+            tokenizer::Tokenizer tokenizer(source);
+            const auto           count = drain(tokenizer);
+            stopwatch.stop();
+
+            return Measurement{ source.size(), count };
+        }
+
+        // Only the bulk scanning routines, without building tokens, to isolate the vectorized kernels.
+        template<tokenizer::scan::Isa isa>
+        Measurement scan_isa(const Options &options, Stopwatch &stopwatch)
+        {
+            if (!tokenizer::scan::use_isa(isa)) { return Measurement{}; }
+
+            const auto source = generate_indented_script(options.size_mb * 1024 * 1024);
+            const auto end    = source.data() + source.size();
+
+            stopwatch.start();
+            std::size_t lines = 1;
+            std::size_t spans = 0;
+            for (const char *it = source.data(); it != end; ++spans) {
+                it = tokenizer::scan::skip_whitespace(it, end, lines);
+                if (it == end) { break; }
+
+                if (*it == '/' && it + 1 != end && it[1] == '/') {
+                    it = tokenizer::scan::find_line_end(it, end);
+                } else if (*it == '"') {
+                    it = tokenizer::scan::find_string_end(it + 1, end, lines);
+                    it = it == end ? end : it + 1;
+                } else if (tokenizer::scan::is_alnum(*it)) {
+                    it = tokenizer::scan::find_identifier_end(it, end);
+                } else {
+                    ++it;
+                }
+            }
+            stopwatch.stop();
+
+            return Measurement{ source.size(), spans };
+        }
+
+        const bool registered =
+          register_benchmark("tokenizer/pull", &tokenizer_pull)
+          && register_benchmark("tokenizer/materialized", &tokenizer_materialized)
+          && register_benchmark("tokenizer/parallel", &tokenizer_parallel<0>)
+          && register_benchmark("tokenizer/parallel/4", &tokenizer_parallel<4>)
+          && register_benchmark("tokenizer/indented/scalar", &tokenizer_isa<tokenizer::scan::Isa::SCALAR>)
+          && register_benchmark("tokenizer/indented/sse2", &tokenizer_isa<tokenizer::scan::Isa::SSE2>)
+          && register_benchmark("tokenizer/indented/avx2", &tokenizer_isa<tokenizer::scan::Isa::AVX2>)
+          && register_benchmark("tokenizer/scan/scalar", &scan_isa<tokenizer::scan::Isa::SCALAR>)
+          && register_benchmark("tokenizer/scan/sse2", &scan_isa<tokenizer::scan::Isa::SSE2>)
+          && register_benchmark("tokenizer/scan/avx2", &scan_isa<tokenizer::scan::Isa::AVX2>);
+    }// namespace
+}// namespace tek::benchmarks
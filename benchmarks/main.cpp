@@ -0,0 +1,24 @@
+#include <fmt/format.h>
+#include <string>
+
+#include "Benchmark.hpp"
+
+int main(int argc, char **argv)
+{
+    tek::benchmarks::Options options;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        if (argument == "--size-mb" && i + 1 < argc) {
+            options.size_mb = std::stoul(argv[++i]);
+        } else if (argument == "--help") {
+            fmt::print("usage: tek_benchmarks [--size-mb N] [FILTER]\n");
+            return 0;
+        } else {
+            options.filter = argument;
+        }
+    }
+
+    fmt::print("Generated inputs are {} MB, pass --size-mb to change it.\n", options.size_mb);
+    return tek::benchmarks::run_benchmarks(options);
+}
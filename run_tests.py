@@ -66,6 +66,35 @@ def build_executable(build_dir: str, target: str, verbose: bool) -> str:
         return os.path.abspath('tek')
 
 
+# Tests in these directories run a second time with the interpreter flags given.
+RERUN_WITH_FLAGS: dict[str, list[str]] = {
+    'channels': ['--stream'],
+    'repl': ['--resolver'],
+}
+
+
+def flag_sets(test: str) -> list[list[str]]:
+    directory = Path(test).parent.name
+    if directory in RERUN_WITH_FLAGS:
+        return [[], RERUN_WITH_FLAGS[directory]]
+    return [[]]
+
+
+# Tests in these directories are typed at the prompt, one line at a time, rather than run as a file.
+AT_PROMPT: set[str] = {'repl'}
+
+
+def run_test(executable: str, flags: list[str], test: str) -> subprocess.CompletedProcess:  # noqa: E501
+    if Path(test).parent.name not in AT_PROMPT:
+        return subprocess.run([executable, *flags, test], capture_output=True)
+
+    with open(test, 'rb') as file:
+        result = subprocess.run([executable, *flags], stdin=file, capture_output=True)  # noqa: E501
+    lines = result.stdout.decode().split('\n')
+    result.stdout = '\n'.join(line.lstrip('> ') for line in lines).lstrip('\n').encode()  # noqa: E501
+    return result
+
+
 def find_tests(tests_dir: str) -> list[str]:
     out: list[str] = []
 
@@ -127,25 +156,28 @@ def run_tests(executable: str, tests: list[str], verbose: bool) -> None:
                 pass
 
             expected_result: str = first_line[3:].replace(':', '\n')
-            result = subprocess.run([executable, test], capture_output=True)
 
-            if expected_result == 'fail':
-                if assert_results(filename, result.returncode != 0, verbose):
+            for flags in flag_sets(test):
+                name = ' '.join([*flags, filename])
+                result = run_test(executable, flags, test)
+
+                if expected_result == 'fail':
+                    if assert_results(name, result.returncode != 0, verbose):
+                        succeeding += 1
+                    else:
+                        print_results(result, expected_result)
+                        sys.exit(1)
+                    continue
+
+                if assert_results(
+                    name,
+                    expected_result == result.stdout.decode(),
+                    verbose,
+                ):
                     succeeding += 1
                 else:
                     print_results(result, expected_result)
                     sys.exit(1)
-                continue
-
-            if assert_results(
-                filename,
-                expected_result == result.stdout.decode(),
-                verbose,
-            ):
-                succeeding += 1
-            else:
-                print_results(result, expected_result)
-                sys.exit(1)
 
     succeeding_str = color_green(f'succeeding: {succeeding}')
     ignoring_str = color_header(f'ignoring: {ignoring}')
@@ -158,7 +190,7 @@ def capture_tests_output(
     verbose: bool,
 ) -> None:
     for test in tests:
-        result = subprocess.run([executable, test], capture_output=True)
+        result = run_test(executable, [], test)
         expected_result = result.stdout.decode().replace('\n', ':')
         test_out_file = test.replace('.tek', '.txt')
         with open(test_out_file, 'w') as file:
@@ -0,0 +1,140 @@
+#include "Batch.hpp"
+
+#include "../utils/fs.hpp"
+#include "../utils/thread_pool.hpp"
+#include "Engine.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <fmt/format.h>
+#include <fstream>
+#include <glob.h>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace tek::engine {
+    namespace {
+        void expand_into(std::vector<std::filesystem::path> &scripts, const std::string &argument)
+        {
+            std::error_code ec;
+            if (!argument.empty() && argument.front() == '@') {
+                const std::filesystem::path manifest = argument.substr(1);
+                std::ifstream               file(manifest);
+                if (!file) {
+                    // Reported as a script that doesn't exist.
+                    scripts.push_back(manifest);
+                    return;
+                }
+
+                std::string line;
+                while (std::getline(file, line)) {
+                    line.erase(0, line.find_first_not_of(" \t\r"));
+                    line.erase(line.find_last_not_of(" \t\r") + 1);
+                    if (line.empty() || line.front() == '#') { continue; }
+
+                    const std::filesystem::path entry = line;
+                    expand_into(scripts, entry.is_absolute() ? line : (manifest.parent_path() / entry).string());
+                }
+            } else if (std::filesystem::is_directory(argument, ec)) {
+                std::vector<std::filesystem::path> found;
+                for (const auto &entry : std::filesystem::recursive_directory_iterator(argument, ec)) {
+                    if (entry.is_regular_file(ec) && entry.path().extension() == ".tek") {
+                        found.push_back(entry.path());
+                    }
+                }
+                std::sort(found.begin(), found.end());
+                scripts.insert(scripts.end(), found.begin(), found.end());
+            } else if (argument.find_first_of("*?[") != std::string::npos) {
+                glob_t matches{};
+                if (glob(argument.c_str(), 0, nullptr, &matches) == 0) {
+                    for (std::size_t i = 0; i < matches.gl_pathc; ++i) { scripts.emplace_back(matches.gl_pathv[i]); }
+                } else {
+                    scripts.emplace_back(argument);
+                }
+                globfree(&matches);
+            } else {
+                scripts.emplace_back(argument);
+            }
+        }
+
+        BatchResult run_script(
+          const std::filesystem::path &script,
+          const std::filesystem::path &snapshot,
+          const interpreter::Limits   &limits)
+        {
+            BatchResult result{ script, {}, {}, 0 };
+
+            std::error_code ec;
+            if (!std::filesystem::is_regular_file(script, ec)) {
+                result.errors = fmt::format("No such file: {}\n", script.string());
+                result.status = 1;
+                return result;
+            }
+
+            const auto source   = fs::read_file(script);
+            const auto compiled = Engine::compile(source.view());
+            if (!compiled.script) {
+                for (const auto &error : compiled.errors) { result.errors += error; }
+                result.status = 1;
+                return result;
+            }
+
+            Isolate isolate;
+            isolate.set_limits(limits);
+            if (!snapshot.empty()) { [[maybe_unused]] const auto loaded = isolate.load_snapshot(snapshot); }
+
+            auto run      = isolate.run(*compiled.script);
+            result.output = std::move(run.output);
+            for (const auto &error : run.errors) { result.errors += error; }
+            if (!run.ok()) {
+                result.errors += "Runtime error\n";
+                result.status = 1;
+            }
+            return result;
+        }
+    }// namespace
+
+    std::vector<std::filesystem::path> Batch::expand(const std::vector<std::string_view> &arguments)
+    {
+        std::vector<std::filesystem::path> scripts;
+        for (const auto argument : arguments) { expand_into(scripts, std::string(argument)); }
+        return scripts;
+    }
+
+    bool Batch::run(const std::vector<std::filesystem::path>             &scripts,
+                    const std::filesystem::path                          &snapshot,
+                    const interpreter::Limits                            &limits,
+                    const std::function<void(const BatchResult &result)> &report)
+    {
+        // Checked once here, every isolate loads it again.
+        if (!snapshot.empty() && !Isolate().load_snapshot(snapshot)) { return false; }
+
+        std::mutex                              mutex;
+        std::condition_variable                 finished;
+        std::vector<std::optional<BatchResult>> results(scripts.size());
+
+        utils::thread_pool workers;
+        for (std::size_t i = 0; i < scripts.size(); ++i) {
+            workers.submit([&, i]() {
+                auto result = run_script(scripts[i], snapshot, limits);
+
+                std::lock_guard lock(mutex);
+                results[i] = std::move(result);
+                finished.notify_one();
+            });
+        }
+
+        // Results are reported and dropped in order while the later scripts are still running.
+        for (auto &result : results) {
+            std::optional<BatchResult> next;
+            {
+                std::unique_lock lock(mutex);
+                finished.wait(lock, [&]() { return result.has_value(); });
+                next = std::move(result);
+                result.reset();
+            }
+            report(*next);
+        }
+        return true;
+    }
+}// namespace tek::engine
@@ -0,0 +1,42 @@
+#ifndef TEK_BATCH_HPP
+#define TEK_BATCH_HPP
+
+#include "../interpreter/Governor.hpp"
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tek::engine {
+    // What running a script on its own would have printed, errors and the "Runtime error" line after them in `errors`,
+    // and the status the command line would have exited with.
+    struct BatchResult
+    {
+        std::filesystem::path script;
+        std::string           output;
+        std::string           errors;
+        int                   status = 0;
+    };
+
+    // Runs many scripts in one process, each in a fresh isolate of its own, on one worker per hardware thread.
+    class Batch
+    {
+      public:
+        // Scripts named by the arguments in order: directories stand for every `.tek` file under them, sorted,
+        // patterns with `*`, `?` or `[` for the files they match, sorted, and `@manifest` for the scripts listed one
+        // per line in that file, relative to it. Blank lines and lines starting with `#` are skipped in manifests.
+        [[nodiscard]] static std::vector<std::filesystem::path> expand(const std::vector<std::string_view> &arguments);
+
+        // Every script starts from the globals of `snapshot` if not empty, see Isolate::load_snapshot, and runs within
+        // `limits`. `report` is
+        // called on the calling thread once per script, in the order of `scripts`, as soon as the script and all the
+        // ones before it have run. False if the snapshot couldn't be loaded, nothing ran then.
+        [[nodiscard]] static bool run(const std::vector<std::filesystem::path>             &scripts,
+                                      const std::filesystem::path                          &snapshot,
+                                      const interpreter::Limits                            &limits,
+                                      const std::function<void(const BatchResult &result)> &report);
+    };
+}// namespace tek::engine
+
+#endif// TEK_BATCH_HPP
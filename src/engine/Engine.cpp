@@ -0,0 +1,34 @@
+#include "Engine.hpp"
+
+#include "../logger/Logger.hpp"
+#include "../parser/Parser.hpp"
+#include "../tokenizer/Tokenizer.hpp"
+#include "../utils/guard.hpp"
+#include <utility>
+
+namespace tek::engine {
+    CompileResult Engine::compile(const std::string_view source)
+    {
+        CompileResult result;
+        auto          program = std::make_shared<parser::Program>();
+        program->ast = std::make_shared<parser::Ast>();
+
+        std::optional<std::vector<parser::StatementId>> statements;
+        {
+            logger::Logger::capture(&result.errors);
+            utils::ScopeGuard release([]() { logger::Logger::capture(nullptr); });
+
+            tokenizer::Tokenizer tokenizer(source);
+            parser::Parser       parser(tokenizer, *program->ast, parser::ParseOptions{ true, false });
+            statements = parser.parse();
+        }
+
+        if (!statements || !result.errors.empty()) { return result; }
+
+        program->statements = std::move(*statements);
+        result.script       = Script(std::move(program));
+        return result;
+    }
+
+    RunResult Engine::run(const Script &script, const Bindings &bindings) { return this->isolate.run(script, bindings); }
+}// namespace tek::engine
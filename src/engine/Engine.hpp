@@ -0,0 +1,36 @@
+#ifndef TEK_ENGINE_HPP
+#define TEK_ENGINE_HPP
+
+#include "../parser/AstCache.hpp"
+#include "Isolate.hpp"
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tek::engine {
+    // Errors are formatted the way the command line prints them, in the order they were found.
+    struct CompileResult
+    {
+        std::optional<Script>    script;
+        std::vector<std::string> errors;
+    };
+
+    // Compiles and runs scripts embedded in a host program. Nothing is printed to report errors and nothing exits the
+    // process, errors are returned instead. An Engine runs one script at a time, with the output going to the standard
+    // output. Scripts are run in parallel on an Isolate per thread.
+    class Engine
+    {
+      public:
+        // Function bodies are parsed right away, a script has no errors left to find when it runs. Safe to call from
+        // several threads at once.
+        [[nodiscard]] static CompileResult compile(std::string_view source);
+
+        [[nodiscard]] RunResult run(const Script &script, const Bindings &bindings = {});
+
+      private:
+        Isolate isolate{ false };
+    };
+}// namespace tek::engine
+
+#endif// TEK_ENGINE_HPP
@@ -0,0 +1,53 @@
+#include "Isolate.hpp"
+
+#include "../interpreter/Snapshot.hpp"
+#include "../logger/Logger.hpp"
+#include "../utils/guard.hpp"
+#include <utility>
+
+namespace tek::engine {
+    Script::Script(std::shared_ptr<const parser::Program> program) : program{ std::move(program) } {}
+
+    Isolate::Isolate(const bool capture_output) : capture_output{ capture_output } {}
+
+    RunResult Isolate::run(const Script &script, const Bindings &bindings, OutputSink sink)
+    {
+        const auto &ast = this->tree(script);
+
+        auto globals = std::make_shared<interpreter::Environment>(this->interpreter.globals);
+        for (const auto &[name, value] : bindings) { globals->define(name, value); }
+
+        RunResult result;
+        this->interpreter.governor.reset(this->limits);
+        logger::Logger::capture(&result.errors);
+        if (sink) {
+            this->interpreter.output = std::move(sink);
+        } else if (this->capture_output) {
+            this->interpreter.output = [&result](const std::string_view line) { result.output.append(line); };
+        }
+        utils::ScopeGuard release([&]() {
+            logger::Logger::capture(nullptr);
+            this->interpreter.output = nullptr;
+            globals->clear();
+        });
+
+        this->interpreter.interpret(ast, script.program->statements, globals);
+        return result;
+    }
+
+    bool Isolate::load_snapshot(const std::filesystem::path &path)
+    {
+        return interpreter::Snapshot::load(path, this->interpreter);
+    }
+
+    const std::shared_ptr<parser::Ast> &Isolate::tree(const Script &script)
+    {
+        auto &tree = this->trees[script.program.get()];
+        if (!tree) {
+            // The local pointer owns a reference to the script, which keeps the tree and the key alive.
+            const auto owner = std::make_shared<std::shared_ptr<const parser::Program>>(script.program);
+            tree             = std::shared_ptr<parser::Ast>(owner, script.program->ast.get());
+        }
+        return tree;
+    }
+}// namespace tek::engine
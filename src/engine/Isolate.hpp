@@ -0,0 +1,84 @@
+#ifndef TEK_ISOLATE_HPP
+#define TEK_ISOLATE_HPP
+
+#include "../interpreter/Interpreter.hpp"
+#include "../parser/AstCache.hpp"
+#include "../types/Literal.hpp"
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace tek::engine {
+    // A compiled script: parsed, resolved and checked once, it can then be run any number of times, by any number of
+    // isolates at once. Copies share the same tree, which running never changes.
+    class Script
+    {
+      private:
+        friend class Engine;
+        friend class Isolate;
+
+        explicit Script(std::shared_ptr<const parser::Program> program);
+
+      private:
+        std::shared_ptr<const parser::Program> program;
+    };
+
+    // Errors are formatted the way the command line prints them, in the order they were found.
+    struct RunResult
+    {
+        std::vector<std::string> errors;
+
+        // What the script printed, if the isolate captures it.
+        std::string output;
+
+        [[nodiscard]] bool ok() const { return this->errors.empty(); }
+    };
+
+    // Global variables defined for a single run, on top of the natives.
+    using Bindings = std::unordered_map<std::string, types::Literal>;
+
+    // Takes what a run prints as it prints it, a line at a time, on whichever thread printed but one at a time.
+    using OutputSink = std::function<void(std::string_view)>;
+
+    // An interpreter with globals, values, errors and output of its own. Isolates only share compiled scripts, each
+    // one can run on its own thread alongside the others. A single isolate runs one script at a time.
+    class Isolate
+    {
+      public:
+        // Output goes into RunResult::output, or straight to the standard output unless `capture_output`.
+        explicit Isolate(const bool capture_output = true);
+
+        // Every run starts from fresh globals, so runs of the same script don't see each other's variables. Output
+        // goes to `sink` instead if given.
+        [[nodiscard]] RunResult run(const Script &script, const Bindings &bindings = {}, OutputSink sink = {});
+
+        // Layers the fresh globals of every run over the ones a prelude left behind, see interpreter::Snapshot. Has to
+        // happen before the first run. A run assigning to one of those globals changes it for the later runs.
+        [[nodiscard]] bool load_snapshot(const std::filesystem::path &path);
+
+        // Applies to every later run, a run going over them fails with a runtime error. None by default.
+        void set_limits(const interpreter::Limits &limits) { this->limits = limits; }
+
+        // Stops the current run at its next loop iteration or call, failing it with a runtime error. Safe to call from
+        // another thread, a cancellation before the run started is forgotten.
+        void cancel() { this->interpreter.governor.cancel(); }
+
+      private:
+        // Functions and blocks copy the pointer to the tree they run out of. These copies count references in a
+        // control block of the isolate's own rather than in the one all isolates running the script would share.
+        [[nodiscard]] const std::shared_ptr<parser::Ast> &tree(const Script &script);
+
+      private:
+        interpreter::Interpreter interpreter;
+        bool                     capture_output;
+        interpreter::Limits      limits;
+
+        std::unordered_map<const parser::Program *, std::shared_ptr<parser::Ast>> trees;
+    };
+}// namespace tek::engine
+
+#endif// TEK_ISOLATE_HPP
@@ -10,5 +10,7 @@ namespace tek::exceptions {
       : std::runtime_error(""), op{ std::move(op) }, message{ std::move(message) }
     {}
 
+    NativeError::NativeError(std::string message) : std::runtime_error(""), message{ std::move(message) } {}
+
     Return::Return(types::Literal retval) : std::runtime_error(""), retval{ std::move(retval) } {}
 }// namespace tek::exceptions
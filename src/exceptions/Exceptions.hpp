@@ -22,6 +22,16 @@ namespace tek::exceptions {
         std::string      message;
     };
 
+    // Raised by native functions, which don't know the call they run for. The call reports it as a RuntimeError.
+    class NativeError : public std::runtime_error
+    {
+      public:
+        explicit NativeError(std::string message);
+
+      public:
+        std::string message;
+    };
+
     class Return : public std::runtime_error
     {
       public:
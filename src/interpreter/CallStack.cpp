@@ -0,0 +1,131 @@
+#include "CallStack.hpp"
+
+#include "../exceptions/Exceptions.hpp"
+#include <exception>
+#include <fmt/format.h>
+#include <optional>
+#include <pthread.h>
+#include <ucontext.h>
+
+namespace tek::interpreter {
+    namespace {
+        // Lowest address of the calling thread's native stack, looked up once per thread.
+        std::uintptr_t native_floor(const std::uintptr_t frame)
+        {
+            thread_local std::uintptr_t floor = 0;
+            if (floor != 0) { return floor; }
+
+#if defined(__GLIBC__)
+            pthread_attr_t attributes;
+            if (pthread_getattr_np(pthread_self(), &attributes) == 0) {
+                void       *address = nullptr;
+                std::size_t size    = 0;
+                if (pthread_attr_getstack(&attributes, &address, &size) == 0) {
+                    floor = reinterpret_cast<std::uintptr_t>(address);
+                }
+                pthread_attr_destroy(&attributes);
+            }
+#endif
+            // Without a way to ask, the smallest default stack of the common platforms is assumed.
+            if (floor == 0) { floor = frame - 512 * 1024; }
+            return floor;
+        }
+
+        // Handed from call_on_segment() to the function starting the segment, which can only take ints.
+        struct Switch
+        {
+            const std::function<types::Literal()> *call;
+            std::optional<types::Literal>          result;
+            std::exception_ptr                     error;
+            ucontext_t                             caller;
+        };
+
+        thread_local Switch *pending = nullptr;
+
+        // Lowest address of the segment the thread runs on, 0 on its native stack. A task run while another waits on
+        // the same thread starts a call stack of its own, it has to know where it really is.
+        thread_local std::uintptr_t segment_floor = 0;
+
+        void run_segment()
+        {
+            // Exceptions can't unwind past the start of the segment, they are carried over to the caller's stack.
+            auto *state = pending;
+            try {
+                state->result = (*state->call)();
+            } catch (...) {
+                state->error = std::current_exception();
+            }
+        }
+    }// namespace
+
+    void CallStack::reset(const std::uint64_t budget_bytes)
+    {
+        this->budget        = budget_bytes;
+        this->deepest       = 0;
+        this->deepest_bytes = 0;
+    }
+
+    std::size_t CallStack::bytes_per_call() const
+    {
+        return this->deepest != 0 ? this->deepest_bytes / this->deepest : 0;
+    }
+
+    void CallStack::enter(const std::uintptr_t frame)
+    {
+        this->floor = segment_floor != 0 ? segment_floor : native_floor(frame);
+        this->top   = frame;
+        this->below = 0;
+    }
+
+    exceptions::RuntimeError CallStack::overflow(const tokenizer::Token &where) const
+    {
+        if (this->depth == 0) { return exceptions::RuntimeError(where, "Stack overflow, the code is nested too deeply."); }
+        return exceptions::RuntimeError(
+          where,
+          fmt::format("Stack overflow, {} calls deep at {} bytes of stack a call.", this->depth, this->bytes_per_call()));
+    }
+
+    types::Literal CallStack::call_on_segment(
+      const std::uintptr_t                             frame,
+      const std::function<types::Literal()>           &call,
+      const std::function<exceptions::RuntimeError()> &overflow)
+    {
+        if (this->segments_in_use == this->segments.size()) {
+            if ((this->segments.size() + 1) * segment_bytes > this->budget) { throw overflow(); }
+            this->segments.push_back(std::make_unique<std::byte[]>(segment_bytes));
+        }
+        auto *segment = this->segments[this->segments_in_use].get();
+
+        Switch     state{ &call, std::nullopt, nullptr, {} };
+        ucontext_t callee;
+        getcontext(&callee);
+        callee.uc_stack.ss_sp   = segment;
+        callee.uc_stack.ss_size = segment_bytes;
+        callee.uc_link          = &state.caller;
+        makecontext(&callee, &run_segment, 0);
+
+        const auto previous_floor   = this->floor;
+        const auto previous_top     = this->top;
+        const auto previous_below   = this->below;
+        const auto previous_segment = segment_floor;
+        utils::ScopeGuard restore([&]() {
+            this->floor   = previous_floor;
+            this->top     = previous_top;
+            this->below   = previous_below;
+            segment_floor = previous_segment;
+            --this->segments_in_use;
+        });
+
+        this->below += this->top - frame;
+        this->floor = reinterpret_cast<std::uintptr_t>(segment);
+        this->top   = this->floor + segment_bytes;
+        ++this->segments_in_use;
+        segment_floor = this->floor;
+
+        pending = &state;
+        swapcontext(&state.caller, &callee);
+
+        if (state.error) { std::rethrow_exception(state.error); }
+        return std::move(*state.result);
+    }
+}// namespace tek::interpreter
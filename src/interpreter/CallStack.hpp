@@ -0,0 +1,134 @@
+#ifndef TEK_CALL_STACK_HPP
+#define TEK_CALL_STACK_HPP
+
+#include "../exceptions/Exceptions.hpp"
+#include "../tokenizer/Token.hpp"
+#include "../types/Literal.hpp"
+#include "../utils/guard.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace tek::interpreter {
+    // A Tek call nests a handful of C++ calls, so recursion in a script grows the native stack, and so do deeply nested
+    // expressions and statements. Before every call and every node the headroom left is checked, and once it runs low
+    // the call carries on on a segment allocated on the heap, up to a budget. Going past it is a RuntimeError rather
+    // than a crash, naming the depth reached and the stack a call took.
+    class CallStack
+    {
+      public:
+        static constexpr std::size_t   segment_bytes  = 2 * 1024 * 1024;
+        static constexpr std::uint64_t default_budget = std::uint64_t{ 256 } * 1024 * 1024;
+
+        // Left free below every call, for the C++ frames between one call and the next check.
+        static constexpr std::size_t reserve_bytes = 256 * 1024;
+
+        // Heap for segments, 0 to stay on the native stack. Segments are kept for the next calls, and runs. Forgets the
+        // deepest recursion.
+        void reset(std::uint64_t budget_bytes);
+
+        template<typename Call>
+        types::Literal call(const tokenizer::Token &where, Call &&call)
+        {
+            const auto frame = reinterpret_cast<std::uintptr_t>(__builtin_frame_address(0));
+            if (this->active == 0) { this->enter(frame); }
+
+            ++this->active;
+            ++this->depth;
+            utils::ScopeGuard leave([this]() {
+                --this->depth;
+                --this->active;
+            });
+
+            if (this->depth > this->deepest) {
+                this->deepest       = this->depth;
+                this->deepest_bytes = this->below + (this->top - frame);
+            }
+
+            if (frame > this->floor + reserve_bytes) { return call(); }
+            return this->call_on_segment(
+              frame, std::function<types::Literal()>(std::forward<Call>(call)), [this, &where]() {
+                  return this->overflow(where);
+              });
+        }
+
+        // Runs `run`, which evaluates or executes a node, the same way. Deep trees recurse without making calls, they
+        // move onto segments too. `where` gives a token of the node, only asked for when the budget is exhausted.
+        template<typename Run, typename Where>
+        decltype(auto) nest(Run &&run, Where &&where)
+        {
+            char marker = 0;
+            if (this->active != 0 && reinterpret_cast<std::uintptr_t>(&marker) > this->floor + reserve_bytes) {
+                return run();
+            }
+
+            if constexpr (std::is_void_v<decltype(run())>) {
+                this->nest_outermost(
+                  [&]() {
+                      run();
+                      return types::Literal(nullptr);
+                  },
+                  where);
+            } else {
+                return this->nest_outermost(run, where);
+            }
+        }
+
+        [[nodiscard]] std::size_t current_depth() const { return this->depth; }
+
+        // Bytes of stack per level of the deepest recursion so far, frames of both C++ and Tek calls included.
+        [[nodiscard]] std::size_t bytes_per_call() const;
+
+      private:
+        // The first node run on this call stack, or one running low on the stack.
+        template<typename Run, typename Where>
+        types::Literal nest_outermost(Run &&run, Where &where)
+        {
+            const auto frame = reinterpret_cast<std::uintptr_t>(__builtin_frame_address(0));
+            if (this->active == 0) { this->enter(frame); }
+            ++this->active;
+            utils::ScopeGuard leave([this]() { --this->active; });
+
+            if (frame > this->floor + reserve_bytes) { return run(); }
+            return this->call_on_segment(
+              frame, std::function<types::Literal()>(run), [this, &where]() { return this->overflow(where()); });
+        }
+
+        // Outermost call or node on this thread, the native stack is measured from here.
+        void enter(std::uintptr_t frame);
+
+        // Runs `call` on a segment, or raises what `overflow` makes once the budget is used up.
+        types::Literal call_on_segment(
+          std::uintptr_t                                   frame,
+          const std::function<types::Literal()>           &call,
+          const std::function<exceptions::RuntimeError()> &overflow);
+
+        // Names the depth of the recursion, or the nesting of the code when there is none.
+        [[nodiscard]] exceptions::RuntimeError overflow(const tokenizer::Token &where) const;
+
+      private:
+        std::uint64_t budget = default_budget;
+        std::size_t   depth  = 0;
+
+        // Calls and nodes running on this call stack, calls alone count towards the depth.
+        std::size_t active = 0;
+
+        // Lowest usable address of the stack running now, and the highest one of it.
+        std::uintptr_t floor = 0;
+        std::uintptr_t top   = 0;
+
+        // Used on the stacks below the one running now, for bytes_per_call().
+        std::size_t below = 0;
+
+        std::size_t deepest       = 0;
+        std::size_t deepest_bytes = 0;
+
+        std::vector<std::unique_ptr<std::byte[]>> segments;
+        std::size_t                               segments_in_use = 0;
+    };
+}// namespace tek::interpreter
+
+#endif// TEK_CALL_STACK_HPP
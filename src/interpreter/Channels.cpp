@@ -0,0 +1,155 @@
+#include "Channels.hpp"
+
+#include "../exceptions/Exceptions.hpp"
+#include "../utils/guard.hpp"
+#include "Environment.hpp"
+#include "Interpreter.hpp"
+#include "Tasks.hpp"
+#include <chrono>
+#include <cmath>
+#include <fmt/format.h>
+#include <thread>
+#include <utility>
+
+namespace tek::interpreter {
+    namespace {
+        // Tries before parking, each after yielding to whoever may be about to make room or send.
+        constexpr std::size_t spin_attempts = 64;
+
+        // How long a parked thread sleeps between looks at whether its run was cancelled.
+        constexpr auto cancel_interval = std::chrono::milliseconds(10);
+
+        std::shared_ptr<ChannelState> channel_argument(const types::Literal &argument)
+        {
+            const auto  value   = argument.value();
+            const auto *channel = std::get_if<types::Channel>(&value);
+            if (!channel) { throw exceptions::NativeError("Expected a channel."); }
+            return channel->state;
+        }
+
+        types::Literal make_channel(Interpreter &interpreter, std::vector<types::Literal> &arguments)
+        {
+            const auto  value    = arguments[0].value();
+            const auto *capacity = std::get_if<double>(&value);
+            if (!capacity || *capacity < 1 || *capacity > static_cast<double>(ChannelState::max_capacity)
+                || std::floor(*capacity) != *capacity) {
+                throw exceptions::NativeError(
+                  fmt::format("Channel capacity must be a whole number from 1 to {}.", ChannelState::max_capacity));
+            }
+
+            const auto slots = static_cast<std::size_t>(*capacity);
+            interpreter.governor.allocate(sizeof(ChannelState) + slots * ChannelState::slot_bytes);
+            return types::Literal(types::Channel(std::make_shared<ChannelState>(slots)));
+        }
+
+        types::Literal send(Interpreter &interpreter, std::vector<types::Literal> &arguments)
+        {
+            if (!channel_argument(arguments[0])->send(arguments[1], interpreter.governor.cancellation())) {
+                throw exceptions::NativeError("Send on a closed channel.");
+            }
+            return types::Literal(nullptr);
+        }
+
+        types::Literal receive(Interpreter &interpreter, std::vector<types::Literal> &arguments)
+        {
+            auto value = channel_argument(arguments[0])->receive(interpreter.governor.cancellation());
+            return value ? std::move(*value) : types::Literal(nullptr);
+        }
+
+        types::Literal close(Interpreter &, std::vector<types::Literal> &arguments)
+        {
+            channel_argument(arguments[0])->close();
+            return types::Literal(nullptr);
+        }
+    }// namespace
+
+    ChannelState::ChannelState(const std::size_t capacity) : buffer{ capacity } {}
+
+    bool ChannelState::send(types::Literal &value, const std::atomic<bool> &cancelled)
+    {
+        // Whoever receives it may be on another thread.
+        value.share();
+
+        bool sent = false;
+        this->wait(this->senders_waiting, this->not_full, cancelled, [&]() {
+            if (this->closed.load()) { return true; }
+            sent = this->buffer.try_push(value);
+            return sent;
+        });
+
+        if (sent) { this->wake(this->receivers_waiting, this->not_empty); }
+        return sent;
+    }
+
+    std::optional<types::Literal> ChannelState::receive(const std::atomic<bool> &cancelled)
+    {
+        std::optional<types::Literal> value;
+        this->wait(this->receivers_waiting, this->not_empty, cancelled, [&]() {
+            value = this->buffer.try_pop();
+            if (value) { return true; }
+
+            // A value sent right before the channel was closed is there by the time it reads as closed.
+            if (!this->closed.load()) { return false; }
+            value = this->buffer.try_pop();
+            return true;
+        });
+
+        if (value) { this->wake(this->senders_waiting, this->not_full); }
+        return value;
+    }
+
+    void ChannelState::close()
+    {
+        this->closed.store(true);
+
+        std::lock_guard lock(this->mutex);
+        this->not_full.notify_all();
+        this->not_empty.notify_all();
+    }
+
+    template<typename Attempt>
+    void ChannelState::wait(
+      std::atomic<std::size_t> &waiting,
+      std::condition_variable  &changed,
+      const std::atomic<bool>  &cancelled,
+      Attempt                   attempt)
+    {
+        for (std::size_t i = 0; i < spin_attempts; ++i) {
+            if (attempt()) { return; }
+            std::this_thread::yield();
+        }
+
+        Tasks::block([&]() {
+            std::unique_lock lock(this->mutex);
+            waiting.fetch_add(1);
+            utils::ScopeGuard leave([&]() { waiting.fetch_sub(1); });
+
+            // Pairs with the fence in wake(), either the other side sees this thread waiting or this thread sees what
+            // the other side did.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            // Nobody wakes the thread when its run is cancelled, it looks every now and then instead.
+            while (!changed.wait_for(lock, cancel_interval, attempt)) {
+                if (cancelled.load(std::memory_order_relaxed)) { throw exceptions::NativeError("Run cancelled."); }
+            }
+        });
+    }
+
+    void ChannelState::wake(std::atomic<std::size_t> &waiting, std::condition_variable &changed)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load(std::memory_order_relaxed) == 0) { return; }
+
+        // A thread that found nothing to do before the change is waiting by the time the lock is free.
+        { std::lock_guard lock(this->mutex); }
+        changed.notify_one();
+    }
+
+    void define_channel_natives(Environment &globals)
+    {
+        globals.define("channel", types::Literal(types::NativeCallable("channel", &make_channel, 1)));
+        globals.define("send", types::Literal(types::NativeCallable("send", &send, 2)));
+        globals.define("recv", types::Literal(types::NativeCallable("recv", &receive, 1)));
+        globals.define("close", types::Literal(types::NativeCallable("close", &close, 1)));
+    }
+}// namespace tek::interpreter
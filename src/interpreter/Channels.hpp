@@ -0,0 +1,66 @@
+#ifndef TEK_CHANNELS_HPP
+#define TEK_CHANNELS_HPP
+
+#include "../types/Literal.hpp"
+#include "../utils/mpmc_queue.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+
+namespace tek::interpreter {
+    class Environment;
+
+    // Bounded channel between tasks, or between threads running isolates of their own. Sending and receiving take no
+    // lock unless they have to wait: a thread finding the channel full or empty retries a few times, then parks until
+    // the other side wakes it, with a spare worker standing in for it if it was one of the pool's. A parked thread
+    // gives up with a NativeError once the run it belongs to is cancelled.
+    class ChannelState
+    {
+      public:
+        static constexpr std::size_t max_capacity = std::size_t{ 1 } << 24;
+
+        // What a value in the channel takes.
+        static constexpr std::size_t slot_bytes = utils::mpmc_queue<types::Literal>::slot_bytes;
+
+        explicit ChannelState(std::size_t capacity);
+
+        // Moves `value` in, waiting while the channel is full. False, with `value` left alone, once it is closed.
+        bool send(types::Literal &value, const std::atomic<bool> &cancelled);
+
+        // Waits while the channel is empty, nothing once it is closed and every value sent was received.
+        std::optional<types::Literal> receive(const std::atomic<bool> &cancelled);
+
+        // Wakes whoever waits on the channel, values sent before can still be received.
+        void close();
+
+      private:
+        // Until `attempt` succeeds, `waiting` counts the threads parked on `changed` meanwhile. Throws once `cancelled`
+        // is set.
+        template<typename Attempt>
+        void wait(
+          std::atomic<std::size_t> &waiting,
+          std::condition_variable  &changed,
+          const std::atomic<bool>  &cancelled,
+          Attempt                   attempt);
+
+        void wake(std::atomic<std::size_t> &waiting, std::condition_variable &changed);
+
+      private:
+        utils::mpmc_queue<types::Literal> buffer;
+        std::atomic<bool>                 closed{ false };
+
+        std::mutex               mutex;
+        std::condition_variable  not_full;
+        std::condition_variable  not_empty;
+        std::atomic<std::size_t> senders_waiting{ 0 };
+        std::atomic<std::size_t> receivers_waiting{ 0 };
+    };
+
+    // channel(capacity), send(channel, value), recv(channel), which gives nil once the channel is closed and drained,
+    // and close(channel).
+    void define_channel_natives(Environment &globals);
+}// namespace tek::interpreter
+
+#endif// TEK_CHANNELS_HPP
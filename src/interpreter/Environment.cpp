@@ -8,13 +8,17 @@ namespace tek::interpreter {
 
     void Environment::define(const std::string &name, const tek::types::Literal &initializer)
     {
+        const auto lock = this->write_lock(&initializer);
         this->variables.insert_or_assign(name, initializer);
     }
 
     types::Literal Environment::get(const tokenizer::Token &name)
     {
-        const auto it = this->variables.find(name.lexeme);
-        if (it != this->variables.end()) { return this->variables.at(name.lexeme); }
+        {
+            const auto lock = this->read_lock();
+            const auto it   = this->variables.find(name.lexeme);
+            if (it != this->variables.end()) { return it->second; }
+        }
 
         if (this->enclosing != nullptr) { return this->enclosing->get(name); }
 
@@ -23,15 +27,20 @@ namespace tek::interpreter {
 
     types::Literal Environment::get_at(const size_t distance, const std::string &name)
     {
-        return this->ancestor(distance)->variables.at(name);
+        auto      *environment = this->ancestor(distance);
+        const auto lock        = environment->read_lock();
+        return environment->variables.at(name);
     }
 
     void Environment::assign(const tokenizer::Token &name, const types::Literal &value)
     {
-        const auto it = this->variables.find(name.lexeme);
-        if (it != this->variables.end()) {
-            this->variables.at(name.lexeme) = value;
-            return;
+        {
+            const auto lock = this->write_lock(&value);
+            const auto it   = this->variables.find(name.lexeme);
+            if (it != this->variables.end()) {
+                it->second = value;
+                return;
+            }
         }
 
         if (this->enclosing != nullptr) {
@@ -44,16 +53,50 @@ namespace tek::interpreter {
 
     void Environment::assign_at(const size_t distance, const tokenizer::Token &name, const types::Literal &value)
     {
-        this->ancestor(distance)->variables.insert_or_assign(name.lexeme, value);
+        auto      *environment = this->ancestor(distance);
+        const auto lock        = environment->write_lock(&value);
+        environment->variables.insert_or_assign(name.lexeme, value);
+    }
+
+    void Environment::clear()
+    {
+        const auto lock = this->write_lock(nullptr);
+        this->variables.clear();
     }
 
-    Environment::EnvironmentPtr Environment::ancestor(const size_t distance)
+    void Environment::share()
     {
-        auto environment = std::make_shared<Environment>(*this);
+        for (auto *environment = this; environment != nullptr; environment = environment->enclosing.get()) {
+            // Enclosing environments were shared along with this one.
+            if (environment->shared.load(std::memory_order_acquire)) { return; }
+            environment->shared.store(true, std::memory_order_release);
 
-        for (size_t i = 0; i < distance; ++i) { environment = environment->enclosing; }
+            for (const auto &[name, value] : environment->variables) { value.share(); }
+        }
+    }
+
+    Environment *Environment::ancestor(const size_t distance)
+    {
+        auto *environment = this;
+
+        for (size_t i = 0; i < distance; ++i) { environment = environment->enclosing.get(); }
 
         return environment;
     }
 
+    std::shared_lock<std::shared_mutex> Environment::read_lock()
+    {
+        if (!this->shared.load(std::memory_order_acquire)) { return {}; }
+        return std::shared_lock(this->mutex);
+    }
+
+    std::unique_lock<std::shared_mutex> Environment::write_lock(const types::Literal *value)
+    {
+        if (!this->shared.load(std::memory_order_acquire)) { return {}; }
+
+        // Whatever a shared environment holds is shared in turn.
+        if (value != nullptr) { value->share(); }
+        return std::unique_lock(this->mutex);
+    }
+
 }// namespace tek::interpreter
@@ -4,10 +4,15 @@
 #include "../exceptions/Exceptions.hpp"
 #include "../tokenizer/Token.hpp"
 #include "../types/Literal.hpp"
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 
 namespace tek::interpreter {
+    // Variables of a scope. Only the thread that created it uses an environment until it is shared with tasks, from
+    // then on every access takes its lock, shared for reads.
     class Environment
     {
       private:
@@ -23,12 +28,29 @@ namespace tek::interpreter {
         void                         assign(const tokenizer::Token &name, const types::Literal &value);
         void assign_at(const size_t distance, const tokenizer::Token &name, const types::Literal &value);
 
+        // Drops every variable. A function keeps the environment it was declared in alive, which in turn keeps the
+        // function, this breaks the cycle.
+        void clear();
+
+        // Shares this environment, the enclosing ones and those of the functions their variables hold, along with the
+        // functions stored in them later on. Only ever done by the thread that uses them so far, and for good.
+        void share();
+
       private:
-        EnvironmentPtr ancestor(const size_t distance);
+        friend class Snapshot;
+
+        Environment *ancestor(const size_t distance);
+
+        // Both leave the lock alone while the environment isn't shared. Writing shares `value` first if it is.
+        [[nodiscard]] std::shared_lock<std::shared_mutex> read_lock();
+        [[nodiscard]] std::unique_lock<std::shared_mutex> write_lock(const types::Literal *value);
 
       private:
         std::unordered_map<std::string, types::Literal> variables;
         EnvironmentPtr                                  enclosing;
+
+        std::atomic<bool> shared{ false };
+        std::shared_mutex mutex;
     };
 }// namespace tek::interpreter
 
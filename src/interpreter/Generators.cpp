@@ -0,0 +1,26 @@
+#include "Generators.hpp"
+
+#include "Environment.hpp"
+#include <utility>
+
+namespace tek::interpreter {
+    GeneratorState::GeneratorState(
+      std::shared_ptr<parser::Ast>           ast,
+      parser::NodeRange<parser::StatementId> body,
+      std::shared_ptr<Environment>           environment)
+      : ast{ std::move(ast) }
+    {
+        this->frames.push_back(GeneratorFrame{ {}, body, std::move(environment), 0, std::nullopt });
+    }
+
+    GeneratorState::GeneratorState(std::deque<types::Literal> values) : values{ std::move(values) } {}
+
+    void GeneratorState::share() const
+    {
+        for (const auto &value : this->values) { value.share(); }
+        for (const auto &frame : this->frames) {
+            frame.environment->share();
+            if (frame.iterable) { frame.iterable->state->share(); }
+        }
+    }
+}// namespace tek::interpreter
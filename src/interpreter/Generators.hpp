@@ -0,0 +1,59 @@
+#ifndef TEK_GENERATORS_HPP
+#define TEK_GENERATORS_HPP
+
+#include "../parser/Ast.hpp"
+#include "../types/Literal.hpp"
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace tek::interpreter {
+    class Environment;
+
+    // A statement of a generator's body the interpreter is in the middle of, or a list of statements.
+    struct GeneratorFrame
+    {
+        // None while running `block`.
+        parser::StatementId                    statement;
+        parser::NodeRange<parser::StatementId> block;
+        std::shared_ptr<Environment>           environment;
+
+        // The next statement of `block`, or how far a loop got: 0 before its first iteration.
+        std::size_t next = 0;
+
+        // What a `for (var x in ...)` runs over, once evaluated.
+        std::optional<types::Generator> iterable;
+    };
+
+    // The suspended body of a call to a `fun*`. Rather than nesting C++ calls, the statements the body is in the middle
+    // of are kept as frames on the heap: a `yield` returns to whoever resumed the generator with the frames left in
+    // place, and the next resume carries on from the innermost one. Expressions are still evaluated recursively, they
+    // can't yield. See Interpreter::resume().
+    struct GeneratorState
+    {
+        GeneratorState(
+          std::shared_ptr<parser::Ast>           ast,
+          parser::NodeRange<parser::StatementId> body,
+          std::shared_ptr<Environment>           environment);
+
+        // Over values computed up front, by natives.
+        explicit GeneratorState(std::deque<types::Literal> values);
+
+        // Shares the environments of the frames, before the generator is handed to a task.
+        void share() const;
+
+        std::shared_ptr<parser::Ast> ast;
+        std::vector<GeneratorFrame>  frames;
+
+        // Yielded before the frames are run.
+        std::deque<types::Literal> values;
+
+        // Held while the body runs, a generator resumed from its own body or on two threads at once is an error.
+        std::mutex running;
+    };
+}// namespace tek::interpreter
+
+#endif// TEK_GENERATORS_HPP
@@ -0,0 +1,74 @@
+#include "Governor.hpp"
+
+#include "../exceptions/Exceptions.hpp"
+#include <algorithm>
+#include <fmt/format.h>
+#include <utility>
+
+namespace tek::interpreter {
+    namespace {
+        // A governor settles again once it took this share of the steps or bytes the run has left.
+        constexpr std::uint64_t allowance_divisor = 64;
+    }// namespace
+
+    void Governor::reset(const Limits &limits)
+    {
+        this->limits         = limits;
+        this->steps          = 0;
+        this->max_steps      = limits.steps != 0 ? limits.steps : UINT64_MAX;
+        this->allocated      = 0;
+        this->max_allocated  = limits.allocated_bytes != 0 ? limits.allocated_bytes : SIZE_MAX;
+        this->settled_steps  = 0;
+        this->settled_bytes  = 0;
+        this->next_settle    = 0;
+        this->byte_allowance = 0;
+        this->run->cancelled.store(false, std::memory_order_relaxed);
+        this->run->steps.store(0, std::memory_order_relaxed);
+        this->run->allocated.store(0, std::memory_order_relaxed);
+        this->stack.reset(limits.stack_bytes);
+    }
+
+    void Governor::inherit(const Governor &parent)
+    {
+        this->limits         = parent.limits;
+        this->steps          = 0;
+        this->max_steps      = parent.max_steps;
+        this->allocated      = 0;
+        this->max_allocated  = parent.max_allocated;
+        this->settled_steps  = 0;
+        this->settled_bytes  = 0;
+        this->next_settle    = 0;
+        this->byte_allowance = 0;
+        this->run            = parent.run;
+        this->stack.reset(parent.limits.stack_bytes);
+    }
+
+    void Governor::settle(const tokenizer::Token &where)
+    {
+        const auto new_steps = this->steps - std::exchange(this->settled_steps, this->steps);
+        const auto new_bytes = this->allocated - std::exchange(this->settled_bytes, this->allocated);
+        const auto steps     = this->run->steps.fetch_add(new_steps, std::memory_order_relaxed) + new_steps;
+        const auto bytes     = this->run->allocated.fetch_add(new_bytes, std::memory_order_relaxed) + new_bytes;
+
+        if (steps > this->max_steps || bytes > this->max_allocated
+            || this->run->cancelled.load(std::memory_order_relaxed)) {
+            this->stop(where);
+        }
+
+        const auto step_allowance = std::min((this->max_steps - steps) / allowance_divisor, max_steps_unsettled);
+        this->next_settle         = this->steps + step_allowance;
+        this->byte_allowance      = (this->max_allocated - bytes) / allowance_divisor;
+    }
+
+    void Governor::stop(const tokenizer::Token &where)
+    {
+        if (this->run->cancelled.load(std::memory_order_relaxed)) {
+            throw exceptions::RuntimeError(where, "Run cancelled.");
+        }
+        if (this->run->steps.load(std::memory_order_relaxed) > this->max_steps) {
+            throw exceptions::RuntimeError(where, fmt::format("Step limit of {} exceeded.", this->max_steps));
+        }
+        throw exceptions::RuntimeError(
+          where, fmt::format("Allocation limit of {} bytes exceeded.", this->max_allocated));
+    }
+}// namespace tek::interpreter
@@ -0,0 +1,118 @@
+#ifndef TEK_GOVERNOR_HPP
+#define TEK_GOVERNOR_HPP
+
+#include "../tokenizer/Token.hpp"
+#include "CallStack.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace tek::interpreter {
+    // What a single run may use, zero for no limit unless said otherwise.
+    struct Limits
+    {
+        // Loop iterations and calls.
+        std::uint64_t steps = 0;
+
+        // Bytes allocated for strings, environments, variables and functions over the whole run. What was freed again
+        // still counts, so this caps the work spent allocating rather than the memory held at any one time.
+        std::uint64_t allocated_bytes = 0;
+
+        // Heap the call stack may grow into once the native stack runs low, zero to stay on the native stack. Deeper
+        // recursion fails with a stack overflow either way.
+        std::uint64_t stack_bytes = CallStack::default_budget;
+    };
+
+    // Accounts for the steps and allocations of an interpreter's runs. Limits and cancellation are checked at loop
+    // back-edges and calls, going over or being cancelled raises a RuntimeError there. The governors of the tasks a run
+    // spawns charge the same totals, a governor adds what it counted to them every so many steps, fewer the closer
+    // the run is to its limits. A run alone stops right at them, tasks running at once may each go over by a little.
+    class Governor
+    {
+      public:
+        // Zeroes the counters and clears a pending cancellation, done before every run.
+        void reset(const Limits &limits);
+
+        // For the interpreter of a task spawned under `parent`: the same limits and totals, and cancelled along with
+        // it.
+        void inherit(const Governor &parent);
+
+        void step(const tokenizer::Token &where)
+        {
+            if (++this->steps > this->next_settle || this->run->cancelled.load(std::memory_order_relaxed)) {
+                this->settle(where);
+            }
+        }
+
+        // Counted at the next step, right then once this governor allocated a fair share of what is left.
+        void allocate(const std::size_t bytes)
+        {
+            this->allocated += bytes;
+            if (this->allocated - this->settled_bytes > this->byte_allowance) { this->next_settle = this->steps; }
+        }
+
+        // Runs a Tek call, counted as a step, on the call stack.
+        template<typename Call>
+        types::Literal call(const tokenizer::Token &where, Call &&call)
+        {
+            this->step(where);
+            return this->stack.call(where, std::forward<Call>(call));
+        }
+
+        // Evaluates or executes a node on the call stack, see CallStack::nest().
+        template<typename Run, typename Where>
+        decltype(auto) nest(Run &&run, Where &&where)
+        {
+            return this->stack.nest(std::forward<Run>(run), std::forward<Where>(where));
+        }
+
+        // Safe to call from any thread, the run stops at its next check.
+        void cancel() { this->run->cancelled.store(true, std::memory_order_relaxed); }
+
+        // Set once the run is cancelled, for waits that no step would interrupt.
+        [[nodiscard]] const std::atomic<bool> &cancellation() const { return this->run->cancelled; }
+
+        // By this governor alone.
+        [[nodiscard]] std::uint64_t steps_taken() const { return this->steps; }
+        [[nodiscard]] std::size_t   bytes_allocated() const { return this->allocated; }
+        [[nodiscard]] std::size_t   stack_bytes_per_call() const { return this->stack.bytes_per_call(); }
+
+      private:
+        // Shared with the governors of the tasks spawned, and theirs in turn.
+        struct Run
+        {
+            std::atomic<bool>          cancelled{ false };
+            std::atomic<std::uint64_t> steps{ 0 };
+            std::atomic<std::size_t>   allocated{ 0 };
+        };
+
+        // Most steps a governor takes between adding to the totals.
+        static constexpr std::uint64_t max_steps_unsettled = 4096;
+
+        // Adds what this governor counted since last time to the totals, stops the run if they went over or it was
+        // cancelled, and works out when to do so again.
+        void settle(const tokenizer::Token &where);
+
+        [[noreturn]] void stop(const tokenizer::Token &where);
+
+      private:
+        Limits        limits;
+        std::uint64_t steps         = 0;
+        std::uint64_t max_steps     = UINT64_MAX;
+        std::size_t   allocated     = 0;
+        std::size_t   max_allocated = SIZE_MAX;
+        CallStack     stack;
+
+        // How much of `steps` and `allocated` the totals have, and how far either may get before the next settle().
+        std::uint64_t settled_steps  = 0;
+        std::size_t   settled_bytes  = 0;
+        std::uint64_t next_settle    = 0;
+        std::size_t   byte_allowance = 0;
+
+        std::shared_ptr<Run> run = std::make_shared<Run>();
+    };
+}// namespace tek::interpreter
+
+#endif// TEK_GOVERNOR_HPP
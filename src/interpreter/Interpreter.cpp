@@ -1,9 +1,19 @@
 #include "Interpreter.hpp"
 
+#include "../parser/Dispatch.hpp"
+#include "Channels.hpp"
+#include "Parallel.hpp"
+#include <set>
+#include <utility>
+
 namespace tek::interpreter {
+    namespace {
+        // What a variable costs in an environment, the hash node around the name and value included.
+        constexpr std::size_t variable_bytes
+          = sizeof(std::pair<const std::string, types::Literal>) + 2 * sizeof(void *);
+    }// namespace
 
-    // TODO: Find out why this is not working
-    types::Literal clock(Interpreter &interpreter, const std::vector<types::Literal> &arguments)
+    types::Literal clock(Interpreter &interpreter, std::vector<types::Literal> &arguments)
     {
         auto current_time        = std::chrono::system_clock::now();
         auto duration_in_seconds = std::chrono::duration<double>(current_time.time_since_epoch());
@@ -15,20 +25,85 @@ namespace tek::interpreter {
     {
         // TODO: Take this into the standard library
         this->globals->define("clock", types::Literal(types::NativeCallable("clock", &clock, 0)));
+        define_channel_natives(*this->globals);
+        define_parallel_natives(*this->globals);
+    }
+
+    Interpreter::Interpreter(Child, const Interpreter &parent)
+      : globals{ parent.globals }, output{ parent.output }, environment{ parent.globals }, locals{ parent.locals },
+        tasks{ parent.tasks }, output_lock{ parent.output_lock }
+    {
+        this->governor.inherit(parent.governor);
+    }
+
+    void Interpreter::interpret(const AstPtr &ast, const Interpreter::StatementsVec &statements)
+    {
+        if (this->run(ast, statements)) {
+            [[maybe_unused]] const auto finished = this->wait_for_tasks();
+        } else {
+            this->cancel_tasks();
+        }
     }
 
-    void Interpreter::interpret(const Interpreter::StatementsVec &statements)
+    bool Interpreter::run(const AstPtr &ast, const Interpreter::StatementsVec &statements)
     {
+        const auto previous = this->ast;
         try {
+            utils::ScopeGuard guard([&]() { this->ast = previous; });
+            this->ast = ast;
             for (const auto &statement : statements) { this->execute(statement); }
         } catch (const exceptions::RuntimeError &error) {
             logger::Logger::runtime_error(error);
+            return false;
         }
+        return true;
+    }
+
+    bool Interpreter::wait_for_tasks()
+    {
+        // Tasks often fail alike, running into the limits of the run or over the same value, each error is told once.
+        std::set<std::pair<std::string, std::size_t>> reported;
+
+        bool finished = true;
+        for (const auto &error : this->tasks.wait()) {
+            try {
+                std::rethrow_exception(error);
+            } catch (const exceptions::RuntimeError &failure) {
+                if (reported.emplace(failure.message, failure.op.line).second) {
+                    logger::Logger::runtime_error(failure);
+                }
+                finished = false;
+            }
+        }
+        return finished;
+    }
+
+    void Interpreter::cancel_tasks()
+    {
+        this->governor.cancel();
+        [[maybe_unused]] const auto errors = this->tasks.wait();
+    }
+
+    void Interpreter::interpret(
+      const AstPtr                      &ast,
+      const Interpreter::StatementsVec  &statements,
+      const Interpreter::EnvironmentPtr &globals)
+    {
+        const auto previous = std::exchange(this->globals, globals);
+        this->environment   = globals;
+
+        utils::ScopeGuard guard([&]() {
+            this->globals     = previous;
+            this->environment = previous;
+        });
+        this->interpret(ast, statements);
     }
 
+    void Interpreter::detach_locals() { this->locals = std::make_shared<Locals>(*this->locals); }
+
     void Interpreter::resolve(parser::Expression *expression, const size_t depth)
     {
-        this->locals.emplace(expression, depth);
+        this->locals->emplace(expression, depth);
     }
 
     types::Literal Interpreter::visit_literal_expression(parser::LiteralExpression &expression)
@@ -41,39 +116,112 @@ namespace tek::interpreter {
         return this->evaluate(expression.expression);
     }
 
-    types::Literal Interpreter::evaluate(const ExpressionPtr &expression) { return expression->accept(*this); }
-
-    void Interpreter::execute(const StatementPtr &statement) { statement->accept(*this); }
+    types::Literal Interpreter::evaluate(const parser::ExpressionId expression)
+    {
+        return this->governor.nest(
+          [&]() { return parser::dispatch(*this, *this->ast, expression); },
+          [&]() { return this->site(expression); });
+    }
+
+    void Interpreter::execute(const parser::StatementId statement)
+    {
+        this->governor.nest(
+          [&]() { parser::dispatch(*this, *this->ast, statement); }, [&]() { return this->site(statement); });
+    }
+
+    tokenizer::Token Interpreter::site(parser::ExpressionId expression) const
+    {
+        // Groupings and literals have no token of their own, the one inside or none at all stands for them.
+        while (expression) {
+            switch (expression.kind()) {
+                case parser::ExpressionKind::BINARY:
+                    return this->ast->token(this->ast->get<parser::BinaryExpression>(expression).op);
+                case parser::ExpressionKind::GROUPING:
+                    expression = this->ast->get<parser::GroupingExpression>(expression).expression;
+                    break;
+                case parser::ExpressionKind::UNARY:
+                    return this->ast->token(this->ast->get<parser::UnaryExpression>(expression).op);
+                case parser::ExpressionKind::VAR:
+                    return this->ast->token(this->ast->get<parser::VarExpression>(expression).name);
+                case parser::ExpressionKind::ASSIGN:
+                    return this->ast->token(this->ast->get<parser::AssignExpression>(expression).name);
+                case parser::ExpressionKind::LOGICAL:
+                    return this->ast->token(this->ast->get<parser::LogicalExpression>(expression).op);
+                case parser::ExpressionKind::CALL:
+                    return this->ast->token(this->ast->get<parser::CallExpression>(expression).paren);
+                case parser::ExpressionKind::SPAWN:
+                    return this->ast->token(this->ast->get<parser::SpawnExpression>(expression).keyword);
+                case parser::ExpressionKind::AWAIT:
+                    return this->ast->token(this->ast->get<parser::AwaitExpression>(expression).keyword);
+                default:
+                    return tokenizer::Token();
+            }
+        }
+        return tokenizer::Token();
+    }
+
+    tokenizer::Token Interpreter::site(const parser::StatementId statement) const
+    {
+        switch (statement.kind()) {
+            case parser::StatementKind::PRINT:
+                return this->site(this->ast->get<parser::PrintStatement>(statement).expression);
+            case parser::StatementKind::EXPRESSION:
+                return this->site(this->ast->get<parser::ExpressionStatement>(statement).expression);
+            case parser::StatementKind::VAR:
+                return this->ast->token(this->ast->get<parser::VarStatement>(statement).name);
+            case parser::StatementKind::IF:
+                return this->site(this->ast->get<parser::IfStatement>(statement).condition);
+            case parser::StatementKind::WHILE:
+                return this->ast->token(this->ast->get<parser::WhileStatement>(statement).keyword);
+            case parser::StatementKind::FOR:
+                return this->ast->token(this->ast->get<parser::ForStatement>(statement).keyword);
+            case parser::StatementKind::FUNCTION:
+                return this->ast->token(this->ast->get<parser::FunctionStatement>(statement).name);
+            case parser::StatementKind::RETURN:
+                return this->ast->token(this->ast->get<parser::ReturnStatement>(statement).keyword);
+            case parser::StatementKind::YIELD:
+                return this->ast->token(this->ast->get<parser::YieldStatement>(statement).keyword);
+            case parser::StatementKind::FOR_IN:
+                return this->ast->token(this->ast->get<parser::ForInStatement>(statement).keyword);
+            default:
+                return tokenizer::Token();
+        }
+    }
 
     types::Literal Interpreter::lookup_variable(const tokenizer::Token &name, parser::Expression *expression)
     {
-        try {
-            const auto distance = this->locals.at(expression);
-            return this->environment->get_at(distance, name.lexeme);
-        } catch (const std::out_of_range &e) {
-            return this->globals->get(name);
+        if (const auto it = this->locals->find(expression); it != this->locals->end()) {
+            return this->environment->get_at(it->second, name.lexeme);
         }
+        return this->globals->get(name);
     }
 
-    void Interpreter::execute_block(const StatementsVec &statements, const EnvironmentPtr &environment)
+    void Interpreter::execute_block(
+      const AstPtr         &ast,
+      const Statements      statements,
+      const EnvironmentPtr &environment)
     {
-        const auto previous = this->environment;
+        const auto previous_environment = this->environment;
+        const auto previous_ast         = this->ast;
 
-        try {
-            utils::ScopeGuard guard([&]() { this->environment = previous; });
-            this->environment = environment;
-            for (const auto &statement : statements) { this->execute(statement); }
-        } catch (const exceptions::RuntimeError &error) {
-        }
+        // Errors go on up to interpret(), which reports them.
+        utils::ScopeGuard guard([&]() {
+            this->environment = previous_environment;
+            this->ast         = previous_ast;
+        });
+        this->environment = environment;
+        this->ast         = ast;
+        for (const auto &statement : statements) { this->execute(statement); }
     }
 
     types::Literal Interpreter::visit_unary_expression(parser::UnaryExpression &expression)
     {
         const auto right = this->evaluate(expression.right).value();
 
-        switch (expression.op.type) {
+        const auto &op = this->ast->token(expression.op);
+        switch (op.type) {
             case tokenizer::TokenType::MINUS: {
-                return Interpreter::interpret_unary_minus(expression, right);
+                return Interpreter::interpret_unary_minus(op, right);
             }
             case tokenizer::TokenType::BANG:
                 return types::Literal(!tek::interpreter::Interpreter::is_truthy(right));
@@ -89,30 +237,34 @@ namespace tek::interpreter {
         const auto left  = this->evaluate(expression.left).value();
         const auto right = this->evaluate(expression.right).value();
 
-        switch (expression.op.type) {
+        const auto &op = this->ast->token(expression.op);
+        switch (op.type) {
             case tokenizer::TokenType::MINUS: {
-                return Interpreter::interpret_binary_minus(expression, left, right);
+                return Interpreter::interpret_binary_minus(op, left, right);
             }
             case tokenizer::TokenType::PLUS: {
-                return Interpreter::interpret_binary_plus(expression, left, right);
+                const auto *left_text  = std::get_if<std::string>(&left);
+                const auto *right_text = std::get_if<std::string>(&right);
+                if (left_text && right_text) { this->governor.allocate(left_text->size() + right_text->size()); }
+                return Interpreter::interpret_binary_plus(op, left, right);
             }
             case tokenizer::TokenType::SLASH: {
-                return Interpreter::interpret_binary_slash(expression, left, right);
+                return Interpreter::interpret_binary_slash(op, left, right);
             }
             case tokenizer::TokenType::STAR: {
-                return Interpreter::interpret_binary_star(expression, left, right);
+                return Interpreter::interpret_binary_star(op, left, right);
             }
             case tokenizer::TokenType::GREATER: {
-                return Interpreter::interpret_binary_greater(expression, left, right);
+                return Interpreter::interpret_binary_greater(op, left, right);
             }
             case tokenizer::TokenType::GREATER_EQUAL: {
-                return Interpreter::interpret_binary_greater_equal(expression, left, right);
+                return Interpreter::interpret_binary_greater_equal(op, left, right);
             }
             case tokenizer::TokenType::LESS: {
-                return Interpreter::interpret_binary_less(expression, left, right);
+                return Interpreter::interpret_binary_less(op, left, right);
             }
             case tokenizer::TokenType::LESS_EQUAL: {
-                return Interpreter::interpret_binary_less_equal(expression, left, right);
+                return Interpreter::interpret_binary_less_equal(op, left, right);
             }
             case tokenizer::TokenType::BANG_EQUAL: {
                 return types::Literal(!tek::interpreter::Interpreter::is_equal(left, right));
@@ -128,20 +280,25 @@ namespace tek::interpreter {
 
     types::Literal Interpreter::visit_var_expression(parser::VarExpression &expression)
     {
-        return this->lookup_variable(expression.name, &expression);
+        const auto &name = this->ast->token(expression.name);
+        if (expression.depth != parser::global_depth) {
+            return this->environment->get_at(expression.depth, name.lexeme);
+        }
+
+        return this->lookup_variable(name, &expression);
     }
 
     types::Literal Interpreter::visit_assign_expression(parser::AssignExpression &expression)
     {
 
-        const auto name  = expression.name;
-        auto       value = this->evaluate(expression.value);
-
+        auto        value = this->evaluate(expression.value);
+        const auto &name  = this->ast->token(expression.name);
 
-        try {
-            const auto distance = this->locals.at(&expression);
-            this->environment->assign_at(distance, name, value);
-        } catch (const std::out_of_range &e) {
+        if (expression.depth != parser::global_depth) {
+            this->environment->assign_at(expression.depth, name, value);
+        } else if (const auto it = this->locals->find(&expression); it != this->locals->end()) {
+            this->environment->assign_at(it->second, name, value);
+        } else {
             this->globals->assign(name, value);
         }
 
@@ -153,7 +310,7 @@ namespace tek::interpreter {
     {
         const auto left = this->evaluate(expression.left).value();
 
-        if (expression.op.type == tokenizer::TokenType::OR) {
+        if (this->ast->token(expression.op).type == tokenizer::TokenType::OR) {
             if (Interpreter::is_truthy(left)) { return types::Literal(left); }
         } else {
             if (!Interpreter::is_truthy(left)) { return types::Literal(left); }
@@ -162,35 +319,104 @@ namespace tek::interpreter {
         return this->evaluate(expression.right);
     }
 
-    types::Literal Interpreter::visit_call_expression(parser::CallExpression &expression)
+    types::Literal::CallablePtr
+      Interpreter::evaluate_call(parser::CallExpression &expression, std::vector<types::Literal> &arguments)
     {
         auto callee = this->evaluate(expression.callee);
 
-        std::vector<types::Literal> evaluated_argumensts;
+        for (const auto &arg : this->ast->expressions(expression.arguments)) {
+            arguments.emplace_back(this->evaluate(arg).value());
+        }
 
-        for (const auto &arg : expression.arguments) { evaluated_argumensts.emplace_back(this->evaluate(arg).value()); }
+        auto function = callee.as_callable();
+        if (!function) {
+            throw exceptions::RuntimeError(this->ast->token(expression.paren), "Call operator lhs is not a callable.");
+        }
 
-        if (const auto function = callee.as_callable()) {
+        // Check for the number of arguments
+        const auto actual_argument_num   = arguments.size();
+        const auto expected_argument_num = function->get_arity();
+        if (actual_argument_num != expected_argument_num) {
+            throw exceptions::RuntimeError(
+              this->ast->token(expression.paren),
+              fmt::format("Expected {} arguments but got {}.", expected_argument_num, actual_argument_num));
+        }
+        return function;
+    }
 
-            // Check for the number of arguments
-            const auto actual_argument_num   = evaluated_argumensts.size();
-            const auto expected_argument_num = function->get_arity();
-            if (actual_argument_num != expected_argument_num) {
-                throw exceptions::RuntimeError(
-                  expression.paren,
-                  fmt::format("Expected {} arguments but got {}.", expected_argument_num, actual_argument_num));
+    types::Literal Interpreter::invoke(
+      types::Callable             &function,
+      std::vector<types::Literal> &arguments,
+      const tokenizer::Token      &where)
+    {
+        const auto        previous = std::exchange(this->call_site, &where);
+        utils::ScopeGuard guard([&]() { this->call_site = previous; });
+        return this->governor.call(where, [&]() {
+            try {
+                return function.call(*this, std::move(arguments));
+            } catch (const exceptions::NativeError &error) {
+                throw exceptions::RuntimeError(where, error.message);
             }
+        });
+    }
+
+    types::Literal Interpreter::visit_call_expression(parser::CallExpression &expression)
+    {
+        std::vector<types::Literal> evaluated_argumensts;
+        const auto                  function = this->evaluate_call(expression, evaluated_argumensts);
+
+        this->governor.allocate(sizeof(Environment) + evaluated_argumensts.size() * variable_bytes);
+        return this->invoke(*function, evaluated_argumensts, this->ast->token(expression.paren));
+    }
+
+    types::Literal Interpreter::visit_spawn_expression(parser::SpawnExpression &expression)
+    {
+        auto                            &call = this->ast->get<parser::CallExpression>(expression.call);
+        std::vector<types::Literal>      arguments;
+        std::shared_ptr<types::Callable> function = this->evaluate_call(call, arguments);
+
+        this->governor.step(this->ast->token(expression.keyword));
+        this->governor.allocate(sizeof(TaskState) + sizeof(Interpreter) + arguments.size() * variable_bytes);
+
+        // From here on the task reads the function's closure and the globals from another thread.
+        function->share();
+        for (const auto &argument : arguments) { argument.share(); }
+        this->globals->share();
+        if (!this->output_lock) { this->output_lock = std::make_shared<std::mutex>(); }
+
+        auto child = std::make_shared<Interpreter>(Child{}, *this);
+        return types::Literal(this->tasks.spawn(
+          [child, function, arguments = std::move(arguments), where = this->ast->token(call.paren)]() mutable {
+              auto result = child->invoke(*function, arguments, where);
 
-            return function->call(*this, evaluated_argumensts);
+              // Whoever awaits the task may be on yet another thread.
+              result.share();
+              return result;
+          }));
+    }
+
+    types::Literal Interpreter::visit_await_expression(parser::AwaitExpression &expression)
+    {
+        const auto  value = this->evaluate(expression.task).value();
+        const auto *task  = std::get_if<types::Task>(&value);
+        if (!task) {
+            throw exceptions::RuntimeError(this->ast->token(expression.keyword), "Only tasks can be awaited.");
         }
 
-        throw exceptions::RuntimeError(expression.paren, "Call operator lhs is not a callable.");
+        return Tasks::await(*task);
     }
 
     void Interpreter::visit_print_statement(parser::PrintStatement &statement)
     {
         const types::Literal value = this->evaluate(statement.expression);
-        fmt::print("{}\n", tek::interpreter::Interpreter::stringify(value));
+
+        std::unique_lock<std::mutex> lock;
+        if (this->output_lock) { lock = std::unique_lock(*this->output_lock); }
+        if (this->output) {
+            this->output(tek::interpreter::Interpreter::stringify(value) + '\n');
+        } else {
+            fmt::print("{}\n", tek::interpreter::Interpreter::stringify(value));
+        }
     }
 
     void Interpreter::visit_expression_statement(parser::ExpressionStatement &statement)
@@ -201,13 +427,18 @@ namespace tek::interpreter {
     void Interpreter::visit_var_statement(parser::VarStatement &statement)
     {
         types::Literal value(nullptr);
-        if (statement.initializer != nullptr) { value = this->evaluate(statement.initializer); }
-        this->environment->define(statement.name.lexeme, value);
+        if (statement.initializer) { value = this->evaluate(statement.initializer); }
+
+        const auto &name = this->ast->token(statement.name).lexeme;
+        this->governor.allocate(variable_bytes + name.size());
+        this->environment->define(name, value);
     }
 
     void Interpreter::visit_block_statement(parser::BlockStatement &statement)
     {
-        this->execute_block(statement.statements, std::make_shared<Environment>(this->environment));
+        this->governor.allocate(sizeof(Environment));
+        this->execute_block(
+          this->ast, this->ast->statements(statement.statements), std::make_shared<Environment>(this->environment));
     }
 
     void Interpreter::visit_if_statement(parser::IfStatement &statement)
@@ -221,34 +452,44 @@ namespace tek::interpreter {
 
     void Interpreter::visit_while_statement(parser::WhileStatement &statement)
     {
-        while (Interpreter::is_truthy(this->evaluate(statement.condition).value())) { this->execute(statement.body); }
+        const auto &keyword = this->ast->token(statement.keyword);
+        while (Interpreter::is_truthy(this->evaluate(statement.condition).value())) {
+            this->execute(statement.body);
+            this->governor.step(keyword);
+        }
     }
 
-
     void Interpreter::visit_for_statement(parser::ForStatement &statement)
     {
         const auto previous        = this->environment;
         const auto new_environment = std::make_shared<Environment>(this->environment);
+        this->governor.allocate(sizeof(Environment));
 
         utils::ScopeGuard guard([&]() { this->environment = previous; });
         this->environment = new_environment;
 
+        const auto &keyword = this->ast->token(statement.keyword);
         if (statement.initializer) { this->execute(statement.initializer); }
-        while (Interpreter::is_truthy(this->evaluate(statement.condition).value())) { this->execute(statement.body); }
+        while (Interpreter::is_truthy(this->evaluate(statement.condition).value())) {
+            this->execute(statement.body);
+            this->governor.step(keyword);
+        }
     }
 
     void Interpreter::visit_function_statement(parser::FunctionStatement &statement)
     {
-        const auto function_name = statement.name.lexeme;
-        auto       function      = std::make_shared<parser::FunctionStatement>(std::move(statement));
-        this->environment->define(function_name, types::Literal(types::TekFunction(function, this->environment)));
+        // The function keeps the whole script alive, its body is executed straight out of it.
+        const auto &function_name = this->ast->token(statement.name).lexeme;
+        this->governor.allocate(variable_bytes + sizeof(types::TekFunction));
+        this->environment->define(
+          function_name, types::Literal(types::TekFunction(this->ast, &statement, this->environment)));
     }
 
     types::Literal Interpreter::interpret_unary_minus(
-      const parser::UnaryExpression   &expression,
+      const tokenizer::Token          &op,
       const types::Literal::variant_t &right)
     {
-        Interpreter::assert_operand_types<double>(expression.op, right);
+        Interpreter::assert_operand_types<double>(op, right);
         const auto value = std::get<double>(right);
         return types::Literal(-value);
     }
@@ -261,18 +502,184 @@ namespace tek::interpreter {
         throw exceptions::Return(retval);
     }
 
+    void Interpreter::visit_yield_statement(parser::YieldStatement &statement)
+    {
+        // Generator bodies are run by resume(), which handles their yields itself.
+        throw exceptions::RuntimeError(this->ast->token(statement.keyword), "Can't yield outside a generator.");
+    }
+
+    void Interpreter::visit_for_in_statement(parser::ForInStatement &statement)
+    {
+        const auto  generator = this->iterable(statement);
+        const auto &keyword   = this->ast->token(statement.keyword);
+        const auto &name      = this->ast->token(statement.name).lexeme;
+
+        const auto        previous = this->environment;
+        utils::ScopeGuard guard([&]() { this->environment = previous; });
+        while (auto value = this->resume(*generator.state, keyword)) {
+            this->governor.allocate(sizeof(Environment) + variable_bytes + name.size());
+            this->environment = std::make_shared<Environment>(previous);
+            this->environment->define(name, *value);
+            this->execute(statement.body);
+            this->environment = previous;
+            this->governor.step(keyword);
+        }
+    }
+
+    types::Generator Interpreter::iterable(const parser::ForInStatement &statement)
+    {
+        const auto  value     = this->evaluate(statement.iterable).value();
+        const auto *generator = std::get_if<types::Generator>(&value);
+        if (!generator) {
+            throw exceptions::RuntimeError(this->ast->token(statement.keyword), "Only generators can be iterated.");
+        }
+        return *generator;
+    }
+
+    std::optional<types::Literal> Interpreter::resume(GeneratorState &generator, const tokenizer::Token &where)
+    {
+        std::unique_lock running(generator.running, std::try_to_lock);
+        if (!running) { throw exceptions::RuntimeError(where, "Generator is already running."); }
+
+        if (!generator.values.empty()) {
+            auto value = std::move(generator.values.front());
+            generator.values.pop_front();
+            return value;
+        }
+
+        const auto previous_environment = this->environment;
+        const auto previous_ast         = this->ast;
+        utils::ScopeGuard guard([&]() {
+            this->environment = previous_environment;
+            this->ast         = previous_ast;
+        });
+        this->ast = generator.ast;
+
+        // Each turn runs a step of the innermost frame. Frames are only pushed last, `frame` is gone afterwards.
+        auto &frames = generator.frames;
+        try {
+            while (!frames.empty()) {
+                auto &frame       = frames.back();
+                this->environment = frame.environment;
+
+                if (!frame.statement) {
+                    if (frame.next == frame.block.size) {
+                        frames.pop_back();
+                        continue;
+                    }
+                    const auto statement = this->ast->statements(frame.block)[frame.next++];
+                    frames.push_back(GeneratorFrame{ statement, {}, this->environment, 0, std::nullopt });
+                    continue;
+                }
+
+                switch (frame.statement.kind()) {
+                    case parser::StatementKind::BLOCK: {
+                        this->governor.allocate(sizeof(Environment));
+                        frame.block       = this->ast->get<parser::BlockStatement>(frame.statement).statements;
+                        frame.statement   = {};
+                        frame.environment = std::make_shared<Environment>(this->environment);
+                        break;
+                    }
+                    case parser::StatementKind::IF: {
+                        const auto &statement = this->ast->get<parser::IfStatement>(frame.statement);
+                        if (Interpreter::is_truthy(this->evaluate(statement.condition).value())) {
+                            frame.statement = statement.then_branch;
+                        } else if (statement.else_branch) {
+                            frame.statement = statement.else_branch;
+                        } else {
+                            frames.pop_back();
+                        }
+                        break;
+                    }
+                    case parser::StatementKind::WHILE: {
+                        const auto &statement = this->ast->get<parser::WhileStatement>(frame.statement);
+                        if (frame.next++ != 0) { this->governor.step(this->ast->token(statement.keyword)); }
+
+                        if (Interpreter::is_truthy(this->evaluate(statement.condition).value())) {
+                            frames.push_back(GeneratorFrame{ statement.body, {}, this->environment, 0, std::nullopt });
+                        } else {
+                            frames.pop_back();
+                        }
+                        break;
+                    }
+                    case parser::StatementKind::FOR: {
+                        const auto &statement = this->ast->get<parser::ForStatement>(frame.statement);
+                        if (frame.next++ == 0) {
+                            this->governor.allocate(sizeof(Environment));
+                            frame.environment = std::make_shared<Environment>(this->environment);
+                            this->environment = frame.environment;
+                            if (statement.initializer) { this->execute(statement.initializer); }
+                        } else {
+                            this->governor.step(this->ast->token(statement.keyword));
+                        }
+
+                        if (Interpreter::is_truthy(this->evaluate(statement.condition).value())) {
+                            frames.push_back(GeneratorFrame{ statement.body, {}, this->environment, 0, std::nullopt });
+                        } else {
+                            frames.pop_back();
+                        }
+                        break;
+                    }
+                    case parser::StatementKind::FOR_IN: {
+                        const auto &statement = this->ast->get<parser::ForInStatement>(frame.statement);
+                        const auto &keyword   = this->ast->token(statement.keyword);
+                        if (!frame.iterable) {
+                            frame.iterable = this->iterable(statement);
+                        } else {
+                            this->governor.step(keyword);
+                        }
+
+                        auto value = this->resume(*frame.iterable->state, keyword);
+                        if (!value) {
+                            frames.pop_back();
+                            break;
+                        }
+
+                        const auto &name = this->ast->token(statement.name).lexeme;
+                        this->governor.allocate(sizeof(Environment) + variable_bytes + name.size());
+                        auto environment = std::make_shared<Environment>(this->environment);
+                        environment->define(name, *value);
+                        frames.push_back(GeneratorFrame{ statement.body, {}, std::move(environment), 0, std::nullopt });
+                        break;
+                    }
+                    case parser::StatementKind::YIELD: {
+                        auto value = this->evaluate(this->ast->get<parser::YieldStatement>(frame.statement).value);
+                        frames.pop_back();
+                        return value;
+                    }
+                    case parser::StatementKind::RETURN: {
+                        const auto &statement = this->ast->get<parser::ReturnStatement>(frame.statement);
+                        if (statement.expression) { this->evaluate(statement.expression); }
+                        frames.clear();
+                        break;
+                    }
+                    default:
+                        this->execute(frame.statement);
+                        frames.pop_back();
+                        break;
+                }
+            }
+        } catch (...) {
+            // A generator that failed is finished.
+            frames.clear();
+            throw;
+        }
+
+        return std::nullopt;
+    }
+
     types::Literal Interpreter::interpret_binary_minus(
-      const parser::BinaryExpression  &expression,
+      const tokenizer::Token          &op,
       const types::Literal::variant_t &left,
       const types::Literal::variant_t &right)
     {
-        Interpreter::assert_operand_types<double>(expression.op, left, right);
+        Interpreter::assert_operand_types<double>(op, left, right);
         const auto &[left_value, right_value] = variants::to_tuple<double>(left, right);
         return types::Literal(left_value - right_value);
     }
 
     types::Literal Interpreter::interpret_binary_plus(
-      parser::BinaryExpression        &expression,
+      const tokenizer::Token          &op,
       const types::Literal::variant_t &left,
       const types::Literal::variant_t &right)
     {
@@ -283,66 +690,66 @@ namespace tek::interpreter {
             const auto &[left_value, right_value] = variants::to_tuple<double>(left, right);
             return types::Literal(left_value + right_value);
         } else {
-            throw exceptions::RuntimeError(expression.op, "Operands must be both of type `string` or `number`");
+            throw exceptions::RuntimeError(op, "Operands must be both of type `string` or `number`");
         }
     }
 
     types::Literal Interpreter::interpret_binary_slash(
-      const parser::BinaryExpression  &expression,
+      const tokenizer::Token          &op,
       const types::Literal::variant_t &left,
       const types::Literal::variant_t &right)
     {
-        Interpreter::assert_operand_types<double>(expression.op, left, right);
+        Interpreter::assert_operand_types<double>(op, left, right);
         const auto &[left_value, right_value] = variants::to_tuple<double>(left, right);
         return types::Literal(left_value / right_value);
     }
 
     types::Literal Interpreter::interpret_binary_star(
-      const parser::BinaryExpression  &expression,
+      const tokenizer::Token          &op,
       const types::Literal::variant_t &left,
       const types::Literal::variant_t &right)
     {
-        Interpreter::assert_operand_types<double>(expression.op, left, right);
+        Interpreter::assert_operand_types<double>(op, left, right);
         const auto &[left_value, right_value] = variants::to_tuple<double>(left, right);
         return types::Literal(left_value * right_value);
     }
 
     types::Literal Interpreter::interpret_binary_greater(
-      const parser::BinaryExpression  &expression,
+      const tokenizer::Token          &op,
       const types::Literal::variant_t &left,
       const types::Literal::variant_t &right)
     {
-        Interpreter::assert_operand_types<double>(expression.op, left, right);
+        Interpreter::assert_operand_types<double>(op, left, right);
         const auto &[left_value, right_value] = variants::to_tuple<double>(left, right);
         return types::Literal(left_value > right_value);
     }
 
     types::Literal Interpreter::interpret_binary_greater_equal(
-      const parser::BinaryExpression  &expression,
+      const tokenizer::Token          &op,
       const types::Literal::variant_t &left,
       const types::Literal::variant_t &right)
     {
-        Interpreter::assert_operand_types<double>(expression.op, left, right);
+        Interpreter::assert_operand_types<double>(op, left, right);
         const auto &[left_value, right_value] = variants::to_tuple<double>(left, right);
         return types::Literal(left_value >= right_value);
     }
 
     types::Literal Interpreter::interpret_binary_less(
-      const parser::BinaryExpression  &expression,
+      const tokenizer::Token          &op,
       const types::Literal::variant_t &left,
       const types::Literal::variant_t &right)
     {
-        Interpreter::assert_operand_types<double>(expression.op, left, right);
+        Interpreter::assert_operand_types<double>(op, left, right);
         const auto &[left_value, right_value] = variants::to_tuple<double>(left, right);
         return types::Literal(left_value < right_value);
     }
 
     types::Literal Interpreter::interpret_binary_less_equal(
-      const parser::BinaryExpression  &expression,
+      const tokenizer::Token          &op,
       const types::Literal::variant_t &left,
       const types::Literal::variant_t &right)
     {
-        Interpreter::assert_operand_types<double>(expression.op, left, right);
+        Interpreter::assert_operand_types<double>(op, left, right);
         const auto &[left_value, right_value] = variants::to_tuple<double>(left, right);
         return types::Literal(left_value <= right_value);
     }
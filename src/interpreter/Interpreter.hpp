@@ -3,31 +3,76 @@
 
 #include "../exceptions/Exceptions.hpp"
 #include "../logger/Logger.hpp"
+#include "../parser/Ast.hpp"
 #include "../parser/Expressions.hpp"
 #include "../parser/Statements.hpp"
 #include "../utils/guard.hpp"
+#include "../utils/span.hpp"
 #include "../utils/traits.hpp"
 #include "../utils/variants.hpp"
 #include "Environment.hpp"
+#include "Generators.hpp"
+#include "Governor.hpp"
+#include "Tasks.hpp"
 
 #include <chrono>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string_view>
 
 struct Literal;
 
 namespace tek::interpreter {
-    class Interpreter
+    class Interpreter final
       : public parser::ExpressionVisitor<types::Literal>
       , public parser::StatementVisitor<void>
     {
       private:
-        using ExpressionPtr  = std::unique_ptr<parser::Expression>;
-        using StatementPtr   = std::unique_ptr<parser::Statement>;
+        using AstPtr         = std::shared_ptr<parser::Ast>;
         using EnvironmentPtr = std::shared_ptr<Environment>;
-        using StatementsVec  = std::vector<StatementPtr>;
+        using StatementsVec  = std::vector<parser::StatementId>;
+        using Statements     = utils::span<const parser::StatementId>;
+
+        // Only the interpreter makes interpreters for tasks.
+        struct Child
+        {
+        };
 
       public:
         Interpreter();
-        void interpret(const StatementsVec &statements);
+
+        // For a task spawned by `parent`, sharing its globals, output, names bound by the Resolver and limits.
+        Interpreter(Child, const Interpreter &parent);
+
+        // Runs `statements`, and returns once the tasks they spawned finished too. Tasks that failed without being
+        // awaited are reported like any other runtime error. If the statements fail, the run is cancelled so that
+        // tasks still running or waiting on a channel stop instead of being waited for forever.
+        void interpret(const AstPtr &ast, const StatementsVec &statements);
+
+        // Runs `statements` and leaves the tasks they spawned running, for input that comes a declaration or a line at
+        // a time, where a task may wait on a channel the rest of the input sends to. Errors are reported as by
+        // interpret(), false after one, wait_for_tasks() once the whole input ran.
+        bool run(const AstPtr &ast, const StatementsVec &statements);
+
+        // Returns once every task spawned so far finished, awaited or not, false if any of those nobody awaited failed.
+        // Their errors are reported as runtime errors.
+        bool wait_for_tasks();
+
+        // Cancels the run and returns once its tasks stopped. What they failed with is dropped, the error that made
+        // the run stop was reported already.
+        void cancel_tasks();
+
+        // Whether tasks spawned so far are still running, and reading the trees and the Resolver's results they were
+        // spawned with.
+        [[nodiscard]] bool tasks_running() const { return this->tasks.running(); }
+
+        // Has the Resolver's results added to a copy from now on, tasks already running keep reading the one they
+        // have.
+        void detach_locals();
+
+        // Runs `statements` with `globals` standing in for the interpreter's own, which are back in place afterwards.
+        void interpret(const AstPtr &ast, const StatementsVec &statements, const EnvironmentPtr &globals);
         void resolve(parser::Expression *expression, const size_t depth);
 
         [[nodiscard]] types::Literal visit_literal_expression(parser::LiteralExpression &expression) override;
@@ -38,6 +83,8 @@ namespace tek::interpreter {
         [[nodiscard]] types::Literal visit_assign_expression(parser::AssignExpression &expression) override;
         [[nodiscard]] types::Literal visit_logical_expression(parser::LogicalExpression &expression) override;
         [[nodiscard]] types::Literal visit_call_expression(parser::CallExpression &expression) override;
+        [[nodiscard]] types::Literal visit_spawn_expression(parser::SpawnExpression &expression) override;
+        [[nodiscard]] types::Literal visit_await_expression(parser::AwaitExpression &expression) override;
 
         void visit_print_statement(parser::PrintStatement &statement) override;
         void visit_expression_statement(parser::ExpressionStatement &statement) override;
@@ -48,59 +95,81 @@ namespace tek::interpreter {
         void visit_for_statement(parser::ForStatement &statement) override;
         void visit_function_statement(parser::FunctionStatement &statement) override;
         void visit_return_statement(parser::ReturnStatement &statement) override;
+        void visit_yield_statement(parser::YieldStatement &statement) override;
+        void visit_for_in_statement(parser::ForInStatement &statement) override;
 
-        void execute_block(const StatementsVec &statements, const EnvironmentPtr &environment);
+        // Runs `statements` out of `ast`, which may be another script's than the current one for function bodies.
+        void execute_block(const AstPtr &ast, const Statements statements, const EnvironmentPtr &environment);
 
         // Statement impl
       private:
         [[nodiscard]] static types::Literal
-          interpret_unary_minus(const parser::UnaryExpression &expression, const types::Literal::variant_t &right);
+          interpret_unary_minus(const tokenizer::Token &op, const types::Literal::variant_t &right);
 
         [[nodiscard]] static types::Literal interpret_binary_minus(
-          const parser::BinaryExpression  &expression,
+          const tokenizer::Token          &op,
           const types::Literal::variant_t &left,
           const types::Literal::variant_t &right);
 
         [[nodiscard]] static types::Literal interpret_binary_plus(
-          parser::BinaryExpression        &expression,
+          const tokenizer::Token          &op,
           const types::Literal::variant_t &left,
           const types::Literal::variant_t &right);
 
         [[nodiscard]] static types::Literal interpret_binary_slash(
-          const parser::BinaryExpression  &expression,
+          const tokenizer::Token          &op,
           const types::Literal::variant_t &left,
           const types::Literal::variant_t &right);
 
         [[nodiscard]] static types::Literal interpret_binary_star(
-          const parser::BinaryExpression  &expression,
+          const tokenizer::Token          &op,
           const types::Literal::variant_t &left,
           const types::Literal::variant_t &right);
 
         [[nodiscard]] static types::Literal interpret_binary_greater(
-          const parser::BinaryExpression  &expression,
+          const tokenizer::Token          &op,
           const types::Literal::variant_t &left,
           const types::Literal::variant_t &right);
 
         [[nodiscard]] static types::Literal interpret_binary_greater_equal(
-          const parser::BinaryExpression  &expression,
+          const tokenizer::Token          &op,
           const types::Literal::variant_t &left,
           const types::Literal::variant_t &right);
 
         [[nodiscard]] static types::Literal interpret_binary_less(
-          const parser::BinaryExpression  &expression,
+          const tokenizer::Token          &op,
           const types::Literal::variant_t &left,
           const types::Literal::variant_t &right);
 
         [[nodiscard]] static types::Literal interpret_binary_less_equal(
-          const parser::BinaryExpression  &expression,
+          const tokenizer::Token          &op,
           const types::Literal::variant_t &left,
           const types::Literal::variant_t &right);
 
         // Helpers
       private:
-        types::Literal evaluate(const ExpressionPtr &expression);
+        // Evaluates the callee and the arguments of `expression`, and checks that the one takes the others.
+        [[nodiscard]] types::Literal::CallablePtr
+          evaluate_call(parser::CallExpression &expression, std::vector<types::Literal> &arguments);
+
+        // Calls `function` as the call at `where`, reporting errors of native functions there.
+        types::Literal
+          invoke(types::Callable &function, std::vector<types::Literal> &arguments, const tokenizer::Token &where);
+
+        // Runs the body of `generator` up to its next `yield`, nothing once it finished.
+        [[nodiscard]] std::optional<types::Literal>
+          resume(GeneratorState &generator, const tokenizer::Token &where);
+
+        // The generator a `for (var x in ...)` runs over.
+        [[nodiscard]] types::Generator iterable(const parser::ForInStatement &statement);
 
-        void execute(const StatementPtr &statement);
+        types::Literal evaluate(const parser::ExpressionId expression);
+
+        void execute(const parser::StatementId statement);
+
+        // A token of the node, for the line of an error raised about it as a whole.
+        [[nodiscard]] tokenizer::Token site(parser::ExpressionId expression) const;
+        [[nodiscard]] tokenizer::Token site(const parser::StatementId statement) const;
 
         types::Literal lookup_variable(const tokenizer::Token &name, parser::Expression *expression);
 
@@ -116,9 +185,35 @@ namespace tek::interpreter {
       public:
         EnvironmentPtr globals = std::make_shared<Environment>();
 
+        // Where print statements write, a line at a time with its newline and one task at a time. The standard output
+        // if empty.
+        std::function<void(std::string_view)> output;
+
+        // Counts steps and allocations against the limits it was last reset to, none until then.
+        Governor governor;
+
       private:
-        EnvironmentPtr                                   environment = globals;
-        std::unordered_map<parser::Expression *, size_t> locals;
+        using Locals = std::unordered_map<parser::Expression *, size_t>;
+
+        // Swaps in the globals it loads.
+        friend class Snapshot;
+
+        // Runs calls on interpreters of its own, like tasks, and drains generators.
+        friend class Parallel;
+
+        EnvironmentPtr environment = globals;
+        AstPtr         ast;
+
+        // Shared with the interpreters of tasks, which only read it.
+        std::shared_ptr<Locals> locals = std::make_shared<Locals>();
+
+        Tasks tasks;
+
+        // Serializes print statements once there are tasks, shared with their interpreters.
+        std::shared_ptr<std::mutex> output_lock;
+
+        // Where the innermost call being made is, for natives that make calls in turn.
+        const tokenizer::Token *call_site = nullptr;
     };
 }// namespace tek::interpreter
 
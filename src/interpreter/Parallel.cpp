@@ -0,0 +1,156 @@
+#include "Parallel.hpp"
+
+#include "../utils/guard.hpp"
+#include "Environment.hpp"
+#include "Generators.hpp"
+#include "Interpreter.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace tek::interpreter {
+    namespace {
+        // The function an argument of a native stands for, checked to take a single argument.
+        types::Literal::CallablePtr element_function(types::Literal &value, const char *native)
+        {
+            auto function = value.as_callable();
+            if (!function || function->get_arity() != 1) {
+                throw exceptions::NativeError(fmt::format("{} takes a function of one argument.", native));
+            }
+            return function;
+        }
+
+        // What is left of the range, claimed a chunk at a time by the workers.
+        struct Claims
+        {
+            std::atomic<std::size_t> next{ 0 };
+            std::atomic<bool>        failed{ false };
+        };
+    }// namespace
+
+    std::vector<types::Literal> Parallel::call(
+      Interpreter                                       &interpreter,
+      types::Callable                                   &function,
+      const std::size_t                                  count,
+      const std::function<types::Literal(std::size_t)> &argument)
+    {
+        std::vector<types::Literal> results(count, types::Literal(nullptr));
+        if (count == 0) { return results; }
+
+        // Workers read the function's closure and the globals from other threads, like tasks.
+        function.share();
+        interpreter.globals->share();
+        if (!interpreter.output_lock) { interpreter.output_lock = std::make_shared<std::mutex>(); }
+
+        const auto where   = *interpreter.call_site;
+        const auto workers = std::min(Tasks::workers(), count);
+        interpreter.governor.allocate(workers * sizeof(Interpreter));
+
+        Claims                   claims;
+        std::vector<types::Task> tasks;
+        for (std::size_t worker = 0; worker < workers; ++worker) {
+            auto child = std::make_shared<Interpreter>(Interpreter::Child{}, interpreter);
+            tasks.push_back(interpreter.tasks.spawn([&, child]() {
+                // Chunks start at a single item, until one was timed.
+                std::size_t chunk = 1;
+                try {
+                    while (!claims.failed.load(std::memory_order_relaxed)) {
+                        const auto first = claims.next.fetch_add(chunk);
+                        if (first >= count) { break; }
+                        const auto last = std::min(count, first + chunk);
+
+                        const auto start = std::chrono::steady_clock::now();
+                        for (auto i = first; i < last; ++i) {
+                            std::vector<types::Literal> arguments{ argument(i) };
+                            results[i] = child->invoke(function, arguments, where);
+                            results[i].share();
+                        }
+                        const auto taken = std::chrono::steady_clock::now() - start;
+
+                        // Leaving a few chunks a worker for the end, so that the last ones even out.
+                        const auto per_item = std::max<std::chrono::nanoseconds::rep>(
+                          std::chrono::duration_cast<std::chrono::nanoseconds>(taken).count()
+                            / static_cast<std::chrono::nanoseconds::rep>(last - first),
+                          1);
+                        const auto fitting = static_cast<std::size_t>(
+                          std::chrono::duration_cast<std::chrono::nanoseconds>(chunk_time).count() / per_item);
+                        const auto fair = (count - std::min(count, last)) / (4 * workers);
+                        chunk           = std::max<std::size_t>(std::min(fitting, fair), 1);
+                    }
+                } catch (...) {
+                    claims.failed.store(true, std::memory_order_relaxed);
+                    throw;
+                }
+                return types::Literal(nullptr);
+            }));
+        }
+
+        // Every worker refers to what is on this stack, they are all waited for even once one of them failed.
+        std::exception_ptr error;
+        for (const auto &task : tasks) {
+            try {
+                static_cast<void>(Tasks::await(task));
+            } catch (...) {
+                if (!error) { error = std::current_exception(); }
+            }
+        }
+        if (error) { std::rethrow_exception(error); }
+
+        return results;
+    }
+
+    types::Literal Parallel::parallel_for(Interpreter &interpreter, std::vector<types::Literal> &arguments)
+    {
+        const auto from = arguments[0].value();
+        const auto to   = arguments[1].value();
+        if (!std::holds_alternative<double>(from) || !std::holds_alternative<double>(to)) {
+            throw exceptions::NativeError("parallel_for takes the bounds of the range as numbers.");
+        }
+
+        const auto first = std::get<double>(from);
+        const auto span  = std::get<double>(to) - first;
+        if (!std::isfinite(first) || !std::isfinite(span)) {
+            throw exceptions::NativeError("parallel_for takes the bounds of the range as finite numbers.");
+        }
+
+        const auto function = element_function(arguments[2], "parallel_for");
+        const auto count    = span > 0 ? static_cast<std::size_t>(std::ceil(span)) : 0;
+        static_cast<void>(Parallel::call(interpreter, *function, count, [first](const std::size_t i) {
+            return types::Literal(first + static_cast<double>(i));
+        }));
+        return types::Literal(nullptr);
+    }
+
+    types::Literal Parallel::parallel_map(Interpreter &interpreter, std::vector<types::Literal> &arguments)
+    {
+        const auto  iterable  = arguments[0].value();
+        const auto *generator = std::get_if<types::Generator>(&iterable);
+        if (!generator) { throw exceptions::NativeError("parallel_map takes a generator to map over."); }
+        const auto function = element_function(arguments[1], "parallel_map");
+
+        // The generator runs on this thread, only the calls are spread.
+        std::vector<types::Literal> items;
+        while (auto item = interpreter.resume(*generator->state, *interpreter.call_site)) {
+            item->share();
+            items.push_back(std::move(*item));
+        }
+
+        auto results = Parallel::call(
+          interpreter, *function, items.size(), [&items](const std::size_t i) { return items[i]; });
+        return types::Literal(types::Generator(std::make_shared<GeneratorState>(
+          std::deque<types::Literal>(std::make_move_iterator(results.begin()), std::make_move_iterator(results.end())))));
+    }
+
+    void define_parallel_natives(Environment &globals)
+    {
+        globals.define(
+          "parallel_for", types::Literal(types::NativeCallable("parallel_for", &Parallel::parallel_for, 3)));
+        globals.define(
+          "parallel_map", types::Literal(types::NativeCallable("parallel_map", &Parallel::parallel_map, 2)));
+    }
+}// namespace tek::interpreter
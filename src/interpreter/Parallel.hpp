@@ -0,0 +1,42 @@
+#ifndef TEK_PARALLEL_HPP
+#define TEK_PARALLEL_HPP
+
+#include "../types/Literal.hpp"
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace tek::interpreter {
+    class Environment;
+    class Interpreter;
+
+    // Calls of a function over a range of indices, spread over the task pool. A task per worker claims chunks of the
+    // range as it goes, sized from how long the items of its last chunk took, so that cheap items are claimed many at a
+    // time and expensive ones few, and every worker runs out of work at about the same time. Each worker makes its calls
+    // on an interpreter of its own, like a task.
+    class Parallel
+    {
+      public:
+        // Aimed at for a chunk, long enough that claiming and timing it are lost in the noise.
+        static constexpr std::chrono::microseconds chunk_time{ 200 };
+
+        // `function` called with argument(i) for every i below `count`, the results in order. The first error raised
+        // is rethrown once every worker stopped.
+        static std::vector<types::Literal> call(
+          Interpreter                                       &interpreter,
+          types::Callable                                   &function,
+          std::size_t                                        count,
+          const std::function<types::Literal(std::size_t)> &argument);
+
+        // parallel_for(from, to, fn) calls fn(i) for every integer i from `from` up to `to` excluded.
+        static types::Literal parallel_for(Interpreter &interpreter, std::vector<types::Literal> &arguments);
+
+        // parallel_map(generator, fn) drains the generator, then gives a generator over fn(x) for every x in order.
+        static types::Literal parallel_map(Interpreter &interpreter, std::vector<types::Literal> &arguments);
+    };
+
+    void define_parallel_natives(Environment &globals);
+}// namespace tek::interpreter
+
+#endif// TEK_PARALLEL_HPP
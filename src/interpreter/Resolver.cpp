@@ -1,30 +1,34 @@
 #include "Resolver.hpp"
 
+#include "../parser/Dispatch.hpp"
 #include <utility>
 
 namespace tek::interpreter {
 
-    Resolver::Resolver(Interpreter interpreter) : interpreter{ std::move(interpreter) } {}
+    Resolver::Resolver(Interpreter &interpreter, parser::Ast &ast) : interpreter{ interpreter }, ast{ ast } {}
 
     void Resolver::resolve(const StatementsVec &statements)
     {
-        for (const auto &statement : statements) { this->resolve(statement); }
+        this->resolve(Statements(statements.data(), statements.size()));
     }
 
     void Resolver::visit_var_expression(parser::VarExpression &expression)
     {
-        if (!this->scopes.empty() && !this->scopes.top().at(expression.name.lexeme)) {
-            logger::Logger::error(expression.name, "Can't read local variable in its own initializer.");
+        const auto &name = this->ast.token(expression.name);
+        if (!this->scopes.empty()) {
+            const auto it = this->scopes.top().find(name.lexeme);
+            if (it != this->scopes.top().end() && !it->second) {
+                logger::Logger::error(name, "Can't read local variable in its own initializer.");
+            }
         }
 
-        this->resolve_local(&expression, expression.name);
+        this->resolve_local(&expression, name);
     }
 
     void Resolver::visit_assign_expression(parser::AssignExpression &expression)
     {
         this->resolve(expression.value);
-        const auto name = expression.name;
-        this->resolve_local(&expression, name);
+        this->resolve_local(&expression, this->ast.token(expression.name));
     }
 
     void Resolver::visit_binary_expression(parser::BinaryExpression &expression)
@@ -37,9 +41,13 @@ namespace tek::interpreter {
     {
         this->resolve(expression.callee);
 
-        for (const auto &argument : expression.arguments) { this->resolve(argument); }
+        for (const auto &argument : this->ast.expressions(expression.arguments)) { this->resolve(argument); }
     }
 
+    void Resolver::visit_spawn_expression(parser::SpawnExpression &expression) { this->resolve(expression.call); }
+
+    void Resolver::visit_await_expression(parser::AwaitExpression &expression) { this->resolve(expression.task); }
+
     void Resolver::visit_grouping_expression(parser::GroupingExpression &expression)
     {
         this->resolve(expression.expression);
@@ -58,23 +66,25 @@ namespace tek::interpreter {
     void Resolver::visit_block_statement(parser::BlockStatement &statement)
     {
         this->begin_scope();
-        this->resolve(statement.statements);
+        this->resolve(this->ast.statements(statement.statements));
         this->end_scope();
     }
 
     void Resolver::visit_var_statement(parser::VarStatement &statement)
     {
-        this->declare(statement.name);
+        const auto &name = this->ast.token(statement.name);
+        this->declare(name);
 
-        if (statement.initializer != nullptr) { this->resolve(statement.initializer); }
+        if (statement.initializer) { this->resolve(statement.initializer); }
 
-        this->define(statement.name);
+        this->define(name);
     }
 
     void Resolver::visit_function_statement(parser::FunctionStatement &statement)
     {
-        this->declare(statement.name);
-        this->define(statement.name);
+        const auto &name = this->ast.token(statement.name);
+        this->declare(name);
+        this->define(name);
 
         this->resolve_function(statement, FunctionType::FUNCTION);
     }
@@ -88,7 +98,7 @@ namespace tek::interpreter {
     {
         this->resolve(statement.condition);
         this->resolve(statement.then_branch);
-        if (statement.else_branch != nullptr) { this->resolve(statement.else_branch); }
+        if (statement.else_branch) { this->resolve(statement.else_branch); }
     }
 
     void Resolver::visit_print_statement(parser::PrintStatement &statement) { this->resolve(statement.expression); }
@@ -96,12 +106,14 @@ namespace tek::interpreter {
     void Resolver::visit_return_statement(parser::ReturnStatement &statement)
     {
         if (this->current_function == FunctionType::NONE) {
-            logger::Logger::error(statement.keyword, "Can't return from top-level code");
+            logger::Logger::error(this->ast.token(statement.keyword), "Can't return from top-level code");
         }
 
-        if (statement.expression != nullptr) { this->resolve(statement.expression); }
+        if (statement.expression) { this->resolve(statement.expression); }
     }
 
+    void Resolver::visit_yield_statement(parser::YieldStatement &statement) { this->resolve(statement.value); }
+
     void Resolver::visit_while_statement(parser::WhileStatement &statement)
     {
         this->resolve(statement.condition);
@@ -110,18 +122,38 @@ namespace tek::interpreter {
 
     void Resolver::visit_for_statement(parser::ForStatement &statement)
     {
-        this->resolve(statement.initializer);
+        // The loop runs in an environment of its own, the body is a block holding the increment too.
+        this->begin_scope();
+        if (statement.initializer) { this->resolve(statement.initializer); }
         this->resolve(statement.condition);
         this->resolve(statement.body);
+        this->end_scope();
+    }
+
+    void Resolver::visit_for_in_statement(parser::ForInStatement &statement)
+    {
+        this->resolve(statement.iterable);
+
+        this->begin_scope();
+        const auto &name = this->ast.token(statement.name);
+        this->declare(name);
+        this->define(name);
+        this->resolve(statement.body);
+        this->end_scope();
     }
 
     void Resolver::begin_scope() { this->scopes.push(Scope{}); }
 
     void Resolver::end_scope() { this->scopes.pop(); }
 
-    void Resolver::resolve(const StatementPtr &statement) { statement->accept(*this); }
+    void Resolver::resolve(const Statements statements)
+    {
+        for (const auto &statement : statements) { this->resolve(statement); }
+    }
+
+    void Resolver::resolve(const parser::StatementId statement) { parser::dispatch(*this, this->ast, statement); }
 
-    void Resolver::resolve(const ExpressionPtr &statement) { statement->accept(*this); }
+    void Resolver::resolve(const parser::ExpressionId expression) { parser::dispatch(*this, this->ast, expression); }
 
     void Resolver::declare(const tokenizer::Token &name)
     {
@@ -146,11 +178,13 @@ namespace tek::interpreter {
 
     void Resolver::resolve_local(parser::Expression *expression, const tokenizer::Token &name)
     {
-        // This might not work because of how the iterators for the iterable stack are implemented
-        for (const auto &scope : this->scopes) {
-            if (const auto it = scope.find(name.lexeme); it != scope.end()) {
-                // This might not work because of the logic with the difference of ITs
-                this->interpreter.resolve(expression, this->scopes.size() - 1 - std::distance(it, scope.begin()));
+        // Innermost scope first, as Parser::resolve_local does, a name found in none of them is left to the globals.
+        std::size_t depth = 0;
+        for (auto scope = this->scopes.end(); scope != this->scopes.begin(); ++depth) {
+            --scope;
+            if (scope->find(name.lexeme) != scope->end()) {
+                this->interpreter.resolve(expression, depth);
+                return;
             }
         }
     }
@@ -162,12 +196,13 @@ namespace tek::interpreter {
 
         this->begin_scope();
 
-        for (const auto &param : function.parameters) {
-            this->declare(param);
-            this->define(param);
+        for (const auto &param : this->ast.tokens(function.parameters)) {
+            const auto &name = this->ast.token(param);
+            this->declare(name);
+            this->define(name);
         }
 
-        this->resolve(function.body);
+        this->resolve(this->ast.statements(function.body));
 
         this->end_scope();
         this->current_function = enclosing_function;
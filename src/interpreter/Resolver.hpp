@@ -1,27 +1,29 @@
 #ifndef TEK_RESOLVER_HPP
 #define TEK_RESOLVER_HPP
 
+#include "../parser/Ast.hpp"
 #include "../parser/Expressions.hpp"
 #include "../parser/Statements.hpp"
 #include "../tokenizer/Token.hpp"
 #include "../utils/iterable_stack.hpp"
+#include "../utils/span.hpp"
 #include "Interpreter.hpp"
 #include <stack>
 
 namespace tek::interpreter {
-    class Resolver
+    class Resolver final
       : public parser::ExpressionVisitor<void>
       , public parser::StatementVisitor<void>
     {
       private:
-        using StatementPtr  = std::unique_ptr<parser::Statement>;
-        using ExpressionPtr = std::unique_ptr<parser::Expression>;
-        using StatementsVec = std::vector<StatementPtr>;
+        using StatementsVec = std::vector<parser::StatementId>;
+        using Statements    = utils::span<const parser::StatementId>;
         using Scope         = std::unordered_map<std::string, bool>;
         using ScopesStack   = utils::iterable_stack<Scope>;
 
       public:
-        explicit Resolver(Interpreter interpreter);
+        // Resolutions are recorded in `interpreter`, which has to outlive the Resolver.
+        Resolver(Interpreter &interpreter, parser::Ast &ast);
         void resolve(const StatementsVec &statements);
 
         // Expressions
@@ -31,6 +33,8 @@ namespace tek::interpreter {
 
         void visit_binary_expression(parser::BinaryExpression &expression) override;
         void visit_call_expression(parser::CallExpression &expression) override;
+        void visit_spawn_expression(parser::SpawnExpression &expression) override;
+        void visit_await_expression(parser::AwaitExpression &expression) override;
         void visit_grouping_expression(parser::GroupingExpression &expression) override;
         void visit_literal_expression(parser::LiteralExpression &expression) override;
         void visit_logical_expression(parser::LogicalExpression &expression) override;
@@ -46,8 +50,10 @@ namespace tek::interpreter {
         void visit_if_statement(parser::IfStatement &statement) override;
         void visit_print_statement(parser::PrintStatement &statement) override;
         void visit_return_statement(parser::ReturnStatement &statement) override;
+        void visit_yield_statement(parser::YieldStatement &statement) override;
         void visit_while_statement(parser::WhileStatement &statement) override;
         void visit_for_statement(parser::ForStatement &statement) override;
+        void visit_for_in_statement(parser::ForInStatement &statement) override;
 
         // TODO: Move this
       private:
@@ -59,8 +65,9 @@ namespace tek::interpreter {
       private:
         void begin_scope();
         void end_scope();
-        void resolve(const StatementPtr &statement);
-        void resolve(const ExpressionPtr &statement);
+        void resolve(const Statements statements);
+        void resolve(const parser::StatementId statement);
+        void resolve(const parser::ExpressionId expression);
 
         void declare(const tokenizer::Token &name);
         void define(const tokenizer::Token &name);
@@ -69,7 +76,8 @@ namespace tek::interpreter {
         void resolve_function(const parser::FunctionStatement &function, const FunctionType &function_type);
 
       private:
-        Interpreter  interpreter;
+        Interpreter &interpreter;
+        parser::Ast &ast;
         ScopesStack  scopes;
         FunctionType current_function = FunctionType::NONE;
     };
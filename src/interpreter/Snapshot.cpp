@@ -0,0 +1,243 @@
+#include "Snapshot.hpp"
+
+#include "../parser/AstCache.hpp"
+#include "../utils/binary.hpp"
+#include "../utils/fs.hpp"
+#include <cstdint>
+#include <fmt/format.h>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace tek::interpreter {
+    namespace {
+        constexpr std::string_view magic          = "TEKS";
+        constexpr std::uint32_t    format_version = 1;
+
+        using EnvironmentPtr = std::shared_ptr<Environment>;
+        using AstPtr         = std::shared_ptr<parser::Ast>;
+
+        // Tags of the values, in the order of the alternatives of types::Literal.
+        enum class ValueTag : std::uint8_t {
+            NUMBER = 0,
+            STRING,
+            BOOLEAN,
+            NIL,
+            NATIVE,
+            FUNCTION,
+            TASK,
+            CHANNEL
+        };
+
+        // Environments and trees numbered in the order they are met, the globals first.
+        template<typename Pointer>
+        class Numbering
+        {
+          public:
+            std::uint32_t add(const Pointer &pointer)
+            {
+                const auto id          = static_cast<std::uint32_t>(this->order.size());
+                const auto [it, added] = this->ids.emplace(pointer.get(), id);
+                if (added) { this->order.push_back(pointer); }
+                return it->second;
+            }
+
+          public:
+            std::unordered_map<const typename Pointer::element_type *, std::uint32_t> ids;
+            std::vector<Pointer>                                                      order;
+        };
+    }// namespace
+
+    bool Snapshot::write(const std::filesystem::path &path, const Interpreter &interpreter)
+    {
+        if (!interpreter.locals->empty()) {
+            fmt::print(stderr, "Can't snapshot names bound by the Resolver pass, leave out --resolver\n");
+            return false;
+        }
+
+        Numbering<EnvironmentPtr> environments;
+        Numbering<AstPtr>         asts;
+        environments.add(interpreter.globals);
+
+        // Environments are numbered breadth first, every function met numbers its tree and its closure.
+        for (std::size_t i = 0; i < environments.order.size(); ++i) {
+            const auto environment = environments.order[i];
+            if (environment->enclosing) { environments.add(environment->enclosing); }
+
+            for (const auto &[name, value] : environment->variables) {
+                const auto variant = value.value();
+                if (const auto *function = std::get_if<types::TekFunction>(&variant)) {
+                    asts.add(function->ast);
+                    environments.add(function->closure);
+                } else if (std::holds_alternative<types::Task>(variant)) {
+                    fmt::print(stderr, "Can't snapshot tasks, keep what they returned instead\n");
+                    return false;
+                } else if (std::holds_alternative<types::Channel>(variant)) {
+                    fmt::print(stderr, "Can't snapshot channels, make them when the snapshot is run\n");
+                    return false;
+                } else if (std::holds_alternative<types::Generator>(variant)) {
+                    fmt::print(stderr, "Can't snapshot generators, call their functions when the snapshot is run\n");
+                    return false;
+                }
+            }
+        }
+
+        utils::ByteWriter writer;
+        writer.bytes.append(magic);
+        writer.put(format_version);
+
+        writer.put_varint(asts.order.size());
+        for (const auto &ast : asts.order) {
+            if (ast->deferred_body_count() != 0) {
+                fmt::print(stderr, "Can't snapshot functions whose bodies weren't parsed yet, pass --eager\n");
+                return false;
+            }
+            writer.put_string(parser::AstCache::serialize(parser::Program{ ast, {} }, {}));
+        }
+
+        writer.put_varint(environments.order.size());
+        for (const auto &environment : environments.order) {
+            const auto enclosing = environment->enclosing ? environments.ids.at(environment->enclosing.get()) + 1 : 0;
+            writer.put_varint(enclosing);
+            writer.put_varint(environment->variables.size());
+
+            for (const auto &[name, value] : environment->variables) {
+                writer.put_string(name);
+
+                const auto variant = value.value();
+                writer.put(static_cast<std::uint8_t>(variant.index()));
+                switch (static_cast<ValueTag>(variant.index())) {
+                    case ValueTag::NUMBER: writer.put(std::get<double>(variant)); break;
+                    case ValueTag::STRING: writer.put_string(std::get<std::string>(variant)); break;
+                    case ValueTag::BOOLEAN: writer.put(std::get<bool>(variant)); break;
+                    case ValueTag::NIL: break;
+                    case ValueTag::NATIVE: writer.put_string(std::get<types::NativeCallable>(variant).identifier); break;
+                    case ValueTag::FUNCTION: {
+                        const auto &function = std::get<types::TekFunction>(variant);
+                        writer.put_varint(asts.ids.at(function.ast.get()));
+                        writer.put_varint(*function.ast->index_of(*function.declaration));
+                        writer.put_varint(environments.ids.at(function.closure.get()));
+                        break;
+                    }
+                    case ValueTag::TASK:
+                    case ValueTag::CHANNEL: break;
+                }
+            }
+        }
+
+        if (!fs::write_file(path, writer.bytes)) {
+            fmt::print(stderr, "Unable to write snapshot {}\n", path.string());
+            return false;
+        }
+        return true;
+    }
+
+    bool Snapshot::load(const std::filesystem::path &path, Interpreter &interpreter)
+    {
+        std::error_code ec;
+        if (!std::filesystem::is_regular_file(path, ec)) { return false; }
+
+        const auto image = fs::read_file(path);
+        if (image.view().substr(0, magic.size()) != magic) { return false; }
+
+        utils::ByteReader reader(image.view().substr(magic.size()));
+        std::uint32_t     version = 0;
+        if (!reader.get(version) || version != format_version) { return false; }
+
+        std::uint64_t count = 0;
+        if (!reader.get_varint(count)) { return false; }
+
+        std::vector<AstPtr> asts;
+        for (std::uint64_t i = 0; i < count; ++i) {
+            std::string tree;
+            if (!reader.get_string(tree)) { return false; }
+
+            auto program = parser::AstCache::deserialize(tree, {});
+            if (!program) { return false; }
+            asts.push_back(std::move(program->ast));
+        }
+
+        // Every environment exists before any is filled in, variables may refer to ones further down.
+        if (!reader.get_varint(count) || count == 0) { return false; }
+        std::vector<EnvironmentPtr> environments;
+        for (std::uint64_t i = 0; i < count; ++i) { environments.push_back(std::make_shared<Environment>()); }
+
+        const auto get_id = [&](const std::size_t size) -> std::optional<std::size_t> {
+            std::uint64_t id = 0;
+            if (!reader.get_varint(id) || id >= size) { return std::nullopt; }
+            return static_cast<std::size_t>(id);
+        };
+
+        for (const auto &environment : environments) {
+            const auto enclosing = get_id(environments.size() + 1);
+            if (!enclosing) { return false; }
+            if (*enclosing != 0) { environment->enclosing = environments[*enclosing - 1]; }
+
+            std::uint64_t variables = 0;
+            if (!reader.get_varint(variables)) { return false; }
+
+            for (std::uint64_t i = 0; i < variables; ++i) {
+                std::string  name;
+                std::uint8_t tag = 0;
+                if (!reader.get_string(name) || !reader.get(tag)) { return false; }
+
+                std::optional<types::Literal::variant_t> value;
+                switch (static_cast<ValueTag>(tag)) {
+                    case ValueTag::NUMBER: {
+                        double number = 0;
+                        if (reader.get(number)) { value = number; }
+                        break;
+                    }
+                    case ValueTag::STRING: {
+                        std::string text;
+                        if (reader.get_string(text)) { value = std::move(text); }
+                        break;
+                    }
+                    case ValueTag::BOOLEAN: {
+                        bool boolean = false;
+                        if (reader.get(boolean)) { value = boolean; }
+                        break;
+                    }
+                    case ValueTag::NIL: value = nullptr; break;
+                    case ValueTag::NATIVE: {
+                        std::string identifier;
+                        if (!reader.get_string(identifier)) { break; }
+
+                        const auto native = interpreter.globals->variables.find(identifier);
+                        if (native == interpreter.globals->variables.end()) { break; }
+                        value = native->second.value();
+                        break;
+                    }
+                    case ValueTag::FUNCTION: {
+                        const auto    ast   = get_id(asts.size());
+                        std::uint64_t index = 0;
+                        if (!ast || !reader.get_varint(index) || index > parser::ExpressionId::max_index) { break; }
+
+                        const auto *declaration = asts[*ast]->find<parser::FunctionStatement>(
+                          static_cast<std::uint32_t>(index));
+                        const auto closure = get_id(environments.size());
+                        if (declaration == nullptr || !closure) { break; }
+
+                        value = types::TekFunction(asts[*ast], declaration, environments[*closure]);
+                        break;
+                    }
+                    case ValueTag::TASK:
+                    case ValueTag::CHANNEL: break;
+                }
+
+                if (!value) { return false; }
+                environment->variables.insert_or_assign(std::move(name), types::Literal(std::move(*value)));
+            }
+        }
+
+        if (!reader.at_end()) { return false; }
+
+        interpreter.globals     = environments.front();
+        interpreter.environment = interpreter.globals;
+        return true;
+    }
+}// namespace tek::interpreter
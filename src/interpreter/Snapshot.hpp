@@ -0,0 +1,25 @@
+#ifndef TEK_SNAPSHOT_HPP
+#define TEK_SNAPSHOT_HPP
+
+#include "Interpreter.hpp"
+#include <filesystem>
+
+namespace tek::interpreter {
+    // Image of the global state an Interpreter was left in by a prelude: every environment reachable from the globals,
+    // the functions they hold with their closures, and the trees those functions are declared in, stored as AstCache
+    // images. Loading it into a fresh Interpreter carries on from where the prelude stopped without running it again.
+    // Environments are shared and may refer to one another in cycles, they are written once each and linked by index.
+    class Snapshot
+    {
+      public:
+        // False, with the reason printed, if the state can't be saved: function bodies have to be parsed up front and
+        // names resolved while parsing, depths kept by the Interpreter are not part of the image.
+        [[nodiscard]] static bool write(const std::filesystem::path &path, const Interpreter &interpreter);
+
+        // Replaces the globals of `interpreter`, which shouldn't have run anything yet. Native functions are looked up
+        // by name among its own globals. False if the image is invalid or wasn't written by this build.
+        [[nodiscard]] static bool load(const std::filesystem::path &path, Interpreter &interpreter);
+    };
+}// namespace tek::interpreter
+
+#endif// TEK_SNAPSHOT_HPP
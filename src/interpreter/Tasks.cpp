@@ -0,0 +1,133 @@
+#include "Tasks.hpp"
+
+#include "../utils/guard.hpp"
+#include "../utils/work_stealing_pool.hpp"
+#include <chrono>
+#include <utility>
+
+namespace tek::interpreter {
+    namespace {
+        // How long a waiting thread that found nothing to run sleeps before it looks for work again.
+        constexpr auto help_interval = std::chrono::milliseconds(1);
+
+        utils::work_stealing_pool &scheduler()
+        {
+            static utils::work_stealing_pool pool;
+            return pool;
+        }
+
+        // Runs `state` unless another thread started it, returns whether it did.
+        bool start(TaskState &state)
+        {
+            if (state.started.exchange(true)) { return false; }
+
+            const auto run = std::move(state.run);
+            run();
+            return true;
+        }
+
+        // Runs queued tasks on the calling thread until `done`, which is checked under `mutex`.
+        template<typename Done>
+        void help_until(std::mutex &mutex, std::condition_variable &changed, Done done)
+        {
+            auto &pool = scheduler();
+            while (true) {
+                {
+                    std::lock_guard lock(mutex);
+                    if (done()) { return; }
+                }
+                if (pool.run_one()) { continue; }
+
+                std::unique_lock lock(mutex);
+                changed.wait_for(lock, help_interval, done);
+            }
+        }
+    }// namespace
+
+    Tasks::Tasks() : group{ std::make_shared<Group>() } {}
+
+    types::Task Tasks::spawn(std::function<types::Literal()> body) const
+    {
+        auto state = std::make_shared<TaskState>();
+        this->group->running.fetch_add(1);
+
+        // The task holds on to itself only while it runs, through whoever started it.
+        state->run = [weak = std::weak_ptr(state), group = this->group, body = std::move(body)]() {
+            const auto                    state = weak.lock();
+            std::optional<types::Literal> result;
+            std::exception_ptr            error;
+            try {
+                result = body();
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            {
+                std::lock_guard lock(state->mutex);
+                state->result = std::move(result);
+                state->error  = error;
+                state->done   = true;
+            }
+            state->finished.notify_all();
+
+            if (error) {
+                std::lock_guard lock(group->mutex);
+                group->failed.push_back(state);
+            }
+            if (group->running.fetch_sub(1) == 1) {
+                std::lock_guard lock(group->mutex);
+                group->idle.notify_all();
+            }
+        };
+
+        scheduler().submit([state]() { start(*state); });
+        return types::Task(std::move(state));
+    }
+
+    types::Literal Tasks::await(const types::Task &task)
+    {
+        auto &state = *task.state;
+        {
+            std::lock_guard lock(state.mutex);
+            state.awaited = true;
+        }
+        if (!start(state)) {
+            block([&]() {
+                std::unique_lock lock(state.mutex);
+                state.finished.wait(lock, [&]() { return state.done; });
+            });
+        }
+
+        std::lock_guard lock(state.mutex);
+        if (state.error) { std::rethrow_exception(state.error); }
+        return *state.result;
+    }
+
+    std::size_t Tasks::workers() { return scheduler().size(); }
+
+    std::vector<std::exception_ptr> Tasks::wait() const
+    {
+        help_until(this->group->mutex, this->group->idle, [this]() { return this->group->running.load() == 0; });
+
+        std::vector<std::shared_ptr<TaskState>> failed;
+        {
+            std::lock_guard lock(this->group->mutex);
+            failed.swap(this->group->failed);
+        }
+
+        std::vector<std::exception_ptr> errors;
+        for (const auto &state : failed) {
+            std::lock_guard lock(state->mutex);
+            if (!state->awaited) { errors.push_back(state->error); }
+        }
+        return errors;
+    }
+
+    void Tasks::block(const std::function<void()> &wait)
+    {
+        auto &pool = scheduler();
+        pool.block();
+        utils::ScopeGuard unblock([&]() { pool.unblock(); });
+        wait();
+    }
+}// namespace tek::interpreter
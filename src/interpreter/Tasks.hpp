@@ -0,0 +1,74 @@
+#ifndef TEK_TASKS_HPP
+#define TEK_TASKS_HPP
+
+#include "../types/Literal.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace tek::interpreter {
+    // What a task comes to, shared by the task and every handle to it.
+    struct TaskState
+    {
+        std::mutex                    mutex;
+        std::condition_variable       finished;
+        bool                          done = false;
+        std::optional<types::Literal> result;
+        std::exception_ptr            error;
+
+        // Whether anybody asked for the result, the error is theirs then.
+        bool awaited = false;
+
+        // The task itself, run by whoever sets `started` first: a worker, or a thread awaiting it before any did.
+        std::atomic<bool>     started{ false };
+        std::function<void()> run;
+    };
+
+    // The tasks spawned during a run, by the script or by tasks in turn. They all run on one work-stealing pool for
+    // the whole process, with a worker per hardware thread. Copies refer to the same tasks.
+    class Tasks
+    {
+      public:
+        Tasks();
+
+        [[nodiscard]] types::Task spawn(std::function<types::Literal()> body) const;
+
+        // The result of `task`, or the error it failed with rethrown. A task no thread started yet runs on the calling
+        // one, otherwise it waits as in block(). Other queued tasks aren't run meanwhile, one that parks on a channel
+        // would be stuck under the caller for as long as the caller waits, even for what only the caller sends later.
+        [[nodiscard]] static types::Literal await(const types::Task &task);
+
+        // Threads of the pool, one per hardware thread.
+        [[nodiscard]] static std::size_t workers();
+
+        // Whether any task spawned so far hasn't finished. Once none is left, none starts again but through the caller.
+        [[nodiscard]] bool running() const { return this->group->running.load() != 0; }
+
+        // Until every task spawned so far finished, awaited or not, running queued ones meanwhile. Returns the errors of the tasks that failed without
+        // being awaited, in the order they failed, each only once.
+        [[nodiscard]] std::vector<std::exception_ptr> wait() const;
+
+        // Runs `wait`, which blocks until another task or thread does something, see work_stealing_pool::block().
+        static void block(const std::function<void()> &wait);
+
+      private:
+        struct Group
+        {
+            std::atomic<std::size_t> running{ 0 };
+            std::mutex               mutex;
+            std::condition_variable  idle;
+
+            // Tasks that failed since the last wait(), guarded by `mutex`.
+            std::vector<std::shared_ptr<TaskState>> failed;
+        };
+
+        std::shared_ptr<Group> group;
+    };
+}// namespace tek::interpreter
+
+#endif// TEK_TASKS_HPP
@@ -2,12 +2,21 @@
 
 namespace tek::logger {
 
-    bool Logger::had_error         = false;
-    bool Logger::had_runtime_error = false;
+    namespace {
+        thread_local std::vector<std::string> *captured = nullptr;
+    }// namespace
+
+    std::atomic<bool> Logger::had_error{ false };
+    std::atomic<bool> Logger::had_runtime_error{ false };
 
     void Logger::report(const std::size_t line, const std::string &where, const std::string &message)
     {
-        fmt::print("line {} -> Error {} : {}\n", line, where, message);
+        auto text = fmt::format("line {} -> Error {} : {}\n", line, where, message);
+        if (captured) {
+            captured->push_back(std::move(text));
+        } else {
+            fmt::print("{}", text);
+        }
         Logger::had_error = true;
     }
 
@@ -22,7 +31,19 @@ namespace tek::logger {
 
     void Logger::runtime_error(const exceptions::RuntimeError &error)
     {
-        fmt::print("{}\n[line {} ]\n", error.message, error.op.line);
+        auto text = fmt::format("{}\n[line {} ]\n", error.message, error.op.line);
+        if (captured) {
+            captured->push_back(std::move(text));
+        } else {
+            fmt::print("{}", text);
+        }
         Logger::had_runtime_error = true;
     }
+
+    void Logger::capture(std::vector<std::string> *messages) { captured = messages; }
+
+    void Logger::print(const std::vector<std::string> &messages)
+    {
+        for (const auto &message : messages) { fmt::print("{}", message); }
+    }
 }// namespace tek::logger
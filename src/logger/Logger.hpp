@@ -3,21 +3,30 @@
 
 #include "../exceptions/Exceptions.hpp"
 #include "../tokenizer/Token.hpp"
+#include <atomic>
 #include <fmt/format.h>
 #include <string>
+#include <vector>
 
 namespace tek::logger {
     class Logger
     {
       public:
         // TODO: Do something about these maybe?
-        static bool had_error;
-        static bool had_runtime_error;
+        // Errors may be reported from several threads at once, see capture.
+        static std::atomic<bool> had_error;
+        static std::atomic<bool> had_runtime_error;
 
       public:
         static void report(const std::size_t line, const std::string &where, const std::string &message);
         static void error(const tokenizer::Token &token, const std::string &message);
         static void runtime_error(const exceptions::RuntimeError &error);
+
+        // While `messages` is set, errors and runtime errors reported on the calling thread are appended to it instead of
+        // being printed. Work done concurrently prints them afterwards with `print`, in an order that doesn't depend on
+        // timing.
+        static void capture(std::vector<std::string> *messages);
+        static void print(const std::vector<std::string> &messages);
     };
 }// namespace tek::logger
 
@@ -1,35 +1,119 @@
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
 #include <fmt/format.h>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
+#include "engine/Batch.hpp"
 #include "interpreter/Interpreter.hpp"
 #include "interpreter/Resolver.hpp"
+#include "interpreter/Snapshot.hpp"
 #include "logger/Logger.hpp"
+#include "parser/Ast.hpp"
+#include "parser/AstCache.hpp"
 #include "parser/Expressions.hpp"
 #include "parser/Parser.hpp"
+#include "parser/StatementStream.hpp"
+#include "server/Server.hpp"
+#include "tokenizer/ParallelTokenizer.hpp"
 #include "tokenizer/Tokenizer.hpp"
 #include "utils/fs.hpp"
+#include "utils/thread_pool.hpp"
 
 static tek::interpreter::Interpreter interpreter;
 
-void run(const std::string &source_code)
+// Names are resolved while parsing unless the separate Resolver pass is asked for with --resolver.
+static bool resolver_pass = false;
+
+// Function bodies are parsed on their first call unless --eager is given, or the Resolver pass needs them.
+static bool eager_parsing = false;
+
+// The parser pulls tokens as it goes unless --parallel-lex is given, then the whole source is scanned up front on
+// every hardware thread.
+static bool parallel_lexing = false;
+
+// Deferred function bodies are parsed ahead of their first call on every hardware thread with --parallel-parse, while
+// the top level is parsed and run.
+static bool parallel_parsing = false;
+
+// With --stream, a script is read, parsed and run a top-level declaration at a time, in memory that doesn't grow with
+// its length. Statements before a syntax error have run by the time it is reported.
+static bool streaming = false;
+
+// With --cache, the resolved tree of a script is saved to `<script>.tekc`, or into the directory given with
+// --cache-dir, and loaded instead of parsing the script again as long as it is unchanged. Function bodies are then
+// parsed up front. The Resolver pass keeps its results in the Interpreter, --resolver bypasses the cache.
+static bool                  caching = false;
+static std::filesystem::path cache_directory;
+
+// `--snapshot <image> prelude.tek` saves the globals the prelude leaves behind, with the functions they hold, and
+// `--from-snapshot <image> job.tek` starts the job from them instead of running the prelude first.
+static std::filesystem::path snapshot_out;
+static std::filesystem::path snapshot_in;
+
+// `--serve <socket>` runs the scripts clients send over a Unix domain socket on warm workers, starting from the
+// --from-snapshot globals if given. `--client <socket> script.tek` has one run there, exiting with its status.
+static std::filesystem::path serve_socket;
+static std::filesystem::path client_socket;
+
+// `--max-steps <count>` and `--max-alloc <bytes>` fail a run with a runtime error once it went through more loop
+// iterations and calls, or allocated more, see tek::interpreter::Limits. Runs are unlimited by default.
+// `--max-stack <bytes>` sets the heap recursion may use once the native stack runs low, 256 MB by default.
+static tek::interpreter::Limits limits;
+
+// With --batch, every argument names scripts to run in a fresh isolate each, on every hardware thread, see
+// tek::engine::Batch::expand. Their output is printed in the order they were given, each after a header line.
+static bool batch = false;
+
+// Nodes are added to `session` if given, after the ones already there, or else to a tree of their own.
+std::optional<tek::parser::Program> parse(
+  const std::string_view            source_code,
+  const bool                        defer_function_bodies,
+  std::shared_ptr<tek::parser::Ast> session = nullptr)
 {
-    tek::tokenizer::Tokenizer scanner(source_code);
-    const auto                tokens = scanner.tokenize();
+    tek::parser::Program program{ session ? std::move(session) : std::make_shared<tek::parser::Ast>(), {} };
+    auto                &ast     = *program.ast;
+    auto                 options = tek::parser::ParseOptions{ !resolver_pass, defer_function_bodies };
 
-    tek::parser::Parser parser(tokens);
-    auto                statements = parser.parse();
+    std::optional<tek::utils::thread_pool> body_pool;
+    if (parallel_parsing && defer_function_bodies) { options.body_pool = &body_pool.emplace(); }
+
+    std::optional<std::vector<tek::parser::StatementId>> statements;
+    if (parallel_lexing) {
+        const auto          tokens = tek::tokenizer::tokenize_parallel(source_code);
+        tek::parser::Parser parser(
+          tek::utils::span<const tek::tokenizer::Token>(tokens.data(), tokens.size()), source_code, ast, options);
+        statements = parser.parse();
+    } else {
+        tek::tokenizer::Tokenizer scanner(source_code);
+        tek::parser::Parser       parser(scanner, ast, options);
+        statements = parser.parse();
+    }
 
-    if (!statements) { return; }
+    if (!statements) { return std::nullopt; }
 
-    if (tek::logger::Logger::had_error) { return; }
+    if (tek::logger::Logger::had_error) { return std::nullopt; }
 
-    tek::interpreter::Resolver resolver(interpreter);
-    resolver.resolve(*statements);
+    if (resolver_pass) {
+        tek::interpreter::Resolver resolver(interpreter, ast);
+        resolver.resolve(*statements);
 
-    if (tek::logger::Logger::had_error) { return; }
+        if (tek::logger::Logger::had_error) { return std::nullopt; }
+    }
 
-    interpreter.interpret(*statements);
+    program.statements = std::move(*statements);
+    return program;
+}
+
+void execute(const tek::parser::Program &program)
+{
+    interpreter.interpret(program.ast, program.statements);
 
     if (tek::logger::Logger::had_runtime_error) {
         fmt::print("Runtime error\n");
@@ -37,33 +121,208 @@ void run(const std::string &source_code)
     }
 }
 
+void run(const std::string_view source_code, const bool defer_function_bodies)
+{
+    if (const auto program = parse(source_code, defer_function_bodies)) { execute(*program); }
+}
+
+void run_cached(const std::string &file_path, const std::string_view source_code)
+{
+    const auto cache_path = tek::parser::AstCache::path_for(file_path, cache_directory);
+
+    auto program = tek::parser::AstCache::load(cache_path, source_code);
+    if (!program) {
+        program = parse(source_code, false);
+        if (!program) { return; }
+        tek::parser::AstCache::store(cache_path, *program, source_code);
+    }
+
+    execute(*program);
+}
+
+// Every line is parsed into the same tree. Nodes stay where the functions declared on earlier lines and the Resolver's
+// results expect them, and a line adds a few nodes rather than a chunk for each kind of node it uses. An error is
+// reported and the session goes on with the next line.
 void run_prompt()
 {
-    std::string input;
+    auto                                           session = std::make_shared<tek::parser::Ast>();
+    std::vector<std::shared_ptr<tek::parser::Ast>> retired;
+    std::string                                    input;
     while (true) {
         fmt::print("> ");
         std::getline(std::cin, input);
 
         if (std::cin.fail() || std::cin.eof()) { break; }
 
-        run(input);
+        tek::logger::Logger::had_error         = false;
+        tek::logger::Logger::had_runtime_error = false;
+
+        // Tasks of earlier lines may still be running through the tree and the Resolver's results, which adding to
+        // could move under them. The line starts a tree of its own then, later ones are added to, and resolves into a
+        // copy of the results. The results are keyed by node, the tree left behind is kept so no later node takes the
+        // place of one of its own.
+        if (interpreter.tasks_running()) {
+            retired.push_back(std::move(session));
+            session = std::make_shared<tek::parser::Ast>();
+            interpreter.detach_locals();
+        }
+
+        // Deferred bodies would point into the line, which is overwritten by the next one.
+        const auto program = parse(input, false, session);
+        if (!program) { continue; }
+
+        // Tasks spawned on a line may wait on what later lines send them, they are only waited for once the session
+        // is over and a failed line leaves them running.
+        if (!interpreter.run(program->ast, program->statements)) { fmt::print("Runtime error\n"); }
     }
+
+    if (!interpreter.wait_for_tasks()) { fmt::print("Runtime error\n"); }
+}
+
+void run_stream(std::istream &input)
+{
+    // Like the prompt, tasks may wait on declarations further down the stream.
+    tek::parser::StatementStream stream(input);
+    while (const auto declaration = stream.next()) {
+        if (!interpreter.run(declaration->ast, { declaration->statement })) {
+            interpreter.cancel_tasks();
+            fmt::print("Runtime error\n");
+            std::exit(1);
+        }
+    }
+
+    if (!interpreter.wait_for_tasks()) {
+        fmt::print("Runtime error\n");
+        std::exit(1);
+    }
+}
+
+int run_batch(const std::vector<std::string_view> &arguments)
+{
+    const auto scripts = tek::engine::Batch::expand(arguments);
+
+    std::vector<std::string> failures;
+    const auto               ran = tek::engine::Batch::run(scripts, snapshot_in, limits, [&](const auto &result) {
+        fmt::print("==> {} <==\n{}", result.script.string(), result.output);
+        if (!result.errors.empty()) {
+            std::fflush(stdout);
+            fmt::print(stderr, "{}", result.errors);
+        }
+        if (result.status != 0) { failures.push_back(result.script.string()); }
+    });
+
+    if (!ran) {
+        fmt::print(stderr, "Invalid snapshot {}\n", snapshot_in.string());
+        return 1;
+    }
+
+    fmt::print("{} scripts, {} failed\n", scripts.size(), failures.size());
+    for (const auto &failure : failures) { fmt::print("  {}\n", failure); }
+    return failures.empty() ? 0 : 1;
 }
 
 void run_file(const std::string &file_path)
 {
+    if (streaming) {
+        std::ifstream file;
+        if (file_path != "-") {
+            file.open(file_path, std::ios::binary);
+            if (!file) { fmt::print(stderr, "No such file: {}", file_path); }
+        }
+        run_stream(file_path == "-" ? std::cin : file);
+
+        if (tek::logger::Logger::had_error) { exit(1); }
+        return;
+    }
+
     const auto source_code = tek::fs::read_file(std::filesystem::path(file_path));
-    run(source_code);
+
+    std::error_code ec;
+    if (caching && !resolver_pass && std::filesystem::is_regular_file(file_path, ec)) {
+        run_cached(file_path, source_code.view());
+    } else {
+        run(source_code.view(), !eager_parsing && !resolver_pass);
+    }
 
     if (tek::logger::Logger::had_error) { exit(1); }
 }
 
 int main(int argc, char **argv)
 {
-    if (argc < 2) {
+    std::vector<std::string_view> arguments(argv + 1, argv + argc);
+
+    while (!arguments.empty() && arguments.front().substr(0, 2) == "--") {
+        if (arguments.front() == "--resolver") {
+            resolver_pass = true;
+        } else if (arguments.front() == "--eager") {
+            eager_parsing = true;
+        } else if (arguments.front() == "--parallel-lex") {
+            parallel_lexing = true;
+        } else if (arguments.front() == "--parallel-parse") {
+            parallel_parsing = true;
+        } else if (arguments.front() == "--stream") {
+            streaming = true;
+        } else if (arguments.front() == "--cache") {
+            caching = true;
+        } else if (arguments.front() == "--cache-dir" && arguments.size() > 1) {
+            caching         = true;
+            cache_directory = arguments[1];
+            arguments.erase(arguments.begin());
+        } else if (arguments.front() == "--snapshot" && arguments.size() > 1) {
+            snapshot_out  = arguments[1];
+            eager_parsing = true;
+            arguments.erase(arguments.begin());
+        } else if (arguments.front() == "--from-snapshot" && arguments.size() > 1) {
+            snapshot_in = arguments[1];
+            arguments.erase(arguments.begin());
+        } else if (
+          (arguments.front() == "--max-steps" || arguments.front() == "--max-alloc"
+           || arguments.front() == "--max-stack")
+          && arguments.size() > 1) {
+            auto &limit = arguments.front() == "--max-steps"   ? limits.steps
+                          : arguments.front() == "--max-alloc" ? limits.allocated_bytes
+                                                               : limits.stack_bytes;
+
+            const auto value = arguments[1];
+            if (std::from_chars(value.data(), value.data() + value.size(), limit).ptr != value.data() + value.size()) {
+                fmt::print("Invalid limit {}\n", value);
+                return 1;
+            }
+            arguments.erase(arguments.begin());
+        } else if (arguments.front() == "--batch") {
+            batch = true;
+        } else if (arguments.front() == "--serve" && arguments.size() > 1) {
+            serve_socket = arguments[1];
+            arguments.erase(arguments.begin());
+        } else if (arguments.front() == "--client" && arguments.size() > 1) {
+            client_socket = arguments[1];
+            arguments.erase(arguments.begin());
+        } else {
+            fmt::print("Unknown option {}\n", arguments.front());
+            return 1;
+        }
+        arguments.erase(arguments.begin());
+    }
+
+    if (!serve_socket.empty()) { return tek::server::Server(serve_socket, snapshot_in, limits).serve(); }
+    if (!client_socket.empty()) {
+        return tek::server::request(client_socket, arguments.empty() ? "-" : std::string(arguments.front()));
+    }
+
+    if (batch) { return run_batch(arguments); }
+
+    if (!snapshot_in.empty() && !tek::interpreter::Snapshot::load(snapshot_in, interpreter)) {
+        fmt::print(stderr, "Invalid snapshot {}\n", snapshot_in.string());
+        return 1;
+    }
+
+    interpreter.governor.reset(limits);
+    if (arguments.empty()) {
         run_prompt();
     } else {
-        run_file(argv[1]);
+        run_file(std::string(arguments.front()));
     }
+
+    if (!snapshot_out.empty() && !tek::interpreter::Snapshot::write(snapshot_out, interpreter)) { return 1; }
     return 0;
 }
@@ -0,0 +1,90 @@
+#include "Ast.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace tek::parser {
+    DeferredBody::DeferredBody(
+      std::string_view   source,
+      std::size_t        line,
+      bool               resolve_names,
+      std::vector<Scope> scopes)
+      : source{ source }, line{ line }, resolve_names{ resolve_names }, scopes{ std::move(scopes) }
+    {}
+
+    TokenId Ast::add_token(const tokenizer::Token &token)
+    {
+        const auto id = Ast::checked_index(this->token_pool.size());
+        this->token_pool.emplace_back(token);
+        return id;
+    }
+
+    Ast::TokenRange Ast::add_tokens(const std::vector<TokenId> &tokens)
+    {
+        const auto first = Ast::checked_index(this->token_lists.size());
+        this->token_lists.insert(this->token_lists.end(), tokens.begin(), tokens.end());
+        return TokenRange{ first, static_cast<std::uint32_t>(tokens.size()) };
+    }
+
+    Ast::ExpressionRange Ast::add_expressions(const std::vector<ExpressionId> &expressions)
+    {
+        const auto first = Ast::checked_index(this->expression_lists.size());
+        this->expression_lists.insert(this->expression_lists.end(), expressions.begin(), expressions.end());
+        return ExpressionRange{ first, static_cast<std::uint32_t>(expressions.size()) };
+    }
+
+    Ast::StatementRange Ast::add_statements(const std::vector<StatementId> &statements)
+    {
+        const auto first = Ast::checked_index(this->statement_lists.size());
+        this->statement_lists.insert(this->statement_lists.end(), statements.begin(), statements.end());
+        return StatementRange{ first, static_cast<std::uint32_t>(statements.size()) };
+    }
+
+    std::uint32_t Ast::add_deferred_body(
+      std::string_view   source,
+      const std::size_t  line,
+      const bool         resolve_names,
+      std::vector<Scope> scopes)
+    {
+        const auto index = Ast::checked_index(this->deferred_bodies.size());
+        this->deferred_bodies.emplace_back(source, line, resolve_names, std::move(scopes));
+        return index;
+    }
+
+    const tokenizer::Token &Ast::token(const TokenId id) const { return this->token_pool[id]; }
+
+    tokenizer::Token &Ast::token(const TokenId id) { return this->token_pool[id]; }
+
+    std::size_t Ast::token_count() const { return this->token_pool.size(); }
+
+    utils::span<const TokenId> Ast::tokens(const TokenRange range) const
+    {
+        return { this->token_lists.data() + range.first, range.size };
+    }
+
+    utils::span<const ExpressionId> Ast::expressions(const ExpressionRange range) const
+    {
+        return { this->expression_lists.data() + range.first, range.size };
+    }
+
+    utils::span<const StatementId> Ast::statements(const StatementRange range) const
+    {
+        return { this->statement_lists.data() + range.first, range.size };
+    }
+
+    DeferredBody &Ast::deferred_body(const std::uint32_t index) { return this->deferred_bodies[index]; }
+
+    std::size_t Ast::deferred_body_count() const { return this->deferred_bodies.size(); }
+
+    std::size_t Ast::node_count() const
+    {
+        const auto count = [](const auto &...pools) { return (pools.size() + ...); };
+        return std::apply(count, this->expression_pools) + std::apply(count, this->statement_pools);
+    }
+
+    std::uint32_t Ast::checked_index(const std::size_t size)
+    {
+        if (size > ExpressionId::max_index) { throw std::length_error("Too many nodes of one kind in one script"); }
+        return static_cast<std::uint32_t>(size);
+    }
+}// namespace tek::parser
@@ -0,0 +1,205 @@
+#ifndef TEK_AST_HPP
+#define TEK_AST_HPP
+
+#include "../tokenizer/Token.hpp"
+#include "../utils/chunked_vector.hpp"
+#include "../utils/span.hpp"
+#include "Expressions.hpp"
+#include "NodeId.hpp"
+#include "Statements.hpp"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tek::parser {
+    class Ast;
+
+    // Names declared in a local scope, flagged once their declaration is complete.
+    using Scope = std::unordered_map<std::string, bool>;
+
+    // A function body that was only brace matched, it is parsed the first time the function is called.
+    struct DeferredBody
+    {
+        DeferredBody(std::string_view source, std::size_t line, bool resolve_names, std::vector<Scope> scopes);
+
+        // From just after the opening brace up to the closing one included, the source the Ast was parsed from has to
+        // outlive it.
+        std::string_view source;
+        std::size_t      line;
+
+        // Local scopes enclosing the body where it was met, innermost the function's own with its parameters.
+        bool               resolve_names;
+        std::vector<Scope> scopes;
+
+        // The body of a `fun*`, where `yield` is allowed.
+        bool generator = false;
+
+        // Functions nested in the body are deferred in turn, unless the body is parsed ahead of its first call.
+        bool defer_function_bodies = true;
+
+        // The body is parsed into an Ast of its own, so that nodes and lists of the enclosing one never move.
+        std::once_flag         parsed;
+        std::shared_ptr<Ast>   ast;
+        NodeRange<StatementId> statements;
+
+        // Errors found when the body is parsed on a worker, printed along with the others once parsing is over.
+        std::vector<std::string> diagnostics;
+    };
+
+    // Owns every node of a parsed program. Nodes of each kind are stored contiguously in their own pool and refer to
+    // their children, tokens and child lists by 32-bit indices into the pools, so the whole tree is released at once
+    // with the Ast, a chunk at a time. Nodes and tokens never move once added, spans over lists are only valid until
+    // the next list is added.
+    class Ast
+    {
+      public:
+        using ExpressionRange = NodeRange<ExpressionId>;
+        using StatementRange  = NodeRange<StatementId>;
+        using TokenRange      = NodeRange<TokenId>;
+
+      public:
+        template<typename Node, typename... Arguments>
+        [[nodiscard]] ExpressionId make_expression(Arguments &&...arguments)
+        {
+            return this->emplace<ExpressionId, Node>(std::forward<Arguments>(arguments)...);
+        }
+
+        template<typename Node, typename... Arguments>
+        [[nodiscard]] StatementId make_statement(Arguments &&...arguments)
+        {
+            return this->emplace<StatementId, Node>(std::forward<Arguments>(arguments)...);
+        }
+
+        [[nodiscard]] TokenId         add_token(const tokenizer::Token &token);
+        [[nodiscard]] TokenRange      add_tokens(const std::vector<TokenId> &tokens);
+        [[nodiscard]] ExpressionRange add_expressions(const std::vector<ExpressionId> &expressions);
+        [[nodiscard]] StatementRange  add_statements(const std::vector<StatementId> &statements);
+        [[nodiscard]] std::uint32_t   add_deferred_body(
+          std::string_view   source,
+          const std::size_t  line,
+          const bool         resolve_names,
+          std::vector<Scope> scopes);
+
+        template<typename Node>
+        [[nodiscard]] Node &get(const ExpressionId id)
+        {
+            auto &node = this->pool<Node>()[id.index()];
+            assert(node.kind == id.kind());
+            return node;
+        }
+
+        template<typename Node>
+        [[nodiscard]] Node &get(const StatementId id)
+        {
+            auto &node = this->pool<Node>()[id.index()];
+            assert(node.kind == id.kind());
+            return node;
+        }
+
+        // Where `node` is in its pool, nullopt if it isn't a node of this Ast.
+        template<typename Node>
+        [[nodiscard]] std::optional<std::uint32_t> index_of(const Node &node)
+        {
+            const auto index = this->pool<Node>().index_of(&node);
+            if (!index) { return std::nullopt; }
+            return static_cast<std::uint32_t>(*index);
+        }
+
+        // The node at `index` in its pool, nullptr past the end of it.
+        template<typename Node>
+        [[nodiscard]] Node *find(const std::uint32_t index)
+        {
+            auto &pool = this->pool<Node>();
+            return index < pool.size() ? &pool[index] : nullptr;
+        }
+
+        [[nodiscard]] const tokenizer::Token &token(const TokenId id) const;
+        [[nodiscard]] tokenizer::Token       &token(const TokenId id);
+        [[nodiscard]] std::size_t             token_count() const;
+
+        [[nodiscard]] utils::span<const TokenId>      tokens(const TokenRange range) const;
+        [[nodiscard]] utils::span<const ExpressionId> expressions(const ExpressionRange range) const;
+        [[nodiscard]] utils::span<const StatementId>  statements(const StatementRange range) const;
+
+        [[nodiscard]] DeferredBody &deferred_body(const std::uint32_t index);
+        [[nodiscard]] std::size_t   deferred_body_count() const;
+
+        [[nodiscard]] std::size_t node_count() const;
+
+      private:
+        // Reads and writes the pools wholesale.
+        friend class AstCache;
+
+        template<typename Node>
+        using Pool = utils::chunked_vector<Node>;
+
+        template<typename Node>
+        [[nodiscard]] Pool<Node> &pool()
+        {
+            if constexpr (std::is_base_of_v<Expression, Node>) {
+                return std::get<Pool<Node>>(this->expression_pools);
+            } else {
+                return std::get<Pool<Node>>(this->statement_pools);
+            }
+        }
+
+        // The id takes its kind from the node, so the two can't disagree.
+        template<typename Id, typename Node, typename... Arguments>
+        [[nodiscard]] Id emplace(Arguments &&...arguments)
+        {
+            auto      &pool  = this->pool<Node>();
+            const auto index = Ast::checked_index(pool.size());
+            return Id(pool.emplace_back(std::forward<Arguments>(arguments)...).kind, index);
+        }
+
+        [[nodiscard]] static std::uint32_t checked_index(const std::size_t size);
+
+      private:
+        std::tuple<
+          Pool<BinaryExpression>,
+          Pool<GroupingExpression>,
+          Pool<LiteralExpression>,
+          Pool<UnaryExpression>,
+          Pool<VarExpression>,
+          Pool<AssignExpression>,
+          Pool<LogicalExpression>,
+          Pool<CallExpression>,
+          Pool<SpawnExpression>,
+          Pool<AwaitExpression>>
+          expression_pools;
+
+        std::tuple<
+          Pool<PrintStatement>,
+          Pool<ExpressionStatement>,
+          Pool<VarStatement>,
+          Pool<BlockStatement>,
+          Pool<IfStatement>,
+          Pool<WhileStatement>,
+          Pool<ForStatement>,
+          Pool<FunctionStatement>,
+          Pool<ReturnStatement>,
+          Pool<YieldStatement>,
+          Pool<ForInStatement>>
+          statement_pools;
+
+        Pool<tokenizer::Token> token_pool;
+        Pool<DeferredBody>     deferred_bodies;
+
+        // Lists have to be contiguous, they are small ids and simply kept in vectors.
+        std::vector<TokenId>      token_lists;
+        std::vector<ExpressionId> expression_lists;
+        std::vector<StatementId>  statement_lists;
+    };
+}// namespace tek::parser
+
+#endif// TEK_AST_HPP
@@ -0,0 +1,468 @@
+#include "AstCache.hpp"
+
+#include "../utils/binary.hpp"
+#include "../utils/fs.hpp"
+#include "../utils/hash.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <fmt/format.h>
+#include <new>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace tek::parser {
+    namespace {
+        constexpr std::string_view magic          = "TEKC";
+        constexpr std::uint32_t    format_version = 2;
+
+        // Sizes of the nodes copied as raw bytes and the number of kinds and token types, so that images written
+        // before any of them changed are a miss. Fields swapped or retyped in place keep the size, those still need
+        // `format_version` bumped.
+        template<typename... Nodes>
+        [[nodiscard]] constexpr std::uint64_t layout_stamp()
+        {
+            std::uint64_t value = 0xcbf29ce484222325;
+            for (const std::uint64_t field :
+                 { std::uint64_t{ sizeof(Nodes) }...,
+                   std::uint64_t{ alignof(Nodes) }...,
+                   std::uint64_t{ static_cast<std::uint8_t>(ExpressionKind::COUNT) },
+                   std::uint64_t{ static_cast<std::uint8_t>(StatementKind::COUNT) },
+                   std::uint64_t{ static_cast<std::uint8_t>(tokenizer::TokenType::COUNT) } }) {
+                value ^= field;
+                value *= 0x100000001b3;
+            }
+            return value;
+        }
+
+        constexpr std::uint64_t layout = layout_stamp<
+          BinaryExpression,
+          GroupingExpression,
+          UnaryExpression,
+          VarExpression,
+          AssignExpression,
+          LogicalExpression,
+          CallExpression,
+          SpawnExpression,
+          AwaitExpression,
+          PrintStatement,
+          ExpressionStatement,
+          VarStatement,
+          BlockStatement,
+          IfStatement,
+          WhileStatement,
+          ForStatement,
+          FunctionStatement,
+          ReturnStatement,
+          YieldStatement,
+          ForInStatement>();
+
+        using utils::ByteReader;
+        using utils::ByteWriter;
+
+        // Only numbers, strings, booleans and nil are ever parsed, callables only exist at runtime.
+        void put_literal(ByteWriter &writer, const types::Literal &literal)
+        {
+            const auto value = literal.value();
+            writer.put(static_cast<std::uint8_t>(value.index()));
+
+            if (const auto *number = std::get_if<double>(&value)) {
+                writer.put(*number);
+            } else if (const auto *text = std::get_if<std::string>(&value)) {
+                writer.put_string(*text);
+            } else if (const auto *boolean = std::get_if<bool>(&value)) {
+                writer.put(*boolean);
+            } else {
+                assert(std::holds_alternative<std::nullptr_t>(value));
+            }
+        }
+
+        [[nodiscard]] std::optional<types::Literal::variant_t> get_literal(ByteReader &reader)
+        {
+            std::uint8_t index = 0;
+            if (!reader.get(index)) { return std::nullopt; }
+
+            switch (index) {
+                case 0: {
+                    double number = 0;
+                    if (!reader.get(number)) { return std::nullopt; }
+                    return number;
+                }
+                case 1: {
+                    std::string text;
+                    if (!reader.get_string(text)) { return std::nullopt; }
+                    return text;
+                }
+                case 2: {
+                    bool boolean = false;
+                    if (!reader.get(boolean)) { return std::nullopt; }
+                    return boolean;
+                }
+                case 3: return nullptr;
+                default: return std::nullopt;
+            }
+        }
+
+        // Where the previous token was, tokens are mostly added in source order.
+        struct Position
+        {
+            std::uint64_t line   = 0;
+            std::uint64_t offset = 0;
+        };
+
+        void put_token(ByteWriter &writer, const tokenizer::Token &token, Position &previous)
+        {
+            writer.put(static_cast<std::uint8_t>(token.type));
+            writer.put_string(token.lexeme);
+            put_literal(writer, token.literal);
+            writer.put_delta(token.line, previous.line);
+            writer.put_delta(token.offset, previous.offset);
+        }
+
+        [[nodiscard]] std::optional<tokenizer::Token> get_token(ByteReader &reader, Position &previous)
+        {
+            std::uint8_t  type = 0;
+            std::string   lexeme;
+            std::uint64_t line   = 0;
+            std::uint64_t offset = 0;
+
+            if (!reader.get(type) || type >= static_cast<std::uint8_t>(tokenizer::TokenType::COUNT)) {
+                return std::nullopt;
+            }
+            if (!reader.get_string(lexeme)) { return std::nullopt; }
+
+            auto literal = get_literal(reader);
+            if (!literal || !reader.get_delta(line, previous.line) || !reader.get_delta(offset, previous.offset)) {
+                return std::nullopt;
+            }
+
+            return tokenizer::Token(
+              static_cast<tokenizer::TokenType>(type), std::move(lexeme), std::move(*literal), line, offset);
+        }
+
+        template<typename Node>
+        void put_pool(ByteWriter &writer, const utils::chunked_vector<Node> &pool)
+        {
+            writer.put_varint(pool.size());
+            for (std::size_t i = 0; i < pool.size(); ++i) {
+                if constexpr (std::is_same_v<Node, LiteralExpression>) {
+                    put_literal(writer, pool[i].literal);
+                } else {
+                    writer.put(pool[i]);
+                }
+            }
+        }
+
+        template<typename Node>
+        [[nodiscard]] bool get_pool(ByteReader &reader, utils::chunked_vector<Node> &pool)
+        {
+            std::uint64_t size = 0;
+            if (!reader.get_varint(size)) { return false; }
+
+            for (std::uint64_t i = 0; i < size; ++i) {
+                if constexpr (std::is_same_v<Node, LiteralExpression>) {
+                    auto literal = get_literal(reader);
+                    if (!literal) { return false; }
+                    pool.emplace_back(std::move(*literal));
+                } else {
+                    // Nodes other than literals are plain ids and ranges, copied back as they were written.
+                    static_assert(std::is_trivially_copyable_v<Node>);
+                    alignas(Node) std::byte storage[sizeof(Node)];
+                    if (!reader.get_bytes(storage, sizeof(Node))) { return false; }
+                    pool.emplace_back(*std::launder(reinterpret_cast<const Node *>(storage)));
+                }
+            }
+            return true;
+        }
+
+        // Pool and list sizes of a loaded Ast, every id and range in it has to fall within them. Nodes are copied back
+        // as raw bytes and hashing only the source doesn't rule out an image cut or overwritten just right, which
+        // would otherwise have the Interpreter index anywhere.
+        struct Bounds
+        {
+            std::array<std::size_t, static_cast<std::size_t>(ExpressionKind::COUNT)> expressions{};
+            std::array<std::size_t, static_cast<std::size_t>(StatementKind::COUNT)>  statements{};
+            std::size_t                                                              tokens           = 0;
+            std::size_t                                                              token_lists      = 0;
+            std::size_t                                                              expression_lists = 0;
+            std::size_t                                                              statement_lists  = 0;
+
+            [[nodiscard]] bool expression(const ExpressionId id) const
+            {
+                const auto kind = static_cast<std::size_t>(id.kind());
+                return kind < this->expressions.size() && id.index() < this->expressions[kind];
+            }
+
+            [[nodiscard]] bool statement(const StatementId id) const
+            {
+                const auto kind = static_cast<std::size_t>(id.kind());
+                return kind < this->statements.size() && id.index() < this->statements[kind];
+            }
+
+            // Children that may be left out, like an else branch.
+            [[nodiscard]] bool optional(const ExpressionId id) const { return !id || this->expression(id); }
+            [[nodiscard]] bool optional(const StatementId id) const { return !id || this->statement(id); }
+
+            [[nodiscard]] bool token(const TokenId id) const { return id < this->tokens; }
+
+            [[nodiscard]] static bool within(const std::uint64_t first, const std::uint64_t size, const std::size_t end)
+            {
+                return first <= end && size <= end - first;
+            }
+
+            [[nodiscard]] bool range(const NodeRange<TokenId> range) const
+            {
+                return Bounds::within(range.first, range.size, this->token_lists);
+            }
+
+            [[nodiscard]] bool range(const NodeRange<ExpressionId> range) const
+            {
+                return Bounds::within(range.first, range.size, this->expression_lists);
+            }
+
+            [[nodiscard]] bool range(const NodeRange<StatementId> range) const
+            {
+                return Bounds::within(range.first, range.size, this->statement_lists);
+            }
+
+            [[nodiscard]] bool node(const BinaryExpression &node) const
+            {
+                return this->expression(node.left) && this->token(node.op) && this->expression(node.right);
+            }
+
+            [[nodiscard]] bool node(const GroupingExpression &node) const { return this->expression(node.expression); }
+            [[nodiscard]] bool node(const LiteralExpression &) const { return true; }
+
+            [[nodiscard]] bool node(const UnaryExpression &node) const
+            {
+                return this->token(node.op) && this->expression(node.right);
+            }
+
+            [[nodiscard]] bool node(const VarExpression &node) const { return this->token(node.name); }
+
+            [[nodiscard]] bool node(const AssignExpression &node) const
+            {
+                return this->token(node.name) && this->expression(node.value);
+            }
+
+            [[nodiscard]] bool node(const LogicalExpression &node) const
+            {
+                return this->expression(node.left) && this->token(node.op) && this->expression(node.right);
+            }
+
+            [[nodiscard]] bool node(const CallExpression &node) const
+            {
+                return this->expression(node.callee) && this->token(node.paren) && this->range(node.arguments);
+            }
+
+            [[nodiscard]] bool node(const SpawnExpression &node) const
+            {
+                return this->token(node.keyword) && this->expression(node.call);
+            }
+
+            [[nodiscard]] bool node(const AwaitExpression &node) const
+            {
+                return this->token(node.keyword) && this->expression(node.task);
+            }
+
+            [[nodiscard]] bool node(const PrintStatement &node) const { return this->expression(node.expression); }
+            [[nodiscard]] bool node(const ExpressionStatement &node) const { return this->expression(node.expression); }
+
+            [[nodiscard]] bool node(const VarStatement &node) const
+            {
+                return this->token(node.name) && this->optional(node.initializer);
+            }
+
+            [[nodiscard]] bool node(const BlockStatement &node) const { return this->range(node.statements); }
+
+            [[nodiscard]] bool node(const IfStatement &node) const
+            {
+                return this->expression(node.condition) && this->statement(node.then_branch)
+                    && this->optional(node.else_branch);
+            }
+
+            [[nodiscard]] bool node(const WhileStatement &node) const
+            {
+                return this->token(node.keyword) && this->expression(node.condition) && this->statement(node.body);
+            }
+
+            [[nodiscard]] bool node(const ForStatement &node) const
+            {
+                return this->token(node.keyword) && this->optional(node.initializer)
+                    && this->expression(node.condition) && this->statement(node.body);
+            }
+
+            // Deferred bodies aren't part of the image.
+            [[nodiscard]] bool node(const FunctionStatement &node) const
+            {
+                return this->token(node.name) && this->range(node.parameters) && this->range(node.body)
+                    && !node.is_deferred();
+            }
+
+            [[nodiscard]] bool node(const ReturnStatement &node) const
+            {
+                return this->token(node.keyword) && this->optional(node.expression);
+            }
+
+            [[nodiscard]] bool node(const YieldStatement &node) const
+            {
+                return this->token(node.keyword) && this->expression(node.value);
+            }
+
+            [[nodiscard]] bool node(const ForInStatement &node) const
+            {
+                return this->token(node.keyword) && this->token(node.name) && this->expression(node.iterable)
+                    && this->statement(node.body);
+            }
+
+            // Pools are laid out in the order of the kinds, each node has to carry the kind of its pool.
+            template<typename Node>
+            [[nodiscard]] bool pool(const utils::chunked_vector<Node> &pool, const std::size_t kind) const
+            {
+                for (std::size_t i = 0; i < pool.size(); ++i) {
+                    if (static_cast<std::size_t>(pool[i].kind) != kind || !this->node(pool[i])) { return false; }
+                }
+                return true;
+            }
+        };
+    }// namespace
+
+    std::string AstCache::serialize(const Program &program, const std::string_view source)
+    {
+        const auto &ast = *program.ast;
+        assert(ast.deferred_bodies.empty());
+
+        ByteWriter writer;
+        writer.bytes.append(magic);
+        writer.put(format_version);
+        writer.put(layout);
+        writer.put(utils::fnv1a(source));
+        writer.put<std::uint64_t>(source.size());
+
+        ByteWriter body;
+        Position   position;
+        body.put_varint(ast.token_pool.size());
+        for (std::size_t i = 0; i < ast.token_pool.size(); ++i) { put_token(body, ast.token_pool[i], position); }
+
+        std::apply([&](const auto &...pools) { (put_pool(body, pools), ...); }, ast.expression_pools);
+        std::apply([&](const auto &...pools) { (put_pool(body, pools), ...); }, ast.statement_pools);
+
+        body.put_vector(ast.token_lists);
+        body.put_vector(ast.expression_lists);
+        body.put_vector(ast.statement_lists);
+        body.put_vector(program.statements);
+
+        writer.put(utils::fnv1a(body.bytes));
+        writer.bytes.append(body.bytes);
+        return std::move(writer.bytes);
+    }
+
+    std::optional<Program> AstCache::deserialize(const std::string_view image, const std::string_view source)
+    {
+        if (image.substr(0, magic.size()) != magic) { return std::nullopt; }
+
+        ByteReader    reader(image.substr(magic.size()));
+        std::uint32_t version     = 0;
+        std::uint64_t stamp       = 0;
+        std::uint64_t source_hash = 0;
+        std::uint64_t source_size = 0;
+
+        if (!reader.get(version) || version != format_version) { return std::nullopt; }
+        if (!reader.get(stamp) || stamp != layout) { return std::nullopt; }
+        if (!reader.get(source_hash) || !reader.get(source_size)) { return std::nullopt; }
+        if (source_size != source.size() || source_hash != utils::fnv1a(source)) { return std::nullopt; }
+
+        // Depths found by name resolution can't be told right from wrong without resolving again, an image that was
+        // damaged on disk has to be caught by its checksum instead.
+        std::uint64_t checksum = 0;
+        if (!reader.get(checksum) || checksum != utils::fnv1a(reader.rest())) { return std::nullopt; }
+
+        Program program{ std::make_shared<Ast>(), {} };
+        auto   &ast = *program.ast;
+
+        Position      position;
+        std::uint64_t token_count = 0;
+        if (!reader.get_varint(token_count)) { return std::nullopt; }
+        for (std::uint64_t i = 0; i < token_count; ++i) {
+            auto token = get_token(reader, position);
+            if (!token) { return std::nullopt; }
+            ast.token_pool.emplace_back(std::move(*token));
+        }
+
+        const auto get_pools = [&](auto &...pools) { return (get_pool(reader, pools) && ...); };
+        if (!std::apply(get_pools, ast.expression_pools) || !std::apply(get_pools, ast.statement_pools)) {
+            return std::nullopt;
+        }
+
+        if (!reader.get_vector(ast.token_lists) || !reader.get_vector(ast.expression_lists)
+            || !reader.get_vector(ast.statement_lists) || !reader.get_vector(program.statements)) {
+            return std::nullopt;
+        }
+
+        if (!reader.at_end() || !AstCache::validate(program)) { return std::nullopt; }
+        return program;
+    }
+
+    bool AstCache::validate(const Program &program)
+    {
+        const auto &ast = *program.ast;
+
+        Bounds bounds;
+        bounds.tokens           = ast.token_pool.size();
+        bounds.token_lists      = ast.token_lists.size();
+        bounds.expression_lists = ast.expression_lists.size();
+        bounds.statement_lists  = ast.statement_lists.size();
+        std::apply([&](const auto &...pools) { bounds.expressions = { pools.size()... }; }, ast.expression_pools);
+        std::apply([&](const auto &...pools) { bounds.statements = { pools.size()... }; }, ast.statement_pools);
+
+        const auto pools_valid = [&](const auto &...pools) {
+            std::size_t kind = 0;
+            return (bounds.pool(pools, kind++) && ...);
+        };
+        if (!std::apply(pools_valid, ast.expression_pools) || !std::apply(pools_valid, ast.statement_pools)) {
+            return false;
+        }
+
+        const auto tokens_valid      = [&](const TokenId id) { return bounds.token(id); };
+        const auto expressions_valid = [&](const ExpressionId id) { return bounds.expression(id); };
+        const auto statements_valid  = [&](const StatementId id) { return bounds.statement(id); };
+
+        return std::all_of(ast.token_lists.begin(), ast.token_lists.end(), tokens_valid)
+            && std::all_of(ast.expression_lists.begin(), ast.expression_lists.end(), expressions_valid)
+            && std::all_of(ast.statement_lists.begin(), ast.statement_lists.end(), statements_valid)
+            && std::all_of(program.statements.begin(), program.statements.end(), statements_valid);
+    }
+
+    std::filesystem::path
+      AstCache::path_for(const std::filesystem::path &script, const std::filesystem::path &directory)
+    {
+        if (directory.empty()) { return std::filesystem::path(script.string() + ".tekc"); }
+
+        std::error_code ec;
+        const auto      absolute = std::filesystem::absolute(script, ec);
+        const auto      name     = fmt::format(
+          "{}-{:016x}.tekc", script.filename().string(), utils::fnv1a((ec ? script : absolute).string()));
+        return directory / name;
+    }
+
+    std::optional<Program> AstCache::load(const std::filesystem::path &path, const std::string_view source)
+    {
+        std::error_code ec;
+        if (!std::filesystem::is_regular_file(path, ec)) { return std::nullopt; }
+
+        const auto image = fs::read_file(path);
+        return AstCache::deserialize(image.view(), source);
+    }
+
+    void AstCache::store(const std::filesystem::path &path, const Program &program, const std::string_view source)
+    {
+        std::error_code ec;
+        if (path.has_parent_path()) { std::filesystem::create_directories(path.parent_path(), ec); }
+
+        [[maybe_unused]] const auto written = fs::write_file(path, AstCache::serialize(program, source));
+    }
+}// namespace tek::parser
@@ -0,0 +1,50 @@
+#ifndef TEK_AST_CACHE_HPP
+#define TEK_AST_CACHE_HPP
+
+#include "Ast.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tek::parser {
+    // A parsed and resolved script, ready to be run.
+    struct Program
+    {
+        std::shared_ptr<Ast>     ast;
+        std::vector<StatementId> statements;
+    };
+
+    // Binary image of a resolved Ast, so that running an unchanged script again skips scanning, parsing and name
+    // resolution. Node pools are written as they are laid out in memory and read back with a copy per node, tokens
+    // and literals field by field. An image is only loaded with the node layouts it was written with, for the very
+    // source it was parsed from by hash and size, and with every id and range in bounds, anything else is a miss.
+    class AstCache
+    {
+      public:
+        // Names have to be resolved while parsing and no function body deferred, neither depths kept by the
+        // Interpreter nor source text are part of the image.
+        [[nodiscard]] static std::string serialize(const Program &program, std::string_view source);
+
+        // Nullopt if `image` wasn't written with these node layouts for `source`, is truncated or points out of bounds.
+        [[nodiscard]] static std::optional<Program> deserialize(std::string_view image, std::string_view source);
+
+        // `<script>.tekc` next to the script, or named after its absolute path inside `directory` if not empty.
+        [[nodiscard]] static std::filesystem::path
+          path_for(const std::filesystem::path &script, const std::filesystem::path &directory);
+
+        [[nodiscard]] static std::optional<Program> load(const std::filesystem::path &path, std::string_view source);
+
+        // Failing to write is not an error, the script just isn't cached.
+        static void store(const std::filesystem::path &path, const Program &program, std::string_view source);
+
+      private:
+        // Whether every id and range of a loaded `program` points into its Ast.
+        [[nodiscard]] static bool validate(const Program &program);
+    };
+}// namespace tek::parser
+
+#endif// TEK_AST_CACHE_HPP
@@ -1,30 +1,66 @@
 #include "AstPrinter.hpp"
 
+#include "Dispatch.hpp"
+
 namespace tek::parser {
-    std::string AstPrinter::print(AstPrinter::ExpressionPtr expression) { return expression->accept(*this); }
+    AstPrinter::AstPrinter(Ast &ast) : ast{ ast } {}
+
+    std::string AstPrinter::print(const ExpressionId expression) { return dispatch(*this, this->ast, expression); }
 
     std::string AstPrinter::visit_binary_expression(BinaryExpression &expression)
     {
-        return this->parenthesize(expression.op.lexeme, { expression.left.get(), expression.right.get() });
+        return this->parenthesize(this->ast.token(expression.op).lexeme, { expression.left, expression.right });
     }
 
     std::string AstPrinter::visit_grouping_expression(GroupingExpression &expression)
     {
-        return this->parenthesize("group", { expression.expression.get() });
+        return this->parenthesize("group", { expression.expression });
     }
 
     std::string AstPrinter::visit_literal_expression(LiteralExpression &expression) { return expression.literal.str(); }
 
     std::string AstPrinter::visit_unary_expression(UnaryExpression &expression)
     {
-        return this->parenthesize(expression.op.lexeme, { expression.right.get() });
+        return this->parenthesize(this->ast.token(expression.op).lexeme, { expression.right });
+    }
+
+    std::string AstPrinter::visit_var_expression(VarExpression &expression)
+    {
+        return this->ast.token(expression.name).lexeme;
+    }
+
+    std::string AstPrinter::visit_assign_expression(AssignExpression &expression)
+    {
+        return this->parenthesize("= " + this->ast.token(expression.name).lexeme, { expression.value });
+    }
+
+    std::string AstPrinter::visit_logical_expression(LogicalExpression &expression)
+    {
+        return this->parenthesize(this->ast.token(expression.op).lexeme, { expression.left, expression.right });
+    }
+
+    std::string AstPrinter::visit_call_expression(CallExpression &expression)
+    {
+        std::vector<ExpressionId> operands{ expression.callee };
+        for (const auto &argument : this->ast.expressions(expression.arguments)) { operands.push_back(argument); }
+        return this->parenthesize("call", operands);
+    }
+
+    std::string AstPrinter::visit_spawn_expression(SpawnExpression &expression)
+    {
+        return this->parenthesize("spawn", { expression.call });
+    }
+
+    std::string AstPrinter::visit_await_expression(AwaitExpression &expression)
+    {
+        return this->parenthesize("await", { expression.task });
     }
 
-    std::string AstPrinter::parenthesize(const std::string &name, const std::vector<Expression *> &expressions)
+    std::string AstPrinter::parenthesize(const std::string &name, const std::vector<ExpressionId> &expressions)
     {
         std::stringstream ss;
 
-        for (const auto &expression : expressions) { ss << " " << expression->accept(*this); }
+        for (const auto &expression : expressions) { ss << " " << this->print(expression); }
 
         return fmt::format("({}{})", name, ss.str());
     }
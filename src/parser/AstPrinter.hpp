@@ -1,6 +1,7 @@
 #ifndef AstPrinter_HPP
 #define AstPrinter_HPP
 
+#include "Ast.hpp"
 #include "Expressions.hpp"
 #include <memory>
 #include <sstream>
@@ -8,21 +9,29 @@
 #include <vector>
 
 namespace tek::parser {
-    class AstPrinter : public ExpressionVisitor<std::string>
+    class AstPrinter final : public ExpressionVisitor<std::string>
     {
-      private:
-        using ExpressionPtr = std::unique_ptr<Expression>;
-
       public:
-        std::string print(ExpressionPtr expression);
+        explicit AstPrinter(Ast &ast);
+
+        std::string print(const ExpressionId expression);
 
         [[nodiscard]] std::string visit_binary_expression(BinaryExpression &expression) override;
         [[nodiscard]] std::string visit_grouping_expression(GroupingExpression &expression) override;
         [[nodiscard]] std::string visit_literal_expression(LiteralExpression &expression) override;
         [[nodiscard]] std::string visit_unary_expression(UnaryExpression &expression) override;
+        [[nodiscard]] std::string visit_var_expression(VarExpression &expression) override;
+        [[nodiscard]] std::string visit_assign_expression(AssignExpression &expression) override;
+        [[nodiscard]] std::string visit_logical_expression(LogicalExpression &expression) override;
+        [[nodiscard]] std::string visit_call_expression(CallExpression &expression) override;
+        [[nodiscard]] std::string visit_spawn_expression(SpawnExpression &expression) override;
+        [[nodiscard]] std::string visit_await_expression(AwaitExpression &expression) override;
+
+      private:
+        std::string parenthesize(const std::string &name, const std::vector<ExpressionId> &expressions);
 
       private:
-        std::string parenthesize(const std::string &name, const std::vector<Expression *> &expressions);
+        Ast &ast;
     };
 }// namespace tek::parser
 
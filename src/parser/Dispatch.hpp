@@ -0,0 +1,74 @@
+#ifndef TEK_DISPATCH_HPP
+#define TEK_DISPATCH_HPP
+
+#include "Ast.hpp"
+#include <cassert>
+#include <stdexcept>
+
+namespace tek::parser {
+    // Calls the visit_* handler of `visitor` matching the kind of the node `id` refers to. The handler is picked by a
+    // switch rather than through a vtable, so for a final visitor the call is direct and can be inlined.
+    template<typename Visitor>
+    decltype(auto) dispatch(Visitor &visitor, Ast &ast, const ExpressionId id)
+    {
+        switch (id.kind()) {
+            case ExpressionKind::BINARY:
+                return visitor.visit_binary_expression(ast.get<BinaryExpression>(id));
+            case ExpressionKind::GROUPING:
+                return visitor.visit_grouping_expression(ast.get<GroupingExpression>(id));
+            case ExpressionKind::LITERAL:
+                return visitor.visit_literal_expression(ast.get<LiteralExpression>(id));
+            case ExpressionKind::UNARY:
+                return visitor.visit_unary_expression(ast.get<UnaryExpression>(id));
+            case ExpressionKind::VAR:
+                return visitor.visit_var_expression(ast.get<VarExpression>(id));
+            case ExpressionKind::ASSIGN:
+                return visitor.visit_assign_expression(ast.get<AssignExpression>(id));
+            case ExpressionKind::LOGICAL:
+                return visitor.visit_logical_expression(ast.get<LogicalExpression>(id));
+            case ExpressionKind::CALL:
+                return visitor.visit_call_expression(ast.get<CallExpression>(id));
+            case ExpressionKind::SPAWN:
+                return visitor.visit_spawn_expression(ast.get<SpawnExpression>(id));
+            case ExpressionKind::AWAIT:
+                return visitor.visit_await_expression(ast.get<AwaitExpression>(id));
+            default:
+                assert(0 && "Unreachable");
+                throw std::out_of_range("Invalid expression id");
+        }
+    }
+
+    template<typename Visitor>
+    decltype(auto) dispatch(Visitor &visitor, Ast &ast, const StatementId id)
+    {
+        switch (id.kind()) {
+            case StatementKind::PRINT:
+                return visitor.visit_print_statement(ast.get<PrintStatement>(id));
+            case StatementKind::EXPRESSION:
+                return visitor.visit_expression_statement(ast.get<ExpressionStatement>(id));
+            case StatementKind::VAR:
+                return visitor.visit_var_statement(ast.get<VarStatement>(id));
+            case StatementKind::BLOCK:
+                return visitor.visit_block_statement(ast.get<BlockStatement>(id));
+            case StatementKind::IF:
+                return visitor.visit_if_statement(ast.get<IfStatement>(id));
+            case StatementKind::WHILE:
+                return visitor.visit_while_statement(ast.get<WhileStatement>(id));
+            case StatementKind::FOR:
+                return visitor.visit_for_statement(ast.get<ForStatement>(id));
+            case StatementKind::FUNCTION:
+                return visitor.visit_function_statement(ast.get<FunctionStatement>(id));
+            case StatementKind::RETURN:
+                return visitor.visit_return_statement(ast.get<ReturnStatement>(id));
+            case StatementKind::YIELD:
+                return visitor.visit_yield_statement(ast.get<YieldStatement>(id));
+            case StatementKind::FOR_IN:
+                return visitor.visit_for_in_statement(ast.get<ForInStatement>(id));
+            default:
+                assert(0 && "Unreachable");
+                throw std::out_of_range("Invalid statement id");
+        }
+    }
+}// namespace tek::parser
+
+#endif// TEK_DISPATCH_HPP
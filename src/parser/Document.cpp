@@ -0,0 +1,235 @@
+#include "Document.hpp"
+
+#include "../tokenizer/ParallelTokenizer.hpp"
+#include "../tokenizer/Tokenizer.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <utility>
+
+namespace tek::parser {
+    namespace {
+        [[nodiscard]] std::ptrdiff_t difference(const std::size_t lhs, const std::size_t rhs)
+        {
+            return static_cast<std::ptrdiff_t>(lhs) - static_cast<std::ptrdiff_t>(rhs);
+        }
+
+        [[nodiscard]] std::size_t shifted(const std::size_t value, const std::ptrdiff_t delta)
+        {
+            return static_cast<std::size_t>(static_cast<std::ptrdiff_t>(value) + delta);
+        }
+    }// namespace
+
+    Document::Document(std::string source, const ParseOptions options)
+      : text{ std::move(source) }, options{ options.resolve_names, false }
+    {
+        this->token_stream = tokenizer::tokenize_parallel(this->text);
+        this->parse_all();
+    }
+
+    void Document::apply(const TextEdit &edit)
+    {
+        assert(edit.offset + edit.removed <= this->text.size());
+        this->text.replace(edit.offset, edit.removed, edit.inserted);
+
+        this->reparse(this->rescan(edit));
+
+        if (this->tree->node_count() - this->live_nodes > std::max(this->live_nodes, min_garbage_nodes)) {
+            this->parse_all();
+        }
+    }
+
+    std::string_view Document::source() const { return this->text; }
+
+    const std::vector<tokenizer::Token> &Document::tokens() const { return this->token_stream; }
+
+    const std::shared_ptr<Ast> &Document::ast() const { return this->tree; }
+
+    std::optional<std::vector<StatementId>> Document::statements() const
+    {
+        std::vector<StatementId> out;
+        out.reserve(this->declarations.size());
+        for (const auto &declaration : this->declarations) {
+            if (!declaration.statement) { return std::nullopt; }
+            out.push_back(declaration.statement);
+        }
+
+        return out;
+    }
+
+    Document::Rescan Document::rescan(const TextEdit &edit)
+    {
+        auto &tokens = this->token_stream;
+
+        // Scanning resumes at the start of the last token before the edit, the edit may extend it, or further back if
+        // the scan of the token before it looked at the edited text. Scanning looks at most two characters past the
+        // end of a token, for the fraction of a number. At the start of a token the state of the tokenizer is only its
+        // offset and line, tokens carry the line they end on though.
+        const auto after = std::lower_bound(
+          tokens.begin(), tokens.end(), edit.offset, [](const tokenizer::Token &token, const std::size_t offset) {
+              return token.offset < offset;
+          });
+        auto first = static_cast<std::size_t>(std::distance(tokens.begin(), after));
+        while (first > 1 && tokens[first - 2].offset + tokens[first - 2].lexeme.size() + 2 > edit.offset) { --first; }
+
+        std::size_t offset = 0;
+        std::size_t line   = 1;
+        if (first > 0) {
+            --first;
+            const auto &lexeme = tokens[first].lexeme;
+            offset             = tokens[first].offset;
+            line = tokens[first].line - static_cast<std::size_t>(std::count(lexeme.begin(), lexeme.end(), '\n'));
+        }
+
+        const auto old_edit_end = edit.offset + edit.removed;
+        const auto new_edit_end = edit.offset + edit.inserted.size();
+        const auto offset_delta = difference(edit.inserted.size(), edit.removed);
+
+        // Past the edit, the scan is back in step as soon as it starts a token where the previous scan started one,
+        // everything after is the same but for the position. The old ENDOF token always matches the new one.
+        tokenizer::Tokenizer          tokenizer(this->text, line, offset);
+        std::vector<tokenizer::Token> fresh;
+        auto                          old_end = first;
+        std::ptrdiff_t                line_delta;
+        while (true) {
+            auto token = tokenizer.next_token();
+            if (token.offset >= new_edit_end) {
+                while (tokens[old_end].offset < old_edit_end
+                       || shifted(tokens[old_end].offset, offset_delta) < token.offset) {
+                    ++old_end;
+                }
+                if (shifted(tokens[old_end].offset, offset_delta) == token.offset) {
+                    line_delta = difference(token.line, tokens[old_end].line);
+                    break;
+                }
+            }
+            fresh.push_back(std::move(token));
+        }
+
+        // Splice the fresh tokens in, then move the ones after to where they are now.
+        const auto replaced = old_end - first;
+        if (fresh.size() < replaced) {
+            tokens.erase(
+              tokens.begin() + static_cast<std::ptrdiff_t>(first + fresh.size()),
+              tokens.begin() + static_cast<std::ptrdiff_t>(old_end));
+        } else {
+            tokens.insert(
+              tokens.begin() + static_cast<std::ptrdiff_t>(old_end), fresh.size() - replaced, tokenizer::Token());
+        }
+        std::move(fresh.begin(), fresh.end(), tokens.begin() + static_cast<std::ptrdiff_t>(first));
+
+        const auto fresh_end = first + fresh.size();
+        for (auto i = fresh_end; i < tokens.size(); ++i) {
+            tokens[i].offset = shifted(tokens[i].offset, offset_delta);
+            tokens[i].line   = shifted(tokens[i].line, line_delta);
+        }
+
+        return Rescan{ first, old_end, fresh_end, offset_delta, line_delta };
+    }
+
+    void Document::reparse(const Rescan &rescan)
+    {
+        auto &declarations = this->declarations;
+
+        // Parsing a declaration looks one token past its end, for an 'else' for example, so the one ending right
+        // before the first rescanned token is parsed again too.
+        const auto first = static_cast<std::size_t>(std::distance(
+          declarations.begin(),
+          std::partition_point(declarations.begin(), declarations.end(), [&rescan](const Declaration &declaration) {
+              return declaration.first_token + declaration.token_count < rescan.first;
+          })));
+
+        std::size_t start = 0;
+        if (first < declarations.size()) {
+            start = declarations[first].first_token;
+        } else if (first > 0) {
+            start = declarations[first - 1].first_token + declarations[first - 1].token_count;
+        }
+
+        // Declarations after the rescanned tokens are kept, if parsing comes back to the start of one of them.
+        const auto token_delta = difference(rescan.fresh_end, rescan.old_end);
+        const auto moved_start = [&](const std::size_t index) {
+            return shifted(declarations[index].first_token, token_delta);
+        };
+
+        const auto &tokens = this->token_stream;
+        Parser      parser(
+          utils::span<const tokenizer::Token>(tokens.data() + start, tokens.size() - start),
+          this->text,
+          *this->tree,
+          this->options);
+
+        std::vector<Declaration> parsed;
+        auto                     kept = first;
+        while (true) {
+            if (parser.is_at_end()) {
+                kept = declarations.size();
+                break;
+            }
+
+            const auto position = start + parser.position();
+            if (position >= rescan.fresh_end) {
+                while (kept < declarations.size()
+                       && (declarations[kept].first_token < rescan.old_end || moved_start(kept) < position)) {
+                    ++kept;
+                }
+                if (kept < declarations.size() && moved_start(kept) == position) { break; }
+            }
+
+            parsed.push_back(this->parse_declaration(parser, start));
+        }
+
+        // Kept declarations move along with their tokens, the copies in the Ast included.
+        for (auto i = kept; i < declarations.size(); ++i) {
+            auto &declaration       = declarations[i];
+            declaration.first_token = moved_start(i);
+            for (auto id = declaration.first_ast_token; id < declaration.end_ast_token; ++id) {
+                auto &token  = this->tree->token(id);
+                token.offset = shifted(token.offset, rescan.offset_delta);
+                token.line   = shifted(token.line, rescan.line_delta);
+            }
+        }
+
+        for (auto i = first; i < kept; ++i) { this->live_nodes -= declarations[i].node_count; }
+        for (const auto &declaration : parsed) { this->live_nodes += declaration.node_count; }
+
+        const auto replaced = declarations.begin() + static_cast<std::ptrdiff_t>(first);
+        declarations.erase(replaced, declarations.begin() + static_cast<std::ptrdiff_t>(kept));
+        declarations.insert(
+          declarations.begin() + static_cast<std::ptrdiff_t>(first),
+          std::make_move_iterator(parsed.begin()),
+          std::make_move_iterator(parsed.end()));
+    }
+
+    void Document::parse_all()
+    {
+        this->tree       = std::make_shared<Ast>();
+        this->live_nodes = 0;
+        this->declarations.clear();
+
+        Parser parser(
+          utils::span<const tokenizer::Token>(this->token_stream.data(), this->token_stream.size()),
+          this->text,
+          *this->tree,
+          this->options);
+        while (!parser.is_at_end()) {
+            this->declarations.push_back(this->parse_declaration(parser, 0));
+            this->live_nodes += this->declarations.back().node_count;
+        }
+    }
+
+    Document::Declaration Document::parse_declaration(Parser &parser, const std::size_t first_token)
+    {
+        Declaration declaration{};
+        declaration.first_token     = first_token + parser.position();
+        declaration.first_ast_token = static_cast<TokenId>(this->tree->token_count());
+
+        const auto nodes      = this->tree->node_count();
+        declaration.statement = parser.parse_declaration().value_or(StatementId());
+
+        declaration.token_count   = first_token + parser.position() - declaration.first_token;
+        declaration.end_ast_token = static_cast<TokenId>(this->tree->token_count());
+        declaration.node_count    = this->tree->node_count() - nodes;
+        return declaration;
+    }
+}// namespace tek::parser
@@ -0,0 +1,88 @@
+#ifndef TEK_DOCUMENT_HPP
+#define TEK_DOCUMENT_HPP
+
+#include "../tokenizer/Token.hpp"
+#include "Ast.hpp"
+#include "Parser.hpp"
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tek::parser {
+    // Replaces the `removed` characters at `offset` by `inserted`.
+    struct TextEdit
+    {
+        std::size_t offset;
+        std::size_t removed;
+        std::string inserted;
+    };
+
+    // A script kept scanned and parsed while it is being edited. An edit is rescanned from the last token before it
+    // until the scan is back in step with the previous one, then only the top-level declarations around the rescanned
+    // tokens are parsed again. Every other declaration keeps its tokens and nodes.
+    class Document
+    {
+      public:
+        // Function bodies are never deferred, the source they would be sliced from changes with every edit.
+        explicit Document(std::string source, const ParseOptions options = ParseOptions{ true, false });
+
+        void apply(const TextEdit &edit);
+
+        [[nodiscard]] std::string_view                     source() const;
+        [[nodiscard]] const std::vector<tokenizer::Token> &tokens() const;
+        [[nodiscard]] const std::shared_ptr<Ast>          &ast() const;
+
+        // The top-level statements in source order, nullopt as long as any of them has errors.
+        [[nodiscard]] std::optional<std::vector<StatementId>> statements() const;
+
+      private:
+        struct Declaration
+        {
+            // Where the declaration is in the token stream.
+            std::size_t first_token;
+            std::size_t token_count;
+
+            // The tokens the parser copied into the Ast, they are added in order so they are a run of its pool.
+            TokenId     first_ast_token;
+            TokenId     end_ast_token;
+            std::size_t node_count;
+
+            // Absent if the declaration has errors.
+            StatementId statement;
+        };
+
+        // The tokens an edit replaced, [first, old_end) of the previous stream became [first, fresh_end). The ones
+        // after moved by the deltas.
+        struct Rescan
+        {
+            std::size_t    first;
+            std::size_t    old_end;
+            std::size_t    fresh_end;
+            std::ptrdiff_t offset_delta;
+            std::ptrdiff_t line_delta;
+        };
+
+        [[nodiscard]] Rescan rescan(const TextEdit &edit);
+        void                 reparse(const Rescan &rescan);
+        void                 parse_all();
+
+        [[nodiscard]] Declaration parse_declaration(Parser &parser, const std::size_t first_token);
+
+      private:
+        // Nodes of replaced declarations are only released when the Ast is rebuilt, once there are more of them than
+        // of live ones.
+        static constexpr std::size_t min_garbage_nodes = 64 * 1024;
+
+        std::string                   text;
+        ParseOptions                  options;
+        std::vector<tokenizer::Token> token_stream;
+        std::shared_ptr<Ast>          tree;
+        std::vector<Declaration>      declarations;
+        std::size_t                   live_nodes = 0;
+    };
+}// namespace tek::parser
+
+#endif// TEK_DOCUMENT_HPP
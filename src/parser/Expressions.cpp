@@ -2,138 +2,43 @@
 
 #include <utility>
 namespace tek::parser {
-    BinaryExpression::BinaryExpression(
-      Expression::ExpressionPtr left,
-      tokenizer::Token          op,
-      Expression::ExpressionPtr right)
-      : left{ std::move(left) }, op{ std::move(op) }, right{ std::move(right) }
+    BinaryExpression::BinaryExpression(ExpressionId left, TokenId op, ExpressionId right)
+      : Expression(ExpressionKind::BINARY), left{ left }, op{ op }, right{ right }
     {}
 
-    std::string BinaryExpression::accept(ExpressionVisitor<std::string> &visitor)
-    {
-        return visitor.visit_binary_expression(*this);
-    }
-
-    types::Literal BinaryExpression::accept(ExpressionVisitor<types::Literal> &visitor)
-    {
-        return visitor.visit_binary_expression(*this);
-    }
-
-    void BinaryExpression::accept(ExpressionVisitor<void> &visitor) { return visitor.visit_binary_expression(*this); }
-
-    GroupingExpression::GroupingExpression(Expression::ExpressionPtr expression) : expression{ std::move(expression) }
+    GroupingExpression::GroupingExpression(ExpressionId expression)
+      : Expression(ExpressionKind::GROUPING), expression{ expression }
     {}
 
-    std::string GroupingExpression::accept(ExpressionVisitor<std::string> &visitor)
-    {
-        return visitor.visit_grouping_expression(*this);
-    }
-
-    types::Literal GroupingExpression::accept(ExpressionVisitor<types::Literal> &visitor)
-    {
-        return visitor.visit_grouping_expression(*this);
-    }
-
-    void GroupingExpression::accept(ExpressionVisitor<void> &visitor)
-    {
-        return visitor.visit_grouping_expression(*this);
-    }
-
-    LiteralExpression::LiteralExpression(types::Literal::variant_t literal) : literal{ std::move(literal) } {}
-
-    std::string LiteralExpression::accept(ExpressionVisitor<std::string> &visitor)
-    {
-        return visitor.visit_literal_expression(*this);
-    }
-
-    types::Literal LiteralExpression::accept(ExpressionVisitor<types::Literal> &visitor)
-    {
-        return visitor.visit_literal_expression(*this);
-    }
-
-    void LiteralExpression::accept(ExpressionVisitor<void> &visitor) { return visitor.visit_literal_expression(*this); }
-
-    UnaryExpression::UnaryExpression(tokenizer::Token op, ExpressionPtr right)
-      : op{ std::move(op) }, right{ std::move(right) }
+    LiteralExpression::LiteralExpression(types::Literal::variant_t literal)
+      : Expression(ExpressionKind::LITERAL), literal{ std::move(literal) }
     {}
 
-    std::string UnaryExpression::accept(ExpressionVisitor<std::string> &visitor)
-    {
-        return visitor.visit_unary_expression(*this);
-    }
-
-    types::Literal UnaryExpression::accept(ExpressionVisitor<types::Literal> &visitor)
-    {
-        return visitor.visit_unary_expression(*this);
-    }
-
-    void UnaryExpression::accept(ExpressionVisitor<void> &visitor) { return visitor.visit_unary_expression(*this); }
-
-    VarExpression::VarExpression(tokenizer::Token name) : name{ std::move(name) } {}
-
-    std::string VarExpression::accept(ExpressionVisitor<std::string> &visitor)
-    {
-        return visitor.visit_var_expression(*this);
-    }
-
-    types::Literal VarExpression::accept(ExpressionVisitor<types::Literal> &visitor)
-    {
-        return visitor.visit_var_expression(*this);
-    }
-
-    void VarExpression::accept(ExpressionVisitor<void> &visitor) { return visitor.visit_var_expression(*this); }
-
-    AssignExpression::AssignExpression(tokenizer::Token name, Expression::ExpressionPtr value)
-      : name{ std::move(name) }, value{ std::move(value) }
+    UnaryExpression::UnaryExpression(TokenId op, ExpressionId right)
+      : Expression(ExpressionKind::UNARY), op{ op }, right{ right }
     {}
 
-    std::string AssignExpression::accept(ExpressionVisitor<std::string> &visitor)
-    {
-        return visitor.visit_assign_expression(*this);
-    }
-
-    types::Literal AssignExpression::accept(ExpressionVisitor<types::Literal> &visitor)
-    {
-        return visitor.visit_assign_expression(*this);
-    }
-
-    void AssignExpression::accept(ExpressionVisitor<void> &visitor) { return visitor.visit_assign_expression(*this); }
-
-    LogicalExpression::LogicalExpression(
-      Expression::ExpressionPtr left,
-      tokenizer::Token          op,
-      Expression::ExpressionPtr right)
-      : left{ std::move(left) }, op{ std::move(op) }, right{ std::move(right) }
+    VarExpression::VarExpression(TokenId name, Depth depth)
+      : Expression(ExpressionKind::VAR), name{ name }, depth{ depth }
     {}
 
-    std::string LogicalExpression::accept(ExpressionVisitor<std::string> &visitor)
-    {
-        return visitor.visit_logical_expression(*this);
-    }
-
-    types::Literal LogicalExpression::accept(ExpressionVisitor<types::Literal> &visitor)
-    {
-        return visitor.visit_logical_expression(*this);
-    }
-
-    void LogicalExpression::accept(ExpressionVisitor<void> &visitor) { return visitor.visit_logical_expression(*this); }
+    AssignExpression::AssignExpression(TokenId name, ExpressionId value, Depth depth)
+      : Expression(ExpressionKind::ASSIGN), name{ name }, value{ value }, depth{ depth }
+    {}
 
-    CallExpression::CallExpression(
-      Expression::ExpressionPtr  callee,
-      tokenizer::Token           paren,
-      std::vector<ExpressionPtr> arguments)
-      : callee{ std::move(callee) }, paren{ std::move(paren) }, arguments{ std::move(arguments) }
+    LogicalExpression::LogicalExpression(ExpressionId left, TokenId op, ExpressionId right)
+      : Expression(ExpressionKind::LOGICAL), left{ left }, op{ op }, right{ right }
     {}
 
-    std::string CallExpression::accept(ExpressionVisitor<std::string> &visitor)
-    {
-        return visitor.visit_call_expression(*this);
-    }
+    CallExpression::CallExpression(ExpressionId callee, TokenId paren, ExpressionRange arguments)
+      : Expression(ExpressionKind::CALL), callee{ callee }, paren{ paren }, arguments{ arguments }
+    {}
 
-    types::Literal CallExpression::accept(ExpressionVisitor<types::Literal> &visitor)
-    {
-        return visitor.visit_call_expression(*this);
-    }
+    SpawnExpression::SpawnExpression(TokenId keyword, ExpressionId call)
+      : Expression(ExpressionKind::SPAWN), keyword{ keyword }, call{ call }
+    {}
 
-    void CallExpression::accept(ExpressionVisitor<void> &visitor) { return visitor.visit_call_expression(*this); }
+    AwaitExpression::AwaitExpression(TokenId keyword, ExpressionId task)
+      : Expression(ExpressionKind::AWAIT), keyword{ keyword }, task{ task }
+    {}
 }// namespace tek::parser
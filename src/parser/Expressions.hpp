@@ -3,7 +3,8 @@
 
 #include "../tokenizer/Token.hpp"
 #include "../types/Literal.hpp"
-#include <memory>
+#include "NodeId.hpp"
+#include <cstdint>
 #include <variant>
 
 namespace tek::parser {
@@ -11,43 +12,41 @@ namespace tek::parser {
     template<typename ReturnType>
     class ExpressionVisitor;
 
+    // Number of scopes between a variable and its declaration as found by name resolution, `global_depth` for globals
+    // and for variables that were not resolved.
+    using Depth                         = std::uint32_t;
+    inline constexpr Depth global_depth = ~Depth{ 0 };
+
+    // Nodes carry their kind instead of a vtable, see dispatch() in Dispatch.hpp.
     class Expression
     {
       public:
-        virtual std::string         accept(ExpressionVisitor<std::string> &visitor)         = 0;
-        virtual tek::types::Literal accept(ExpressionVisitor<tek::types::Literal> &visitor) = 0;
-        virtual void                accept(ExpressionVisitor<void> &visitor)                = 0;
+        ExpressionKind kind;
 
       protected:
-        using ExpressionPtr = std::unique_ptr<Expression>;
+        using ExpressionRange = NodeRange<ExpressionId>;
+
+        explicit Expression(const ExpressionKind kind) : kind{ kind } {}
     };
 
     class BinaryExpression : public Expression
     {
       public:
-        BinaryExpression(ExpressionPtr left, tokenizer::Token op, ExpressionPtr right);
-
-        std::string    accept(ExpressionVisitor<std::string> &visitor) override;
-        types::Literal accept(ExpressionVisitor<types::Literal> &visitor) override;
-        void           accept(ExpressionVisitor<void> &visitor) override;
+        BinaryExpression(ExpressionId left, TokenId op, ExpressionId right);
 
       public:
-        ExpressionPtr    left;
-        tokenizer::Token op;
-        ExpressionPtr    right;
+        ExpressionId left;
+        TokenId      op;
+        ExpressionId right;
     };
 
     class GroupingExpression : public Expression
     {
       public:
-        explicit GroupingExpression(ExpressionPtr expression);
-
-        std::string    accept(ExpressionVisitor<std::string> &visitor) override;
-        types::Literal accept(ExpressionVisitor<types::Literal> &visitor) override;
-        void           accept(ExpressionVisitor<void> &visitor) override;
+        explicit GroupingExpression(ExpressionId expression);
 
       public:
-        ExpressionPtr expression;
+        ExpressionId expression;
     };
 
     class LiteralExpression : public Expression
@@ -55,10 +54,6 @@ namespace tek::parser {
       public:
         explicit LiteralExpression(types::Literal::variant_t literal);
 
-        std::string    accept(ExpressionVisitor<std::string> &visitor) override;
-        types::Literal accept(ExpressionVisitor<types::Literal> &visitor) override;
-        void           accept(ExpressionVisitor<void> &visitor) override;
-
       public:
         types::Literal literal;
     };
@@ -66,72 +61,75 @@ namespace tek::parser {
     class UnaryExpression : public Expression
     {
       public:
-        UnaryExpression(tokenizer::Token op, ExpressionPtr right);
-
-        std::string    accept(ExpressionVisitor<std::string> &visitor) override;
-        types::Literal accept(ExpressionVisitor<types::Literal> &visitor) override;
-        void           accept(ExpressionVisitor<void> &visitor) override;
+        UnaryExpression(TokenId op, ExpressionId right);
 
       public:
-        tokenizer::Token op;
-        ExpressionPtr    right;
+        TokenId      op;
+        ExpressionId right;
     };
 
     class VarExpression : public Expression
     {
       public:
-        explicit VarExpression(tokenizer::Token name);
-
-        std::string    accept(ExpressionVisitor<std::string> &visitor) override;
-        types::Literal accept(ExpressionVisitor<types::Literal> &visitor) override;
-        void           accept(ExpressionVisitor<void> &visitor) override;
+        VarExpression(TokenId name, Depth depth);
 
       public:
-        tokenizer::Token name;
+        TokenId name;
+        Depth   depth;
     };
 
     class AssignExpression : public Expression
     {
       public:
-        AssignExpression(tokenizer::Token name, ExpressionPtr value);
-
-        std::string    accept(ExpressionVisitor<std::string> &visitor) override;
-        types::Literal accept(ExpressionVisitor<types::Literal> &visitor) override;
-        void           accept(ExpressionVisitor<void> &visitor) override;
+        AssignExpression(TokenId name, ExpressionId value, Depth depth);
 
       public:
-        tokenizer::Token name;
-        ExpressionPtr    value;
+        TokenId      name;
+        ExpressionId value;
+        Depth        depth;
     };
 
     class LogicalExpression : public Expression
     {
       public:
-        LogicalExpression(ExpressionPtr left, tokenizer::Token op, ExpressionPtr right);
-
-        std::string    accept(ExpressionVisitor<std::string> &visitor) override;
-        types::Literal accept(ExpressionVisitor<types::Literal> &visitor) override;
-        void           accept(ExpressionVisitor<void> &visitor) override;
+        LogicalExpression(ExpressionId left, TokenId op, ExpressionId right);
 
       public:
-        ExpressionPtr    left;
-        tokenizer::Token op;
-        ExpressionPtr    right;
+        ExpressionId left;
+        TokenId      op;
+        ExpressionId right;
     };
 
     class CallExpression : public Expression
     {
       public:
-        CallExpression(ExpressionPtr callee, tokenizer::Token paren, std::vector<ExpressionPtr> arguments);
+        CallExpression(ExpressionId callee, TokenId paren, ExpressionRange arguments);
+
+      public:
+        ExpressionId    callee;
+        TokenId         paren;
+        ExpressionRange arguments;
+    };
+
+    // Runs `call` as a task, evaluating to a handle to await it by.
+    class SpawnExpression : public Expression
+    {
+      public:
+        SpawnExpression(TokenId keyword, ExpressionId call);
 
-        std::string    accept(ExpressionVisitor<std::string> &visitor) override;
-        types::Literal accept(ExpressionVisitor<types::Literal> &visitor) override;
-        void           accept(ExpressionVisitor<void> &visitor) override;
+      public:
+        TokenId      keyword;
+        ExpressionId call;
+    };
+
+    class AwaitExpression : public Expression
+    {
+      public:
+        AwaitExpression(TokenId keyword, ExpressionId task);
 
       public:
-        ExpressionPtr              callee;
-        tokenizer::Token           paren;
-        std::vector<ExpressionPtr> arguments;
+        TokenId      keyword;
+        ExpressionId task;
     };
 
     template<typename ReturnType>
@@ -146,6 +144,8 @@ namespace tek::parser {
         virtual ReturnType visit_assign_expression(AssignExpression &expression)     = 0;
         virtual ReturnType visit_logical_expression(LogicalExpression &expression)   = 0;
         virtual ReturnType visit_call_expression(CallExpression &expression)         = 0;
+        virtual ReturnType visit_spawn_expression(SpawnExpression &expression)       = 0;
+        virtual ReturnType visit_await_expression(AwaitExpression &expression)       = 0;
     };
 }// namespace tek::parser
 
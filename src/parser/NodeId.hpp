@@ -0,0 +1,82 @@
+#ifndef TEK_NODE_ID_HPP
+#define TEK_NODE_ID_HPP
+
+#include <cstdint>
+
+namespace tek::parser {
+    enum class ExpressionKind : std::uint8_t {
+        BINARY = 0,
+        GROUPING,
+        LITERAL,
+        UNARY,
+        VAR,
+        ASSIGN,
+        LOGICAL,
+        CALL,
+        SPAWN,
+        AWAIT,
+        COUNT
+    };
+
+    enum class StatementKind : std::uint8_t {
+        PRINT = 0,
+        EXPRESSION,
+        VAR,
+        BLOCK,
+        IF,
+        WHILE,
+        FOR,
+        FUNCTION,
+        RETURN,
+        YIELD,
+        FOR_IN,
+        COUNT
+    };
+
+    // 32-bit handle to a node in an Ast: the kind of the node picks the pool it lives in, the index its slot there.
+    // A default constructed id refers to no node and stands for an absent child.
+    template<typename Kind>
+    class NodeId
+    {
+      public:
+        static constexpr std::uint32_t index_bits = 28;
+        static constexpr std::uint32_t max_index  = (std::uint32_t{ 1 } << index_bits) - 1;
+
+        static_assert(static_cast<std::uint32_t>(Kind::COUNT) < (std::uint32_t{ 1 } << (32 - index_bits)) - 1);
+
+      public:
+        constexpr NodeId() = default;
+        constexpr NodeId(const Kind kind, const std::uint32_t index)
+          : value{ static_cast<std::uint32_t>(kind) << index_bits | index }
+        {}
+
+        [[nodiscard]] constexpr Kind          kind() const { return static_cast<Kind>(this->value >> index_bits); }
+        [[nodiscard]] constexpr std::uint32_t index() const { return this->value & max_index; }
+
+        constexpr explicit operator bool() const { return this->value != none; }
+
+        friend constexpr bool operator==(const NodeId &lhs, const NodeId &rhs) { return lhs.value == rhs.value; }
+        friend constexpr bool operator!=(const NodeId &lhs, const NodeId &rhs) { return lhs.value != rhs.value; }
+
+      private:
+        static constexpr std::uint32_t none = ~std::uint32_t{ 0 };
+
+        std::uint32_t value = none;
+    };
+
+    using ExpressionId = NodeId<ExpressionKind>;
+    using StatementId  = NodeId<StatementKind>;
+
+    // Index of a token in the token pool of an Ast.
+    using TokenId = std::uint32_t;
+
+    // A run of consecutive entries in one of the pools of an Ast: call arguments, block bodies or parameters.
+    template<typename Element>
+    struct NodeRange
+    {
+        std::uint32_t first = 0;
+        std::uint32_t size  = 0;
+    };
+}// namespace tek::parser
+
+#endif// TEK_NODE_ID_HPP
@@ -2,162 +2,249 @@
 
 namespace tek::parser {
 
-    Parser::Parser(Parser::TokensVec tokens) : tokens{ std::move(tokens) }, current{ 0 } {}
+    Parser::Parser(tokenizer::Tokenizer &tokenizer, Ast &ast, const ParseOptions options)
+      : tokenizer{ &tokenizer }, source{ tokenizer.source_code() }, ast{ ast }, current{ 0 }, options{ options }
+    {}
 
-    Parser::ExpressionPtr Parser::expression() { return this->assignment(); }
+    Parser::Parser(
+      const utils::span<const tokenizer::Token> tokens,
+      const std::string_view                    source,
+      Ast                                      &ast,
+      const ParseOptions                        options)
+      : tokenizer{ nullptr }, scanned{ tokens }, source{ source }, ast{ ast }, current{ 0 }, options{ options }
+    {
+        assert(!tokens.empty() && tokens[tokens.size() - 1].type == tokenizer::TokenType::ENDOF);
+    }
 
-    Parser::ExpressionPtr Parser::equality()
+    constexpr Parser::InfixRules Parser::make_infix_rules()
     {
-        auto left = this->comparison();
+        InfixRules rules{};
 
-        while (this->match(tokenizer::TokenType::BANG_EQUAL, tokenizer::TokenType::EQUAL_EQUAL)) {
-            const auto op    = this->previous();
-            auto       right = this->comparison();
+        const auto set = [&rules](tokenizer::TokenType type, Precedence precedence, OperatorKind kind) {
+            rules[static_cast<std::size_t>(type)] = InfixRule{ precedence, kind };
+        };
 
-            left = std::make_unique<BinaryExpression>(std::move(left), op, std::move(right));
-        }
+        set(tokenizer::TokenType::EQUAL, Precedence::ASSIGNMENT, OperatorKind::ASSIGN);
+        set(tokenizer::TokenType::OR, Precedence::OR, OperatorKind::LOGICAL);
+        set(tokenizer::TokenType::AND, Precedence::AND, OperatorKind::LOGICAL);
+        set(tokenizer::TokenType::BANG_EQUAL, Precedence::EQUALITY, OperatorKind::BINARY);
+        set(tokenizer::TokenType::EQUAL_EQUAL, Precedence::EQUALITY, OperatorKind::BINARY);
+        set(tokenizer::TokenType::GREATER, Precedence::COMPARISON, OperatorKind::BINARY);
+        set(tokenizer::TokenType::GREATER_EQUAL, Precedence::COMPARISON, OperatorKind::BINARY);
+        set(tokenizer::TokenType::LESS, Precedence::COMPARISON, OperatorKind::BINARY);
+        set(tokenizer::TokenType::LESS_EQUAL, Precedence::COMPARISON, OperatorKind::BINARY);
+        set(tokenizer::TokenType::MINUS, Precedence::TERM, OperatorKind::BINARY);
+        set(tokenizer::TokenType::PLUS, Precedence::TERM, OperatorKind::BINARY);
+        set(tokenizer::TokenType::SLASH, Precedence::FACTOR, OperatorKind::BINARY);
+        set(tokenizer::TokenType::STAR, Precedence::FACTOR, OperatorKind::BINARY);
 
-        return left;
+        return rules;
     }
 
-    Parser::ExpressionPtr Parser::assignment()
+    const Parser::InfixRule &Parser::infix_rule(const tokenizer::TokenType type)
     {
-        auto expression = this->logical_or();
+        static constexpr InfixRules rules = Parser::make_infix_rules();
+        return rules[static_cast<std::size_t>(type)];
+    }
 
-        if (this->match(tokenizer::TokenType::EQUAL)) {
-            const auto equals = this->previous();
-            auto       value  = this->assignment();
+    ExpressionId Parser::expression()
+    {
+        Operands         operands;
+        PendingOperators operators;
+        bool             expect_operand = true;
 
-            if (auto *var_expr = dynamic_cast<VarExpression *>(expression.get())) {
-                return std::make_unique<AssignExpression>(var_expr->name, std::move(value));
+        while (true) {
+            if (expect_operand) {
+                const auto type = this->peek().type;
+
+                if (type == tokenizer::TokenType::BANG || type == tokenizer::TokenType::MINUS
+                    || type == tokenizer::TokenType::SPAWN || type == tokenizer::TokenType::AWAIT) {
+                    const auto op = this->ast.add_token(this->advance());
+                    operators.push_back(PendingOperator{ OperatorKind::PREFIX, Precedence::UNARY, op, 0 });
+                } else if (type == tokenizer::TokenType::LEFT_PAREN) {
+                    this->advance();
+                    operators.push_back(PendingOperator{ OperatorKind::GROUP, Precedence::NONE, 0, operands.size() });
+                } else {
+                    operands.push_back(this->primary());
+                    expect_operand = false;
+                }
+                continue;
             }
 
-            Parser::error(equals, "Invalid assignment target.");
+            const auto &token = this->peek();
+            const auto &rule  = Parser::infix_rule(token.type);
+
+            if (rule.kind != OperatorKind::NONE) {
+                this->reduce(operands, operators, rule.precedence, rule.kind == OperatorKind::ASSIGN);
+                const auto op = this->ast.add_token(this->advance());
+                operators.push_back(PendingOperator{ rule.kind, rule.precedence, op, 0 });
+                expect_operand = true;
+            } else if (token.type == tokenizer::TokenType::LEFT_PAREN) {
+                // The callee is the operand just parsed, calls bind tighter than any pending operator.
+                this->advance();
+                operators.push_back(PendingOperator{ OperatorKind::CALL, Precedence::NONE, 0, operands.size() - 1 });
+                expect_operand = !this->check(tokenizer::TokenType::RIGHT_PAREN);
+                if (!expect_operand) { this->close_marker(operands, operators); }
+            } else {
+                // Anything else ends the innermost open group or call, or the whole expression if none is open.
+                this->reduce(operands, operators, Precedence::NONE, false);
+                if (operators.empty()) { return operands.back().expression; }
+
+                const auto marker = operators.back().kind;
+                if (token.type == tokenizer::TokenType::RIGHT_PAREN) {
+                    this->close_marker(operands, operators);
+                } else if (token.type == tokenizer::TokenType::COMMA && marker == OperatorKind::CALL) {
+                    this->advance();
+                    if (operands.size() - operators.back().operands_base - 1 >= 255) {
+                        Parser::error(this->peek(), "Function call can't accept more than 255 arguments.");
+                    }
+                    expect_operand = true;
+                } else {
+                    throw Parser::error(token, Parser::marker_message(marker));
+                }
+            }
         }
-
-        return expression;
     }
 
-    Parser::ExpressionPtr Parser::comparison()
-    {
-        auto left = this->term();
-
-        while (this->match(
-          tokenizer::TokenType::GREATER,
-          tokenizer::TokenType::GREATER_EQUAL,
-          tokenizer::TokenType::LESS,
-          tokenizer::TokenType::LESS_EQUAL)) {
-            const auto op    = this->previous();
-            auto       right = this->term();
-            left             = std::make_unique<BinaryExpression>(std::move(left), op, std::move(right));
+    Parser::Operand Parser::primary()
+    {
+        switch (this->peek().type) {
+            case tokenizer::TokenType::FALSE:
+                this->advance();
+                return Operand{ this->ast.make_expression<LiteralExpression>(false), false };
+            case tokenizer::TokenType::TRUE:
+                this->advance();
+                return Operand{ this->ast.make_expression<LiteralExpression>(true), false };
+            case tokenizer::TokenType::NIL:
+                this->advance();
+                return Operand{ this->ast.make_expression<LiteralExpression>(nullptr), false };
+            case tokenizer::TokenType::NUMBER:
+            case tokenizer::TokenType::STRING:
+                return Operand{ this->ast.make_expression<LiteralExpression>(this->advance().literal.value()), false };
+            case tokenizer::TokenType::IDENTIFIER: {
+                const auto  name  = this->ast.add_token(this->advance());
+                const auto &token = this->ast.token(name);
+
+                // A variable followed by '=' is an assignment target, it is resolved along with the assignment.
+                const auto depth = this->check(tokenizer::TokenType::EQUAL) ? global_depth : this->resolve_read(token);
+                return Operand{ this->ast.make_expression<VarExpression>(name, depth), true };
+            }
+            default:
+                throw Parser::error(this->peek(), "Expected expression.");
         }
-        return left;
     }
 
-    Parser::ExpressionPtr Parser::term()
+    void Parser::reduce(
+      Operands         &operands,
+      PendingOperators &operators,
+      const Precedence  precedence,
+      const bool        right)
     {
-        auto left = this->factor();
+        while (!operators.empty()) {
+            const auto &top = operators.back();
+            if (top.kind == OperatorKind::GROUP || top.kind == OperatorKind::CALL) { return; }
+            if (top.precedence < precedence || (top.precedence == precedence && right)) { return; }
 
-        while (this->match(tokenizer::TokenType::MINUS, tokenizer::TokenType::PLUS)) {
-            const auto op    = this->previous();
-            auto       right = this->factor();
-            left             = std::make_unique<BinaryExpression>(std::move(left), op, std::move(right));
+            this->reduce_top(operands, operators);
         }
-        return left;
     }
 
-    Parser::ExpressionPtr Parser::factor()
+    void Parser::reduce_top(Operands &operands, PendingOperators &operators)
     {
-        auto left = this->unary();
+        const auto op = operators.back();
+        operators.pop_back();
 
-        while (this->match(tokenizer::TokenType::SLASH, tokenizer::TokenType::STAR)) {
-            const auto op    = this->previous();
-            auto       right = this->unary();
-            left             = std::make_unique<BinaryExpression>(std::move(left), op, std::move(right));
-        }
-        return left;
-    }
+        const auto right = operands.back();
+        operands.pop_back();
 
-    Parser::ExpressionPtr Parser::unary()
-    {
-        if (this->match(tokenizer::TokenType::BANG, tokenizer::TokenType::MINUS)) {
-            const auto op    = this->previous();
-            auto       right = this->unary();
-            return std::make_unique<UnaryExpression>(op, std::move(right));
-        }
+        if (op.kind == OperatorKind::PREFIX) {
+            const auto &token = this->ast.token(op.token);
 
-        return this->call();
-    }
-
-    Parser::ExpressionPtr Parser::primary()
-    {
-        if (this->match(tokenizer::TokenType::FALSE)) {
-            return std::make_unique<LiteralExpression>(false);
-        } else if (this->match(tokenizer::TokenType::TRUE)) {
-            return std::make_unique<LiteralExpression>(true);
-        } else if (this->match(tokenizer::TokenType::NIL)) {
-            return std::make_unique<LiteralExpression>(nullptr);
-        } else if (this->match(tokenizer::TokenType::NUMBER, tokenizer::TokenType::STRING)) {
-            return std::make_unique<LiteralExpression>(this->previous().literal.value());
-        } else if (this->match(tokenizer::TokenType::LEFT_PAREN)) {
-            auto expression = this->expression();
-            this->consume(tokenizer::TokenType::RIGHT_PAREN, "Expect ')' after expression");
-            return std::make_unique<GroupingExpression>(std::move(expression));
-        } else if (this->match(tokenizer::TokenType::IDENTIFIER)) {
-            return std::make_unique<VarExpression>(this->previous());
+            ExpressionId prefixed;
+            if (token.type == tokenizer::TokenType::SPAWN) {
+                if (right.expression.kind() != ExpressionKind::CALL) {
+                    Parser::error(token, "Expected a call to spawn.");
+                }
+                prefixed = this->ast.make_expression<SpawnExpression>(op.token, right.expression);
+            } else if (token.type == tokenizer::TokenType::AWAIT) {
+                prefixed = this->ast.make_expression<AwaitExpression>(op.token, right.expression);
+            } else {
+                prefixed = this->ast.make_expression<UnaryExpression>(op.token, right.expression);
+            }
+            operands.push_back(Operand{ prefixed, false });
+            return;
         }
 
-        throw Parser::error(this->peek(), "Expected expression.");
-    }
-
-    Parser::ExpressionPtr Parser::logical_or()
-    {
-        auto left = this->logical_and();
+        auto &left = operands.back();
+        switch (op.kind) {
+            case OperatorKind::BINARY:
+                left.expression =
+                  this->ast.make_expression<BinaryExpression>(left.expression, op.token, right.expression);
+                break;
+            case OperatorKind::LOGICAL:
+                left.expression =
+                  this->ast.make_expression<LogicalExpression>(left.expression, op.token, right.expression);
+                break;
+            case OperatorKind::ASSIGN: {
+                if (!left.is_variable) { Parser::error(this->ast.token(op.token), "Invalid assignment target."); }
 
-        while (this->match(tokenizer::TokenType::OR)) {
-            const auto op    = this->previous();
-            auto       right = this->logical_and();
-            left             = std::make_unique<LogicalExpression>(std::move(left), op, std::move(right));
+                const auto name  = this->ast.get<VarExpression>(left.expression).name;
+                const auto depth = this->resolve_local(this->ast.token(name));
+                left.expression  = this->ast.make_expression<AssignExpression>(name, right.expression, depth);
+                break;
+            }
+            default:
+                assert(0 && "Unreachable");
+                break;
         }
-
-        return left;
+        left.is_variable = false;
     }
 
-    Parser::ExpressionPtr Parser::logical_and()
+    void Parser::close_marker(Operands &operands, PendingOperators &operators)
     {
-        auto left = this->equality();
+        const auto marker = operators.back();
+        operators.pop_back();
+
+        const auto &paren = this->consume(tokenizer::TokenType::RIGHT_PAREN, Parser::marker_message(marker.kind));
 
-        while (this->match(tokenizer::TokenType::AND)) {
-            const auto op    = this->previous();
-            auto       right = this->equality();
-            left             = std::make_unique<LogicalExpression>(std::move(left), op, std::move(right));
+        if (marker.kind == OperatorKind::GROUP) {
+            auto &grouped = operands.back();
+            grouped       = Operand{ this->ast.make_expression<GroupingExpression>(grouped.expression), false };
+            return;
         }
 
-        return left;
+        std::vector<ExpressionId> arguments;
+        arguments.reserve(operands.size() - marker.operands_base - 1);
+        for (auto i = marker.operands_base + 1; i < operands.size(); ++i) {
+            arguments.push_back(operands[i].expression);
+        }
+        operands.resize(marker.operands_base + 1);
+
+        auto &callee = operands.back();
+        const auto call = this->ast.make_expression<CallExpression>(
+          callee.expression, this->ast.add_token(paren), this->ast.add_expressions(arguments));
+        callee = Operand{ call, false };
     }
 
-    Parser::ExpressionPtr Parser::call()
+    std::string Parser::marker_message(const OperatorKind marker)
     {
-        auto expression = this->primary();
-
-        while (true) {
-            if (this->match(tokenizer::TokenType::LEFT_PAREN)) {
-                expression = this->finish_call(expression);
-            } else {
-                break;
-            }
-        }
-
-        return expression;
+        return marker == OperatorKind::GROUP ? "Expect ')' after expression"
+                                             : "Expected '(' after argument list in function call.";
     }
 
-    Parser::StatementPtr Parser::statement()
+    StatementId Parser::statement()
     {
+        this->enter_nested();
+        utils::ScopeGuard leave([this]() { --this->nesting; });
+
         // check this if it doesn't work
         if (this->match(tokenizer::TokenType::PRINT)) {
             return this->print_statement();
         } else if (this->match(tokenizer::TokenType::LEFT_BRACE)) {
-            return std::make_unique<BlockStatement>(this->block_statement());
+            this->begin_scope();
+            const auto statements = this->block_statement();
+            this->end_scope();
+            return this->ast.make_statement<BlockStatement>(statements);
         } else if (this->match(tokenizer::TokenType::IF)) {
             return this->if_statement();
         } else if (this->match(tokenizer::TokenType::WHILE)) {
@@ -166,12 +253,14 @@ namespace tek::parser {
             return this->for_statement();
         } else if (this->match(tokenizer::TokenType::RETURN)) {
             return this->return_statement();
+        } else if (this->match(tokenizer::TokenType::YIELD)) {
+            return this->yield_statement();
         }
 
         return this->expression_statement();
     }
 
-    Parser::StatementPtr Parser::declaration()
+    StatementId Parser::declaration()
     {
         try {
             if (this->match(tokenizer::TokenType::VAR)) {
@@ -183,185 +272,265 @@ namespace tek::parser {
             return this->statement();
         } catch (const exceptions::RuntimeError &error) {
             this->synchronize();
-            return nullptr;
+            return StatementId();
         }
     }
 
-    Parser::StatementPtr Parser::print_statement()
+    StatementId Parser::print_statement()
     {
-        auto value = this->expression();
+        const auto value = this->expression();
         this->consume(tokenizer::TokenType::SEMICOLON, "Expected ';' after value.");
 
-        return std::make_unique<PrintStatement>(std::move(value));
+        return this->ast.make_statement<PrintStatement>(value);
     }
 
-    Parser::StatementPtr Parser::expression_statement()
+    StatementId Parser::expression_statement()
     {
-        auto value = this->expression();
+        const auto value = this->expression();
         this->consume(tokenizer::TokenType::SEMICOLON, "Expected ';' after expression.");
 
-        return std::make_unique<ExpressionStatement>(std::move(value));
+        return this->ast.make_statement<ExpressionStatement>(value);
     }
 
-    Parser::StatementPtr Parser::var_statement()
+    StatementId Parser::var_statement()
     {
-        const auto name = this->consume(tokenizer::TokenType::IDENTIFIER, "Expected variable name.");
+        const auto name =
+          this->ast.add_token(this->consume(tokenizer::TokenType::IDENTIFIER, "Expected variable name."));
+        this->declare(this->ast.token(name));
 
-        ExpressionPtr initializer = nullptr;
+        ExpressionId initializer;
 
         if (this->match(tokenizer::TokenType::EQUAL)) { initializer = this->expression(); }
 
         this->consume(tokenizer::TokenType::SEMICOLON, "Expected semicolon after variable declaration.");
+        this->define(this->ast.token(name));
 
-        return std::make_unique<VarStatement>(name, std::move(initializer));
+        return this->ast.make_statement<VarStatement>(name, initializer);
     }
 
-    Parser::StatementsVec Parser::block_statement()
+    Parser::StatementRange Parser::block_statement()
     {
         StatementsVec out;
 
         while (!this->check(tokenizer::TokenType::RIGHT_BRACE) && !this->is_at_end()) {
-            out.push_back(std::move(this->declaration()));
+            out.push_back(this->declaration());
         }
 
         this->consume(tokenizer::TokenType::RIGHT_BRACE, "Expect '}' after block.");
-        return out;
+        return this->ast.add_statements(out);
     }
 
-    Parser::StatementPtr Parser::if_statement()
+    StatementId Parser::if_statement()
     {
         this->consume(tokenizer::TokenType::LEFT_PAREN, "Expected '(' after if keyword.");
-        auto condition = this->expression();
+        const auto condition = this->expression();
         this->consume(tokenizer::TokenType::RIGHT_PAREN, "Expected ')' after condition in if statement.");
 
-        auto         then_branch = this->statement();
-        StatementPtr else_branch = nullptr;
+        const auto  then_branch = this->statement();
+        StatementId else_branch;
 
         if (this->match(tokenizer::TokenType::ELSE)) { else_branch = this->statement(); }
 
-        return std::make_unique<IfStatement>(std::move(condition), std::move(then_branch), std::move(else_branch));
+        return this->ast.make_statement<IfStatement>(condition, then_branch, else_branch);
     }
 
-    Parser::StatementPtr Parser::while_statement()
+    StatementId Parser::while_statement()
     {
+        const auto keyword = this->ast.add_token(this->previous());
         this->consume(tokenizer::TokenType::LEFT_PAREN, "Expected '(' after while keyword.");
-        auto condition = this->expression();
+        const auto condition = this->expression();
         this->consume(tokenizer::TokenType::RIGHT_PAREN, "Expected ')' after condition in while loop.");
 
-        auto body = this->statement();
-        return std::make_unique<WhileStatement>(std::move(condition), std::move(body));
+        const auto body = this->statement();
+        return this->ast.make_statement<WhileStatement>(keyword, condition, body);
     }
 
-    Parser::StatementPtr Parser::for_statement()
+    StatementId Parser::for_statement()
     {
+        const auto keyword = this->ast.add_token(this->previous());
         this->consume(tokenizer::TokenType::LEFT_PAREN, "Expected '(' after for keyword.");
+        if (this->check(tokenizer::TokenType::VAR) && this->peek(2).type == tokenizer::TokenType::IN) {
+            return this->for_in_statement(keyword);
+        }
 
-        auto initializer = this->for_statement_initializer();
+        // The loop gets an environment for its initializer, the block wrapping body and increment another one.
+        this->begin_scope();
+        const auto initializer = this->for_statement_initializer();
 
-        auto condition = this->for_statement_condition();
+        const auto condition = this->for_statement_condition();
         this->consume(tokenizer::TokenType::SEMICOLON, "Expected ';' after for loop condition.");
 
-        auto increment = this->for_statement_increment();
+        this->begin_scope();
+        const auto increment = this->for_statement_increment();
         this->consume(tokenizer::TokenType::RIGHT_PAREN, "Expected ')' after for loop increment expression.");
 
-        auto body = this->for_statement_body(increment);
+        const auto body = this->for_statement_body(increment);
+        this->end_scope();
+        this->end_scope();
 
-        return std::make_unique<ForStatement>(std::move(initializer), std::move(condition), std::move(body));
+        return this->ast.make_statement<ForStatement>(keyword, initializer, condition, body);
     }
 
-    Parser::StatementPtr Parser::function_statement(const std::string &kind)
+    StatementId Parser::function_statement(const std::string &kind)
     {
-        const tokenizer::Token name =
-          this->consume(tokenizer::TokenType::IDENTIFIER, fmt::format("Expected {} name.", kind));
+        this->enter_nested();
+        utils::ScopeGuard leave([this]() { --this->nesting; });
+
+        const bool generator = this->match(tokenizer::TokenType::STAR);
+        const auto name =
+          this->ast.add_token(this->consume(tokenizer::TokenType::IDENTIFIER, fmt::format("Expected {} name.", kind)));
+        this->declare(this->ast.token(name));
+        this->define(this->ast.token(name));
+
         this->consume(tokenizer::TokenType::LEFT_PAREN, fmt::format("Expected '(' after {} keyword", kind));
 
-        std::vector<tokenizer::Token> parameters;
+        const auto enclosing_function = this->current_function;
+        this->current_function        = generator ? FunctionType::GENERATOR : FunctionType::FUNCTION;
+        this->begin_scope();
+
+        std::vector<TokenId> parameters;
         if (!this->check(tokenizer::TokenType::RIGHT_PAREN)) {
             do {
                 if (parameters.size() >= 255) { Parser::error(this->peek(), "Can't have more than 255 parameters."); }
 
-                parameters.emplace_back(this->consume(tokenizer::TokenType::IDENTIFIER, "Expected parameter name."));
+                parameters.push_back(
+                  this->ast.add_token(this->consume(tokenizer::TokenType::IDENTIFIER, "Expected parameter name.")));
+                this->declare(this->ast.token(parameters.back()));
+                this->define(this->ast.token(parameters.back()));
             } while (this->match(tokenizer::TokenType::COMMA));
         }
 
         this->consume(tokenizer::TokenType::RIGHT_PAREN, "Expected ')' after parameter list in function definition.");
 
-        this->consume(
+        const auto &brace = this->consume(
           tokenizer::TokenType::LEFT_BRACE, fmt::format("Expected '{{' after parameter list in {} definition.", kind));
+        const auto body_offset = brace.offset + 1;
+        const auto body_line   = brace.line;
+
+        // Parameters and the body share one scope, like they share one environment when the function is called.
+        StatementRange body;
+        auto           deferred_body = FunctionStatement::no_deferred_body;
+        if (this->options.defer_function_bodies) {
+            const auto length = this->skip_block() + 1 - body_offset;
+            deferred_body     = this->ast.add_deferred_body(
+              this->source.substr(body_offset, length),
+              body_line,
+              this->options.resolve_names,
+              std::vector<Scope>(this->scopes.begin(), this->scopes.end()));
+            this->ast.deferred_body(deferred_body).generator = generator;
+            if (this->options.body_pool) { this->parse_ahead(this->ast.deferred_body(deferred_body)); }
+        } else {
+            body = this->block_statement();
+        }
 
-        std::vector<StatementPtr> body = this->block_statement();
+        this->end_scope();
+        this->current_function = enclosing_function;
 
-        return std::make_unique<FunctionStatement>(name, parameters, std::move(body));
+        return this->ast.make_statement<FunctionStatement>(
+          name, this->ast.add_tokens(parameters), body, deferred_body, generator);
     }
 
-    Parser::StatementPtr Parser::return_statement()
+    StatementId Parser::return_statement()
     {
-        auto          keyword    = this->previous();
-        ExpressionPtr expression = nullptr;
+        const auto keyword = this->ast.add_token(this->previous());
+        if (this->options.resolve_names && this->current_function == FunctionType::NONE) {
+            this->report(this->ast.token(keyword), "Can't return from top-level code");
+        }
+
+        ExpressionId expression;
         if (!this->check(tokenizer::TokenType::COMMA)) { expression = this->expression(); }
 
         this->consume(tokenizer::TokenType::SEMICOLON, "Expected ';' after return statement.");
-        return std::make_unique<ReturnStatement>(keyword, std::move(expression));
+        return this->ast.make_statement<ReturnStatement>(keyword, expression);
     }
 
-    Parser::StatementPtr Parser::for_statement_initializer()
+    StatementId Parser::yield_statement()
+    {
+        const auto keyword = this->ast.add_token(this->previous());
+        if (this->current_function != FunctionType::GENERATOR) {
+            this->report(this->ast.token(keyword), "Can't yield outside a generator.");
+        }
+
+        const auto value = this->expression();
+        this->consume(tokenizer::TokenType::SEMICOLON, "Expected ';' after yield statement.");
+        return this->ast.make_statement<YieldStatement>(keyword, value);
+    }
+
+    std::size_t Parser::skip_block()
+    {
+        std::size_t depth = 1;
+        while (!this->is_at_end()) {
+            const auto &token = this->advance();
+            if (token.type == tokenizer::TokenType::LEFT_BRACE) {
+                ++depth;
+            } else if (token.type == tokenizer::TokenType::RIGHT_BRACE && --depth == 0) {
+                return token.offset;
+            }
+        }
+
+        throw Parser::error(this->peek(), "Expect '}' after block.");
+    }
+
+    StatementId Parser::for_statement_initializer()
     {
         if (this->match(tokenizer::TokenType::VAR)) {
             return this->var_statement();
         } else if (this->match(tokenizer::TokenType::SEMICOLON)) {
-            return nullptr;
+            return StatementId();
         }
 
         // Not quite sure
         return this->expression_statement();
     }
 
-    Parser::ExpressionPtr Parser::for_statement_condition()
+    ExpressionId Parser::for_statement_condition()
     {
         if (!this->check(tokenizer::TokenType::SEMICOLON)) {
             return this->expression();
         } else {
-            return std::make_unique<LiteralExpression>(types::Literal(true).value());
+            return this->ast.make_expression<LiteralExpression>(types::Literal(true).value());
         }
     }
 
-    Parser::ExpressionPtr Parser::for_statement_increment()
+    ExpressionId Parser::for_statement_increment()
     {
         if (!this->check(tokenizer::TokenType::RIGHT_PAREN)) {
             return this->expression();
         } else {
-            return nullptr;
+            return ExpressionId();
         }
     }
 
-    Parser::StatementPtr Parser::for_statement_body(ExpressionPtr &increment)
+    StatementId Parser::for_statement_body(const ExpressionId increment)
     {
-        auto body = this->statement();
+        const auto body = this->statement();
 
         // TODO: Find a better way to do this
         StatementsVec out;
-        out.push_back(std::move(body));
-        if (increment) { out.push_back(std::make_unique<ExpressionStatement>(std::move(increment))); }
+        out.push_back(body);
+        if (increment) { out.push_back(this->ast.make_statement<ExpressionStatement>(increment)); }
 
-        return std::make_unique<BlockStatement>(std::move(out));
+        return this->ast.make_statement<BlockStatement>(this->ast.add_statements(out));
     }
 
-    Parser::ExpressionPtr Parser::finish_call(Parser::ExpressionPtr &callee)
+    StatementId Parser::for_in_statement(const TokenId keyword)
     {
-        std::vector<ExpressionPtr> arguments;
-        if (!this->check(tokenizer::TokenType::RIGHT_PAREN)) {
-            do {
-                if (arguments.size() >= 255) {
-                    Parser::error(this->peek(), "Function call can't accept more than 255 arguments.");
-                }
-                arguments.push_back(this->expression());
-            } while (this->match(tokenizer::TokenType::COMMA));
-        }
+        this->advance();
+        const auto name =
+          this->ast.add_token(this->consume(tokenizer::TokenType::IDENTIFIER, "Expected variable name."));
+        this->consume(tokenizer::TokenType::IN, "Expected 'in' after for loop variable.");
+
+        // The iterable is evaluated before the loop variable exists, the body sees it in an environment of its own.
+        const auto iterable = this->expression();
+        this->consume(tokenizer::TokenType::RIGHT_PAREN, "Expected ')' after for loop iterable.");
 
-        const tokenizer::Token paren =
-          this->consume(tokenizer::TokenType::RIGHT_PAREN, "Expected '(' after argument list in function call.");
+        this->begin_scope();
+        this->declare(this->ast.token(name));
+        this->define(this->ast.token(name));
+        const auto body = this->statement();
+        this->end_scope();
 
-        return std::make_unique<CallExpression>(std::move(callee), paren, std::move(arguments));
+        return this->ast.make_statement<ForInStatement>(keyword, name, iterable, body);
     }
 
     template<typename Match>
@@ -384,17 +553,31 @@ namespace tek::parser {
 
     bool Parser::is_at_end() { return this->peek().type == tokenizer::TokenType::ENDOF; }
 
-    tokenizer::Token Parser::advance()
+    const tokenizer::Token &Parser::advance()
     {
         if (!this->is_at_end()) { this->current++; }
         return this->previous();
     }
 
-    tokenizer::Token Parser::peek() { return this->tokens.at(this->current); }
+    const tokenizer::Token &Parser::peek(const std::size_t ahead)
+    {
+        assert(ahead + 2 <= window_size);
+        while (this->window.size() <= this->current + ahead) { this->window.push(this->next_token()); }
+        return this->window.at(this->current + ahead);
+    }
+
+    tokenizer::Token Parser::next_token()
+    {
+        if (this->tokenizer) { return this->tokenizer->next_token(); }
+
+        // Past the end the ENDOF token is repeated, like the tokenizer does.
+        const auto position = std::min<std::size_t>(this->window.size(), this->scanned.size() - 1);
+        return this->scanned[position];
+    }
 
-    tokenizer::Token Parser::previous() { return this->tokens.at(this->current - 1); }
+    const tokenizer::Token &Parser::previous() { return this->window.at(this->current - 1); }
 
-    tokenizer::Token Parser::consume(const tokenizer::TokenType &type, const std::string &message)
+    const tokenizer::Token &Parser::consume(const tokenizer::TokenType &type, const std::string &message)
     {
         if (this->check(type)) { return this->advance(); }
 
@@ -423,14 +606,178 @@ namespace tek::parser {
                 case tokenizer::TokenType::WHILE:
                 case tokenizer::TokenType::PRINT:
                 case tokenizer::TokenType::RETURN:
+                case tokenizer::TokenType::YIELD:
                     return;
             }
             this->advance();
         }
     }
 
+    void Parser::begin_scope()
+    {
+        if (this->options.resolve_names) { this->scopes.push(Scope{}); }
+    }
+
+    void Parser::end_scope()
+    {
+        if (this->options.resolve_names) { this->scopes.pop(); }
+    }
+
+    void Parser::declare(const tokenizer::Token &name)
+    {
+        if (this->scopes.empty()) { return; }
+
+        auto &current_scope = this->scopes.top();
+
+        if (const auto it = current_scope.find(name.lexeme); it != current_scope.end()) {
+            this->report(name, "A variable with this name already exists in this scope");
+        }
+
+        current_scope.insert_or_assign(name.lexeme, false);
+    }
+
+    void Parser::define(const tokenizer::Token &name)
+    {
+        if (this->scopes.empty()) { return; }
+
+        this->scopes.top().insert_or_assign(name.lexeme, true);
+    }
+
+    void Parser::enter_nested()
+    {
+        if (++this->nesting > max_nesting) {
+            throw this->error(this->peek(), fmt::format("Code is nested more than {} levels deep.", max_nesting));
+        }
+    }
+
+    void Parser::report(const tokenizer::Token &token, const std::string &message)
+    {
+        logger::Logger::error(token, message);
+        this->had_error = true;
+    }
+
+    Depth Parser::resolve_read(const tokenizer::Token &name)
+    {
+        if (!this->scopes.empty()) {
+            const auto &current_scope = this->scopes.top();
+            if (const auto it = current_scope.find(name.lexeme); it != current_scope.end() && !it->second) {
+                this->report(name, "Can't read local variable in its own initializer.");
+            }
+        }
+
+        return this->resolve_local(name);
+    }
+
+    Depth Parser::resolve_local(const tokenizer::Token &name) const
+    {
+        // Innermost scope first, a name found in none of them is left to the globals.
+        Depth depth = 0;
+        for (auto scope = this->scopes.end(); scope != this->scopes.begin(); ++depth) {
+            --scope;
+            if (scope->find(name.lexeme) != scope->end()) { return depth; }
+        }
+        return global_depth;
+    }
+
+    bool Parser::parse_deferred(DeferredBody &body)
+    {
+        std::call_once(body.parsed, [&body]() { Parser::parse_body(body, std::make_shared<Ast>()); });
+
+        return body.ast != nullptr;
+    }
+
+    void Parser::parse_body(DeferredBody &body, const std::shared_ptr<Ast> &ast)
+    {
+        tokenizer::Tokenizer tokenizer(body.source, body.line);
+
+        Parser parser(tokenizer, *ast, ParseOptions{ body.resolve_names, body.defer_function_bodies });
+        for (auto &scope : body.scopes) { parser.scopes.push(std::move(scope)); }
+        parser.current_function = body.generator ? FunctionType::GENERATOR : FunctionType::FUNCTION;
+
+        try {
+            body.statements = parser.block_statement();
+        } catch (const exceptions::ParseError &) {
+            return;
+        }
+
+        if (!parser.had_error) { body.ast = ast; }
+    }
+
+    std::optional<StatementId> Parser::parse_declaration()
+    {
+        const auto had_error = std::exchange(this->had_error, false);
+
+        std::optional<StatementId> statement;
+        try {
+            statement = this->declaration();
+        } catch (const exceptions::ParseError &) {
+            this->synchronize();
+            this->scopes           = ScopesStack{};
+            this->current_function = FunctionType::NONE;
+        }
+
+        if (this->had_error) { statement.reset(); }
+        this->had_error = this->had_error || had_error;
+        return statement;
+    }
+
+    std::size_t Parser::position() const { return this->current; }
+
+    const tokenizer::Token &Parser::current_token() { return this->peek(); }
+
+    void Parser::parse_ahead(DeferredBody &body)
+    {
+        this->bodies_ahead.emplace_back(&body, this->diagnostics.size());
+
+        // Nested functions are parsed along with the body, there is no going back to them.
+        body.defer_function_bodies = false;
+        this->batch.push_back(&body);
+        this->batch_bytes += body.source.size();
+        if (this->batch_bytes >= min_batch_bytes) { this->submit_batch(); }
+    }
+
+    void Parser::submit_batch()
+    {
+        if (this->batch.empty()) { return; }
+
+        this->options.body_pool->submit([bodies = std::move(this->batch)]() {
+            const auto ast = std::make_shared<Ast>();
+            for (auto *body : bodies) {
+                logger::Logger::capture(&body->diagnostics);
+                std::call_once(body->parsed, [&]() { Parser::parse_body(*body, ast); });
+            }
+            logger::Logger::capture(nullptr);
+        });
+
+        this->batch.clear();
+        this->batch_bytes = 0;
+    }
+
+    void Parser::print_diagnostics()
+    {
+        // Everything was printed as it was found.
+        if (!this->options.body_pool) { return; }
+
+        logger::Logger::capture(nullptr);
+        this->submit_batch();
+        this->options.body_pool->wait();
+
+        auto printed = this->diagnostics.begin();
+        for (const auto &[body, preceding] : this->bodies_ahead) {
+            const auto until = this->diagnostics.begin() + static_cast<std::ptrdiff_t>(preceding);
+            logger::Logger::print(std::vector<std::string>(printed, until));
+            logger::Logger::print(body->diagnostics);
+            printed = until;
+        }
+        logger::Logger::print(std::vector<std::string>(printed, this->diagnostics.end()));
+    }
+
     std::optional<Parser::StatementsVec> Parser::parse()
     {
+        // Errors of the top level are held back until those of the bodies parsed concurrently are known.
+        if (this->options.body_pool) { logger::Logger::capture(&this->diagnostics); }
+        utils::ScopeGuard print([this]() { this->print_diagnostics(); });
+
         StatementsVec out;
         try {
             while (!this->is_at_end()) { out.push_back(this->declaration()); }
@@ -4,58 +4,175 @@
 #include "../exceptions/Exceptions.hpp"
 #include "../logger/Logger.hpp"
 #include "../tokenizer/Token.hpp"
+#include "../tokenizer/Tokenizer.hpp"
+#include "../utils/guard.hpp"
+#include "../utils/iterable_stack.hpp"
+#include "../utils/ring_buffer.hpp"
+#include "../utils/span.hpp"
+#include "../utils/thread_pool.hpp"
+#include "Ast.hpp"
 #include "Expressions.hpp"
 #include "Statements.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 namespace tek::parser {
+    struct ParseOptions
+    {
+        // Bind variables to their declarations as they are parsed, doing the work of the separate Resolver pass. Its
+        // errors are reported along with the syntax errors.
+        bool resolve_names = false;
+
+        // Only brace match function bodies and parse them on the first call, see DeferredBody. Syntax errors in
+        // functions that are never called go unreported.
+        bool defer_function_bodies = false;
+
+        // Along with defer_function_bodies, parse and resolve the bodies on this pool as soon as they are brace matched
+        // rather than on their first call. Errors are all reported, in source order.
+        utils::thread_pool *body_pool = nullptr;
+    };
+
     class Parser
     {
       private:
-        using TokensVec     = std::vector<tokenizer::Token>;
-        using ExpressionPtr = std::unique_ptr<Expression>;
-        using StatementPtr  = std::unique_ptr<Statement>;
-        using StatementsVec = std::vector<StatementPtr>;
+        using StatementsVec  = std::vector<StatementId>;
+        using StatementRange = Ast::StatementRange;
 
       public:
-        explicit Parser(TokensVec tokens);
+        // Tokens are pulled from the tokenizer on demand, only a small window around the current one is kept.
+        // Nodes are allocated in `ast`, which has to outlive the returned statements.
+        Parser(tokenizer::Tokenizer &tokenizer, Ast &ast, const ParseOptions options = {});
+
+        // Parses tokens scanned beforehand, which have to end with an ENDOF token. `source` is the source they were
+        // scanned from, deferred function bodies are sliced out of it.
+        Parser(
+          utils::span<const tokenizer::Token> tokens,
+          std::string_view                    source,
+          Ast                                &ast,
+          const ParseOptions                  options = {});
+
         [[nodiscard]] std::optional<StatementsVec> parse();
 
+        // Parses a single top-level declaration, nullopt if it has errors. They are reported and the tokens up to the
+        // next likely declaration skipped, so that parsing can go on.
+        [[nodiscard]] std::optional<StatementId> parse_declaration();
+
+        [[nodiscard]] bool is_at_end();
+
+        // Number of tokens consumed so far.
+        [[nodiscard]] std::size_t position() const;
+
+        // The token after the last one consumed, scanned if that didn't happen yet.
+        [[nodiscard]] const tokenizer::Token &current_token();
+
+        // Parses `body` if that didn't happen yet, false if it has errors. They are reported once, on the first try.
+        [[nodiscard]] static bool parse_deferred(DeferredBody &body);
+
       private:
-        [[nodiscard]] ExpressionPtr expression();
-        [[nodiscard]] ExpressionPtr equality();
-        [[nodiscard]] ExpressionPtr assignment();
-        [[nodiscard]] ExpressionPtr comparison();
-        [[nodiscard]] ExpressionPtr term();
-        [[nodiscard]] ExpressionPtr factor();
-        [[nodiscard]] ExpressionPtr unary();
-        [[nodiscard]] ExpressionPtr primary();
-        [[nodiscard]] ExpressionPtr logical_or();
-        [[nodiscard]] ExpressionPtr logical_and();
-        [[nodiscard]] ExpressionPtr call();
-
-        [[nodiscard]] StatementPtr  statement();
-        [[nodiscard]] StatementPtr  declaration();
-        [[nodiscard]] StatementPtr  print_statement();
-        [[nodiscard]] StatementPtr  expression_statement();
-        [[nodiscard]] StatementPtr  var_statement();
-        [[nodiscard]] StatementsVec block_statement();
-        [[nodiscard]] StatementPtr  if_statement();
-        [[nodiscard]] StatementPtr  while_statement();
-        [[nodiscard]] StatementPtr  for_statement();
-        [[nodiscard]] StatementPtr  function_statement(const std::string &kind);
-        [[nodiscard]] StatementPtr  return_statement();
+        // Expressions are parsed by precedence climbing over explicit operand and operator stacks, so nesting depth
+        // is bounded by memory rather than by the native stack.
+        enum class Precedence : std::uint8_t {
+            NONE = 0,
+            ASSIGNMENT,
+            OR,
+            AND,
+            EQUALITY,
+            COMPARISON,
+            TERM,
+            FACTOR,
+            UNARY,
+        };
 
-        // for loop helpers
-        [[nodiscard]] StatementPtr  for_statement_initializer();
-        [[nodiscard]] ExpressionPtr for_statement_condition();
-        [[nodiscard]] ExpressionPtr for_statement_increment();
-        [[nodiscard]] StatementPtr  for_statement_body(ExpressionPtr &increment);
+        enum class OperatorKind : std::uint8_t {
+            NONE = 0,
+            PREFIX,
+            BINARY,
+            LOGICAL,
+            ASSIGN,
+            // Markers for an open '(' that either groups or calls, operators are never reduced across them.
+            GROUP,
+            CALL,
+        };
+
+        struct InfixRule
+        {
+            Precedence   precedence = Precedence::NONE;
+            OperatorKind kind       = OperatorKind::NONE;
+        };
+
+        struct PendingOperator
+        {
+            OperatorKind kind;
+            Precedence   precedence;
+            // Markers carry no token, the closing parenthesis is the one reported.
+            TokenId token;
+            // For markers, the index of the first operand they own: the grouped expression or the callee.
+            std::size_t operands_base;
+        };
+
+        struct Operand
+        {
+            ExpressionId expression;
+            // Set for a bare variable, the only valid assignment target.
+            bool is_variable;
+        };
+
+        using Operands         = std::vector<Operand>;
+        using PendingOperators = std::vector<PendingOperator>;
+        using InfixRules       = std::array<InfixRule, static_cast<std::size_t>(tokenizer::TokenType::COUNT)>;
+
+        [[nodiscard]] static constexpr InfixRules make_infix_rules();
+        [[nodiscard]] static const InfixRule     &infix_rule(const tokenizer::TokenType type);
+
+        [[nodiscard]] ExpressionId expression();
+        [[nodiscard]] Operand      primary();
 
-        // call helpers
-        [[nodiscard]] ExpressionPtr finish_call(ExpressionPtr &expression);
+        // expression helpers
+        // Reduces pending operators binding tighter than `precedence`, stopping at the innermost open marker.
+        void reduce(Operands &operands, PendingOperators &operators, const Precedence precedence, const bool right);
+        void reduce_top(Operands &operands, PendingOperators &operators);
+        void close_marker(Operands &operands, PendingOperators &operators);
+
+        [[nodiscard]] static std::string marker_message(const OperatorKind marker);
+
+        [[nodiscard]] StatementId    statement();
+        [[nodiscard]] StatementId    declaration();
+        [[nodiscard]] StatementId    print_statement();
+        [[nodiscard]] StatementId    expression_statement();
+        [[nodiscard]] StatementId    var_statement();
+        [[nodiscard]] StatementRange block_statement();
+        [[nodiscard]] StatementId    if_statement();
+        [[nodiscard]] StatementId    while_statement();
+        [[nodiscard]] StatementId    for_statement();
+        [[nodiscard]] StatementId    function_statement(const std::string &kind);
+        [[nodiscard]] StatementId    return_statement();
+        [[nodiscard]] StatementId    yield_statement();
+
+        // Skips the rest of a block whose '{' was just consumed, returns the offset of the matching '}'.
+        std::size_t skip_block();
+
+        // Parses `body` into `ast`, which it keeps only if there were no errors.
+        static void parse_body(DeferredBody &body, const std::shared_ptr<Ast> &ast);
+
+        // Hands a body to the body pool, with its errors kept to be printed after those reported before it. Bodies go
+        // in batches sharing an Ast, one each would cost a few chunks per node kind.
+        void parse_ahead(DeferredBody &body);
+        void submit_batch();
+        void print_diagnostics();
+
+        // for loop helpers
+        [[nodiscard]] StatementId  for_statement_initializer();
+        [[nodiscard]] ExpressionId for_statement_condition();
+        [[nodiscard]] ExpressionId for_statement_increment();
+        [[nodiscard]] StatementId  for_statement_body(const ExpressionId increment);
+        [[nodiscard]] StatementId  for_in_statement(const TokenId keyword);
 
         template<typename Match>
         [[nodiscard]] constexpr bool match(Match &&match);
@@ -64,20 +181,71 @@ namespace tek::parser {
         [[nodiscard]] constexpr bool match(Matches &&...matches);
 
         bool check(const tokenizer::TokenType &type);
-        bool is_at_end();
 
-        tokenizer::Token advance();
-        tokenizer::Token peek();
-        tokenizer::Token previous();
-        tokenizer::Token consume(const tokenizer::TokenType &type, const std::string &message);
+        [[nodiscard]] tokenizer::Token next_token();
+
+        const tokenizer::Token &advance();
+        // `ahead` tokens past the current one, at most two.
+        const tokenizer::Token &peek(std::size_t ahead = 0);
+        const tokenizer::Token &previous();
+        const tokenizer::Token &consume(const tokenizer::TokenType &type, const std::string &message);
 
         void synchronize();
 
         static exceptions::ParseError error(const tokenizer::Token &token, const std::string &message);
 
+        // name resolution helpers
+        enum class FunctionType {
+            NONE = 0,
+            FUNCTION,
+            GENERATOR,
+        };
+
+        using ScopesStack = utils::iterable_stack<Scope>;
+
+        void begin_scope();
+        void end_scope();
+        void declare(const tokenizer::Token &name);
+        void define(const tokenizer::Token &name);
+        void report(const tokenizer::Token &token, const std::string &message);
+
+        // Statements and function declarations one level deeper, an error past max_nesting. The caller steps back out.
+        void enter_nested();
+
+        [[nodiscard]] Depth resolve_read(const tokenizer::Token &name);
+        [[nodiscard]] Depth resolve_local(const tokenizer::Token &name) const;
+
       private:
-        TokensVec   tokens;
-        std::size_t current;
+        // Room for the previous token, the current one and some lookahead.
+        static constexpr std::size_t window_size = 4;
+
+        // Tokens come either from the tokenizer or from the scanned ones, when there is no tokenizer.
+        tokenizer::Tokenizer               *tokenizer;
+        utils::span<const tokenizer::Token> scanned;
+        std::string_view                    source;
+
+        Ast                                              &ast;
+        utils::ring_buffer<tokenizer::Token, window_size> window;
+        std::size_t                                       current;
+
+        ParseOptions options;
+        ScopesStack  scopes;
+        FunctionType current_function = FunctionType::NONE;
+        bool         had_error        = false;
+
+        // Unlike expressions, statements and function bodies are parsed by recursion. Nesting them deeper than this is
+        // a parse error rather than a native stack overflow.
+        static constexpr std::size_t max_nesting = 2048;
+        std::size_t                  nesting     = 0;
+
+        // Source bytes of the bodies handed to the body pool at once.
+        static constexpr std::size_t min_batch_bytes = 64 * 1024;
+
+        // Bodies parsed ahead on the body pool, and how many of the parser's own errors came before each of them.
+        std::vector<std::pair<DeferredBody *, std::size_t>> bodies_ahead;
+        std::vector<DeferredBody *>                         batch;
+        std::size_t                                         batch_bytes = 0;
+        std::vector<std::string>                            diagnostics;
     };
 }// namespace tek::parser
 
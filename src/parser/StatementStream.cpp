@@ -0,0 +1,87 @@
+#include "StatementStream.hpp"
+
+#include "../logger/Logger.hpp"
+#include "../tokenizer/Tokenizer.hpp"
+#include "../utils/guard.hpp"
+#include "Parser.hpp"
+#include <algorithm>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace tek::parser {
+    StatementStream::StatementStream(std::istream &input) : input{ &input } {}
+
+    std::optional<StreamedDeclaration> StatementStream::next()
+    {
+        while (true) {
+            auto                       ast = std::make_shared<Ast>();
+            std::optional<StatementId> statement;
+            std::vector<std::string>   diagnostics;
+            bool                       cut;
+
+            // Errors are held back until it is known they aren't due to the text read so far ending mid declaration.
+            const bool had_error = logger::Logger::had_error;
+            {
+                logger::Logger::capture(&diagnostics);
+                utils::ScopeGuard release([]() { logger::Logger::capture(nullptr); });
+
+                const auto           view = std::string_view(this->text).substr(0, this->complete);
+                tokenizer::Tokenizer tokenizer(view, this->line, this->start);
+                Parser               parser(tokenizer, *ast, ParseOptions{ true, false });
+
+                if (!parser.is_at_end()) { statement = parser.parse_declaration(); }
+
+                // The declaration might go on, an 'else' for example, past the end of what was read.
+                cut = parser.is_at_end() && !this->at_end;
+                if (!cut) {
+                    const auto &next = parser.current_token();
+                    this->start      = next.offset;
+                    this->line       = next.line - static_cast<std::size_t>(std::count(
+                                                 next.lexeme.begin(), next.lexeme.end(), '\n'));
+                }
+            }
+
+            if (cut) {
+                logger::Logger::had_error = had_error;
+                this->read_more();
+                continue;
+            }
+
+            logger::Logger::print(diagnostics);
+            if (!statement) { return std::nullopt; }
+
+            this->compact();
+            return StreamedDeclaration{ std::move(ast), *statement };
+        }
+    }
+
+    void StatementStream::read_more()
+    {
+        const auto wanted = std::max(block_bytes, this->complete - this->start);
+        const auto size   = this->text.size();
+
+        this->text.resize(size + wanted);
+        this->input->read(this->text.data() + size, static_cast<std::streamsize>(wanted));
+        this->text.resize(size + static_cast<std::size_t>(this->input->gcount()));
+
+        if (!*this->input) {
+            this->at_end   = true;
+            this->complete = this->text.size();
+            return;
+        }
+
+        // Only a string can span lines, a cut one is parsed as ending with the text and then again with more.
+        const auto newline = this->text.rfind('\n');
+        if (newline != std::string::npos && newline >= this->complete) { this->complete = newline + 1; }
+    }
+
+    void StatementStream::compact()
+    {
+        if (this->start < block_bytes || this->start * 2 < this->text.size()) { return; }
+
+        this->text.erase(0, this->start);
+        this->complete -= this->start;
+        this->start = 0;
+    }
+}// namespace tek::parser
@@ -0,0 +1,55 @@
+#ifndef TEK_STATEMENT_STREAM_HPP
+#define TEK_STATEMENT_STREAM_HPP
+
+#include "Ast.hpp"
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace tek::parser {
+    // A top-level declaration in an Ast of its own, which is released once nothing refers to it anymore.
+    struct StreamedDeclaration
+    {
+        std::shared_ptr<Ast> ast;
+        StatementId          statement;
+    };
+
+    // Parses a script a top-level declaration at a time as it is read, so that memory doesn't grow with its length.
+    // Only the text from the start of the current declaration on is kept, read a block at a time and cut at the last
+    // complete line. A declaration whose parse ran into the end of the text read so far is parsed again once more of
+    // it is read. Names are resolved while parsing and function bodies are never deferred, the text they would be
+    // sliced from doesn't last.
+    class StatementStream
+    {
+      public:
+        // `input` is read as declarations are asked for, it has to outlive the stream.
+        explicit StatementStream(std::istream &input);
+
+        // The next declaration, nullopt at the end of the input or at the first one with errors, reported by then.
+        [[nodiscard]] std::optional<StreamedDeclaration> next();
+
+      private:
+        // Reads at least a block, or as much as the current declaration spans so far so that long ones are parsed
+        // again only a logarithmic number of times.
+        void read_more();
+
+        // Drops the text before the current declaration once it is most of what is kept.
+        void compact();
+
+      private:
+        static constexpr std::size_t block_bytes = 64 * 1024;
+
+        std::istream *input;
+        bool          at_end = false;
+
+        // Text read so far, [start, complete) is what the current declaration is parsed out of.
+        std::string text;
+        std::size_t start    = 0;
+        std::size_t complete = 0;
+        std::size_t line     = 1;
+    };
+}// namespace tek::parser
+
+#endif// TEK_STATEMENT_STREAM_HPP
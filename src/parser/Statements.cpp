@@ -2,109 +2,54 @@
 
 namespace tek::parser {
 
-    PrintStatement::PrintStatement(Statement::ExpressionPtr expression) : expression{ std::move(expression) } {}
-
-    std::string PrintStatement::accept(StatementVisitor<std::string> &visitor)
-    {
-        return visitor.visit_print_statement(*this);
-    }
-
-    void PrintStatement::accept(StatementVisitor<void> &visitor) { return visitor.visit_print_statement(*this); }
-
-    ExpressionStatement::ExpressionStatement(Statement::ExpressionPtr expression) : expression{ std::move(expression) }
+    PrintStatement::PrintStatement(ExpressionId expression)
+      : Statement(StatementKind::PRINT), expression{ expression }
     {}
 
-    std::string ExpressionStatement::accept(StatementVisitor<std::string> &visitor)
-    {
-        return visitor.visit_expression_statement(*this);
-    }
-
-    void ExpressionStatement::accept(StatementVisitor<void> &visitor)
-    {
-        return visitor.visit_expression_statement(*this);
-    }
-
-    VarStatement::VarStatement(tokenizer::Token name, Statement::ExpressionPtr initializer)
-      : name{ std::move(name) }, initializer{ std::move(initializer) }
+    ExpressionStatement::ExpressionStatement(ExpressionId expression)
+      : Statement(StatementKind::EXPRESSION), expression{ expression }
     {}
 
-    std::string VarStatement::accept(StatementVisitor<std::string> &visitor)
-    {
-        return visitor.visit_var_statement(*this);
-    }
-
-    void VarStatement::accept(StatementVisitor<void> &visitor) { return visitor.visit_var_statement(*this); }
-
-    BlockStatement::BlockStatement(BlockStatement::StatementsVec statements) : statements{ std::move(statements) } {}
-
-    std::string BlockStatement::accept(StatementVisitor<std::string> &visitor)
-    {
-        return visitor.visit_block_statement(*this);
-    }
-
-    void BlockStatement::accept(StatementVisitor<void> &visitor) { return visitor.visit_block_statement(*this); }
-
-    IfStatement::IfStatement(
-      Statement::ExpressionPtr  condition,
-      IfStatement::StatementPtr then_branch,
-      IfStatement::StatementPtr else_branch)
-      : condition{ std::move(condition) }, then_branch{ std::move(then_branch) }, else_branch{ std::move(else_branch) }
+    VarStatement::VarStatement(TokenId name, ExpressionId initializer)
+      : Statement(StatementKind::VAR), name{ name }, initializer{ initializer }
     {}
 
-    std::string IfStatement::accept(StatementVisitor<std::string> &visitor)
-    {
-        return visitor.visit_if_statement(*this);
-    }
-
-    void IfStatement::accept(StatementVisitor<void> &visitor) { return visitor.visit_if_statement(*this); }
-
-    WhileStatement::WhileStatement(Statement::ExpressionPtr condition, WhileStatement::StatementPtr body)
-      : condition{ std::move(condition) }, body{ std::move(body) }
+    BlockStatement::BlockStatement(StatementRange statements)
+      : Statement(StatementKind::BLOCK), statements{ statements }
     {}
 
-    std::string WhileStatement::accept(StatementVisitor<std::string> &visitor)
-    {
-        return visitor.visit_while_statement(*this);
-    }
-
-    void WhileStatement::accept(StatementVisitor<void> &visitor) { return visitor.visit_while_statement(*this); }
+    IfStatement::IfStatement(ExpressionId condition, StatementId then_branch, StatementId else_branch)
+      : Statement(StatementKind::IF), condition{ condition }, then_branch{ then_branch }, else_branch{ else_branch }
+    {}
 
-    ForStatement::ForStatement(
-      ForStatement::StatementPtr initializer,
-      Statement::ExpressionPtr   condition,
-      ForStatement::StatementPtr body)
-      : initializer{ std::move(initializer) }, condition{ std::move(condition) }, body{ std::move(body) }
+    WhileStatement::WhileStatement(TokenId keyword, ExpressionId condition, StatementId body)
+      : Statement(StatementKind::WHILE), keyword{ keyword }, condition{ condition }, body{ body }
     {}
 
-    std::string ForStatement::accept(StatementVisitor<std::string> &visitor)
-    {
-        return visitor.visit_for_statement(*this);
-    }
+    ForStatement::ForStatement(TokenId keyword, StatementId initializer, ExpressionId condition, StatementId body)
+      : Statement(StatementKind::FOR), keyword{ keyword }, initializer{ initializer }, condition{ condition },
+        body{ body }
+    {}
 
-    void ForStatement::accept(StatementVisitor<void> &visitor) { return visitor.visit_for_statement(*this); }
+    ForInStatement::ForInStatement(TokenId keyword, TokenId name, ExpressionId iterable, StatementId body)
+      : Statement(StatementKind::FOR_IN), keyword{ keyword }, name{ name }, iterable{ iterable }, body{ body }
+    {}
 
     FunctionStatement::FunctionStatement(
-      tokenizer::Token              name,
-      std::vector<tokenizer::Token> parameters,
-      StatementsVec                 body)
-      : name{ std::move(name) }, parameters{ std::move(parameters) }, body{ std::move(body) }
+      TokenId        name,
+      TokenRange     parameters,
+      StatementRange body,
+      std::uint32_t  deferred_body,
+      bool           generator)
+      : Statement(StatementKind::FUNCTION), name{ name }, parameters{ parameters }, body{ body },
+        deferred_body{ deferred_body }, generator{ generator }
     {}
 
-    std::string FunctionStatement::accept(StatementVisitor<std::string> &visitor)
-    {
-        return visitor.visit_function_statement(*this);
-    }
-
-    void FunctionStatement::accept(StatementVisitor<void> &visitor) { visitor.visit_function_statement(*this); }
-
-    ReturnStatement::ReturnStatement(tokenizer::Token keyword, Statement::ExpressionPtr expression)
-      : keyword{ std::move(keyword) }, expression{ std::move(expression) }
+    ReturnStatement::ReturnStatement(TokenId keyword, ExpressionId expression)
+      : Statement(StatementKind::RETURN), keyword{ keyword }, expression{ expression }
     {}
 
-    std::string ReturnStatement::accept(StatementVisitor<std::string> &visitor)
-    {
-        return visitor.visit_return_statement(*this);
-    }
-
-    void ReturnStatement::accept(StatementVisitor<void> &visitor) { return visitor.visit_return_statement(*this); }
+    YieldStatement::YieldStatement(TokenId keyword, ExpressionId value)
+      : Statement(StatementKind::YIELD), keyword{ keyword }, value{ value }
+    {}
 }// namespace tek::parser
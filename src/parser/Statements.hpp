@@ -5,7 +5,8 @@
 #include "../tokenizer/Token.hpp"
 #include "../types/Literal.hpp"
 #include "Expressions.hpp"
-#include <memory>
+#include "NodeId.hpp"
+#include <cstdint>
 #include <utility>
 #include <variant>
 
@@ -14,152 +15,146 @@ namespace tek::parser {
     template<typename ReturnType>
     class StatementVisitor;
 
+    // Nodes carry their kind instead of a vtable, see dispatch() in Dispatch.hpp.
     class Statement
     {
       public:
-        virtual std::string accept(StatementVisitor<std::string> &visitor) = 0;
-        virtual void        accept(StatementVisitor<void> &visitor)        = 0;
+        StatementKind kind;
 
       protected:
-        using ExpressionPtr = std::unique_ptr<Expression>;
+        using StatementRange = NodeRange<StatementId>;
+        using TokenRange     = NodeRange<TokenId>;
+
+        explicit Statement(const StatementKind kind) : kind{ kind } {}
     };
 
     class PrintStatement : public Statement
     {
       public:
-        explicit PrintStatement(ExpressionPtr expression);
-
-        std::string accept(StatementVisitor<std::string> &visitor) override;
-        void        accept(StatementVisitor<void> &visitor) override;
+        explicit PrintStatement(ExpressionId expression);
 
       public:
-        ExpressionPtr expression;
+        ExpressionId expression;
     };
 
     class ExpressionStatement : public Statement
     {
       public:
-        explicit ExpressionStatement(ExpressionPtr expression);
-
-        std::string accept(StatementVisitor<std::string> &visitor) override;
-        void        accept(StatementVisitor<void> &visitor) override;
+        explicit ExpressionStatement(ExpressionId expression);
 
       public:
-        ExpressionPtr expression;
+        ExpressionId expression;
     };
 
     class VarStatement : public Statement
     {
       public:
-        VarStatement(tokenizer::Token name, ExpressionPtr initializer);
-
-        std::string accept(StatementVisitor<std::string> &visitor) override;
-        void        accept(StatementVisitor<void> &visitor) override;
+        VarStatement(TokenId name, ExpressionId initializer);
 
       public:
-        tokenizer::Token name;
-        ExpressionPtr    initializer;
+        TokenId      name;
+        ExpressionId initializer;
     };
 
 
     class BlockStatement : public Statement
     {
-      private:
-        using StatementPtr  = std::unique_ptr<Statement>;
-        using StatementsVec = std::vector<StatementPtr>;
-
       public:
-        explicit BlockStatement(StatementsVec statements);
-
-        std::string accept(StatementVisitor<std::string> &visitor) override;
-        void        accept(StatementVisitor<void> &visitor) override;
+        explicit BlockStatement(StatementRange statements);
 
       public:
-        StatementsVec statements;
+        StatementRange statements;
     };
 
     class IfStatement : public Statement
     {
-      private:
-        using StatementPtr = std::unique_ptr<Statement>;
-
       public:
-        IfStatement(ExpressionPtr condition, StatementPtr then_branch, StatementPtr else_branch);
-
-        std::string accept(StatementVisitor<std::string> &visitor) override;
-        void        accept(StatementVisitor<void> &visitor) override;
+        IfStatement(ExpressionId condition, StatementId then_branch, StatementId else_branch);
 
       public:
-        ExpressionPtr condition;
-        StatementPtr  then_branch;
-        StatementPtr  else_branch;
+        ExpressionId condition;
+        StatementId  then_branch;
+        StatementId  else_branch;
     };
 
     class WhileStatement : public Statement
     {
-      private:
-        using StatementPtr = std::unique_ptr<Statement>;
-
       public:
-        WhileStatement(ExpressionPtr condition, StatementPtr body);
-
-        std::string accept(StatementVisitor<std::string> &visitor) override;
-        void        accept(StatementVisitor<void> &visitor) override;
+        WhileStatement(TokenId keyword, ExpressionId condition, StatementId body);
 
       public:
-        ExpressionPtr condition;
-        StatementPtr  body;
+        TokenId      keyword;
+        ExpressionId condition;
+        StatementId  body;
     };
 
     class ForStatement : public Statement
     {
-      private:
-        using StatementPtr = std::unique_ptr<Statement>;
+      public:
+        ForStatement(TokenId keyword, StatementId initializer, ExpressionId condition, StatementId body);
 
       public:
-        ForStatement(StatementPtr initializer, ExpressionPtr condition, StatementPtr body);
+        TokenId      keyword;
+        StatementId  initializer;
+        ExpressionId condition;
+        StatementId  body;
+    };
 
-        std::string accept(StatementVisitor<std::string> &visitor) override;
-        void        accept(StatementVisitor<void> &visitor) override;
+    // `for (var name in iterable) body`, over what a generator yields.
+    class ForInStatement : public Statement
+    {
+      public:
+        ForInStatement(TokenId keyword, TokenId name, ExpressionId iterable, StatementId body);
 
       public:
-        StatementPtr  initializer;
-        ExpressionPtr condition;
-        StatementPtr  body;
+        TokenId      keyword;
+        TokenId      name;
+        ExpressionId iterable;
+        StatementId  body;
     };
 
     class FunctionStatement : public Statement
     {
-      private:
-        using StatementPtr  = std::unique_ptr<Statement>;
-        using StatementsVec = std::vector<StatementPtr>;
-
       public:
-        FunctionStatement(tokenizer::Token name, std::vector<tokenizer::Token> parameters, StatementsVec body);
+        static constexpr std::uint32_t no_deferred_body = ~std::uint32_t{ 0 };
 
-        std::string accept(StatementVisitor<std::string> &visitor) override;
-        void        accept(StatementVisitor<void> &visitor) override;
+        FunctionStatement(
+          TokenId        name,
+          TokenRange     parameters,
+          StatementRange body,
+          std::uint32_t  deferred_body,
+          bool           generator);
+
+        [[nodiscard]] bool is_deferred() const { return this->deferred_body != no_deferred_body; }
 
       public:
-        tokenizer::Token              name;
-        std::vector<tokenizer::Token> parameters;
-        StatementsVec                 body;
+        TokenId        name;
+        TokenRange     parameters;
+        StatementRange body;
+        // Index into the deferred bodies of the Ast when parsing the body was deferred, `body` is empty then.
+        std::uint32_t deferred_body;
+        // Declared with `fun*`, calls give a generator running the body up to each `yield`.
+        bool generator;
     };
 
     class ReturnStatement : public Statement
     {
-      private:
-        using StatementPtr = std::unique_ptr<Statement>;
+      public:
+        ReturnStatement(TokenId keyword, ExpressionId expression);
 
       public:
-        ReturnStatement(tokenizer::Token keyword, ExpressionPtr expression);
+        TokenId      keyword;
+        ExpressionId expression;
+    };
 
-        std::string accept(StatementVisitor<std::string> &visitor) override;
-        void        accept(StatementVisitor<void> &visitor) override;
+    class YieldStatement : public Statement
+    {
+      public:
+        YieldStatement(TokenId keyword, ExpressionId value);
 
       public:
-        tokenizer::Token keyword;
-        ExpressionPtr    expression;
+        TokenId      keyword;
+        ExpressionId value;
     };
 
     template<typename ReturnType>
@@ -175,6 +170,8 @@ namespace tek::parser {
         virtual ReturnType visit_for_statement(ForStatement &statement)               = 0;
         virtual ReturnType visit_function_statement(FunctionStatement &statement)     = 0;
         virtual ReturnType visit_return_statement(ReturnStatement &statement)         = 0;
+        virtual ReturnType visit_yield_statement(YieldStatement &statement)           = 0;
+        virtual ReturnType visit_for_in_statement(ForInStatement &statement)          = 0;
     };
 }// namespace tek::parser
 
@@ -0,0 +1,300 @@
+#include "Server.hpp"
+
+#include "../utils/binary.hpp"
+#include "../utils/fs.hpp"
+#include "../utils/hash.hpp"
+#include "../utils/thread_pool.hpp"
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fmt/format.h>
+#include <iostream>
+#include <iterator>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <utility>
+
+namespace tek::server {
+    namespace {
+        // A request is a single frame, a script path or source. The response is an output frame for every line as the
+        // script prints it, then an error frame followed by the exit status. Frames are a kind byte and a 64-bit size
+        // followed by as many bytes, the status a 32-bit int.
+        enum class Frame : std::uint8_t {
+            PATH   = 'P',
+            SOURCE = 'S',
+            OUTPUT = 'O',
+            ERRORS = 'E',
+            EXIT   = 'X'
+        };
+
+        [[nodiscard]] bool write_all(const int descriptor, std::string_view bytes)
+        {
+            while (!bytes.empty()) {
+                const auto count = write(descriptor, bytes.data(), bytes.size());
+                if (count < 0 && errno == EINTR) { continue; }
+                if (count <= 0) { return false; }
+                bytes.remove_prefix(static_cast<std::size_t>(count));
+            }
+            return true;
+        }
+
+        [[nodiscard]] bool read_exact(const int descriptor, void *destination, std::size_t size)
+        {
+            auto *bytes = static_cast<char *>(destination);
+            while (size > 0) {
+                const auto count = read(descriptor, bytes, size);
+                if (count < 0 && errno == EINTR) { continue; }
+                if (count <= 0) { return false; }
+                bytes += count;
+                size -= static_cast<std::size_t>(count);
+            }
+            return true;
+        }
+
+        // Like read_exact(), failing once `deadline` has passed without all of `size` bytes in.
+        [[nodiscard]] bool read_before(
+          const int                                   descriptor,
+          void                                       *destination,
+          std::size_t                                 size,
+          const std::chrono::steady_clock::time_point deadline)
+        {
+            auto *bytes = static_cast<char *>(destination);
+            while (size > 0) {
+                const auto left = deadline - std::chrono::steady_clock::now();
+                if (left <= left.zero()) { return false; }
+
+                pollfd     ready{ descriptor, POLLIN, 0 };
+                const auto timeout = std::chrono::ceil<std::chrono::milliseconds>(left).count();
+                const auto polled  = poll(&ready, 1, static_cast<int>(timeout));
+                if (polled < 0 && errno == EINTR) { continue; }
+                if (polled <= 0) { return false; }
+
+                const auto count = read(descriptor, bytes, size);
+                if (count < 0 && errno == EINTR) { continue; }
+                if (count <= 0) { return false; }
+                bytes += count;
+                size -= static_cast<std::size_t>(count);
+            }
+            return true;
+        }
+
+        [[nodiscard]] std::string frame(const Frame kind, const std::string_view payload)
+        {
+            utils::ByteWriter writer;
+            writer.put(kind);
+            writer.put<std::uint64_t>(payload.size());
+            writer.bytes.append(payload);
+            return std::move(writer.bytes);
+        }
+
+        // Requests larger than this are dropped rather than allocated for.
+        constexpr std::uint64_t max_request_bytes = std::uint64_t{ 1 } << 30;
+
+        // The whole request has to be in by then, a client that stalls or trickles it must not hold a worker.
+        constexpr std::chrono::seconds request_timeout{ 10 };
+
+        [[nodiscard]] std::optional<std::pair<Frame, std::string>> read_request(const int descriptor)
+        {
+            const auto    deadline = std::chrono::steady_clock::now() + request_timeout;
+            Frame         kind;
+            std::uint64_t size = 0;
+            if (!read_before(descriptor, &kind, sizeof(kind), deadline)
+                || !read_before(descriptor, &size, sizeof(size), deadline)) {
+                return std::nullopt;
+            }
+            if (size > max_request_bytes) { return std::nullopt; }
+
+            std::string payload(size, '\0');
+            if (!read_before(descriptor, payload.data(), payload.size(), deadline)) { return std::nullopt; }
+            return std::make_pair(kind, std::move(payload));
+        }
+
+        [[nodiscard]] std::optional<sockaddr_un> address_of(const std::filesystem::path &socket)
+        {
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+
+            const auto &path = socket.native();
+            if (path.size() >= sizeof(address.sun_path)) {
+                fmt::print(stderr, "Socket path too long: {}\n", path);
+                return std::nullopt;
+            }
+            std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+            return address;
+        }
+    }// namespace
+
+    Server::Server(std::filesystem::path socket, std::filesystem::path snapshot, const interpreter::Limits &limits)
+      : socket{ std::move(socket) }, snapshot{ std::move(snapshot) }, limits{ limits }
+    {}
+
+    int Server::serve()
+    {
+        // A client going away mid response must not take the server down with it.
+        std::signal(SIGPIPE, SIG_IGN);
+
+        if (!this->snapshot.empty() && !engine::Isolate().load_snapshot(this->snapshot)) {
+            fmt::print(stderr, "Invalid snapshot {}\n", this->snapshot.string());
+            return 1;
+        }
+
+        const auto address = address_of(this->socket);
+        if (!address) { return 1; }
+
+        const int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        unlink(this->socket.c_str());
+        if (listener < 0 || bind(listener, reinterpret_cast<const sockaddr *>(&*address), sizeof(*address)) != 0
+            || listen(listener, SOMAXCONN) != 0) {
+            fmt::print(stderr, "Unable to listen on {}: {}\n", this->socket.string(), std::strerror(errno));
+            return 1;
+        }
+
+        utils::thread_pool workers;
+        while (true) {
+            const int connection = accept(listener, nullptr, nullptr);
+            if (connection < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) { continue; }
+                fmt::print(stderr, "Unable to accept connections: {}\n", std::strerror(errno));
+                return 1;
+            }
+
+            workers.submit([this, connection]() {
+                this->handle(connection);
+                close(connection);
+            });
+        }
+    }
+
+    void Server::handle(const int connection)
+    {
+        // Workers keep their isolate from one request to the next.
+        thread_local std::optional<engine::Isolate> isolate;
+        if (!isolate) {
+            isolate.emplace();
+            isolate->set_limits(this->limits);
+            // Checked once in serve().
+            if (!this->snapshot.empty()) {
+                [[maybe_unused]] const auto loaded = isolate->load_snapshot(this->snapshot);
+            }
+        }
+
+        const auto request = read_request(connection);
+        if (!request) { return; }
+
+        // Once the client is gone what the script prints goes nowhere, the run is stopped instead.
+        bool       connected = true;
+        const auto print     = [&](const std::string_view output) {
+            connected = connected && write_all(connection, frame(Frame::OUTPUT, output));
+            if (!connected) { isolate->cancel(); }
+        };
+        const auto respond = [&](const std::string_view errors, const int status) {
+            utils::ByteWriter exit;
+            exit.put(Frame::EXIT);
+            exit.put<std::int32_t>(status);
+            [[maybe_unused]] const auto sent = connected && write_all(connection, frame(Frame::ERRORS, errors))
+                                               && write_all(connection, exit.bytes);
+        };
+
+        fs::SourceBuffer source;
+        if (request->first == Frame::PATH) {
+            std::error_code ec;
+            if (!std::filesystem::is_regular_file(request->second, ec)) {
+                return respond(fmt::format("No such file: {}", request->second), 1);
+            }
+            source = fs::read_file(request->second);
+        } else if (request->first == Frame::SOURCE) {
+            source = fs::SourceBuffer(request->second);
+        } else {
+            return;
+        }
+
+        // Errors read the same as on the command line.
+        const auto compiled = this->compile(source.view());
+        if (!compiled.script) {
+            std::string errors;
+            for (const auto &error : compiled.errors) { errors += error; }
+            return respond(errors, 1);
+        }
+
+        // Prints of the script's tasks come one at a time too, under the interpreter's output lock.
+        const auto  result = isolate->run(*compiled.script, {}, print);
+        std::string errors;
+        for (const auto &error : result.errors) { errors += error; }
+        if (!result.ok()) { print("Runtime error\n"); }
+        respond(errors, result.ok() ? 0 : 1);
+    }
+
+    engine::CompileResult Server::compile(const std::string_view source)
+    {
+        const auto key = utils::fnv1a(source);
+        {
+            std::lock_guard lock(this->cache_mutex);
+            if (const auto it = this->cache.find(key); it != this->cache.end() && it->second->source == source) {
+                return engine::CompileResult{ it->second->script, {} };
+            }
+        }
+
+        auto result = engine::Engine::compile(source);
+        if (!result.script) { return result; }
+
+        auto compiled = std::make_shared<Compiled>(Compiled{ std::string(source), *result.script });
+
+        std::lock_guard lock(this->cache_mutex);
+        if (this->cache.size() >= max_scripts) { this->cache.clear(); }
+        this->cache.insert_or_assign(key, std::move(compiled));
+        return result;
+    }
+
+    int request(const std::filesystem::path &socket, const std::string &script_path)
+    {
+        std::string request;
+        if (script_path == "-") {
+            const std::string source{ std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>() };
+            request = frame(Frame::SOURCE, source);
+        } else {
+            // The server resolves relative paths against its own working directory.
+            std::error_code ec;
+            const auto      absolute = std::filesystem::absolute(script_path, ec);
+            request = frame(Frame::PATH, ec ? script_path : absolute.string());
+        }
+
+        const auto address    = address_of(socket);
+        const int  connection = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (!address || connection < 0
+            || connect(connection, reinterpret_cast<const sockaddr *>(&*address), sizeof(*address)) != 0
+            || !write_all(connection, request)) {
+            fmt::print(stderr, "Unable to reach the server on {}\n", socket.string());
+            if (connection >= 0) { close(connection); }
+            return 1;
+        }
+
+        std::int32_t status = 1;
+        while (true) {
+            Frame kind;
+            if (!read_exact(connection, &kind, sizeof(kind))) { break; }
+
+            if (kind == Frame::EXIT) {
+                if (!read_exact(connection, &status, sizeof(status))) { status = 1; }
+                break;
+            }
+
+            std::uint64_t size = 0;
+            if ((kind != Frame::OUTPUT && kind != Frame::ERRORS) || !read_exact(connection, &size, sizeof(size))) {
+                break;
+            }
+
+            std::string bytes(size, '\0');
+            if (!read_exact(connection, bytes.data(), bytes.size())) { break; }
+            std::fwrite(bytes.data(), 1, bytes.size(), kind == Frame::OUTPUT ? stdout : stderr);
+        }
+
+        close(connection);
+        std::fflush(stdout);
+        std::fflush(stderr);
+        return status;
+    }
+}// namespace tek::server
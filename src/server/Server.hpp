@@ -0,0 +1,59 @@
+#ifndef TEK_SERVER_HPP
+#define TEK_SERVER_HPP
+
+#include "../engine/Engine.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace tek::server {
+    // Runs scripts sent over a Unix domain socket on a pool of warm isolates, so that a short job costs neither a
+    // process start nor, once it was seen, parsing. A connection carries one request, a script path or its source,
+    // and gets back what the script printed, its errors and the exit status the command line would have had.
+    class Server
+    {
+      public:
+        // Every worker starts its runs from the globals of `snapshot` if not empty and runs within `limits`, see
+        // engine::Isolate.
+        Server(std::filesystem::path socket, std::filesystem::path snapshot, const interpreter::Limits &limits = {});
+
+        // Serves until the process is stopped, 1 if the socket couldn't be set up.
+        [[nodiscard]] int serve();
+
+      private:
+        struct Compiled
+        {
+            std::string    source;
+            engine::Script script;
+        };
+
+        void handle(const int connection);
+
+        // Compiled scripts by hash of their source, the whole cache is dropped once it holds `max_scripts`. Errors
+        // are returned instead and not cached.
+        [[nodiscard]] engine::CompileResult compile(std::string_view source);
+
+      private:
+        static constexpr std::size_t max_scripts = 4096;
+
+        std::filesystem::path socket;
+        std::filesystem::path snapshot;
+        interpreter::Limits   limits;
+
+        std::mutex                                                   cache_mutex;
+        std::unordered_map<std::uint64_t, std::shared_ptr<Compiled>> cache;
+    };
+
+    // Sends the script at `script_path`, or the standard input for "-", to the server and writes its output to the
+    // standard output, its errors to the standard error. Returns the script's exit status, 1 if the server couldn't
+    // be reached.
+    [[nodiscard]] int request(const std::filesystem::path &socket, const std::string &script_path);
+}// namespace tek::server
+
+#endif// TEK_SERVER_HPP
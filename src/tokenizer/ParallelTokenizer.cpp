@@ -0,0 +1,155 @@
+#include "ParallelTokenizer.hpp"
+
+#include "Tokenizer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <utility>
+
+namespace tek::tokenizer {
+    namespace {
+        // Smaller chunks aren't worth a thread.
+        constexpr std::size_t min_chunk_bytes = 256 * 1024;
+
+        // More chunks than threads even out their load.
+        constexpr std::size_t chunks_per_thread = 4;
+
+        struct Chunk
+        {
+            std::size_t begin;
+            std::size_t end;
+
+            // Scanned as if the chunk didn't start inside a string, lines are counted from the chunk start.
+            std::vector<Token>     tokens;
+            std::vector<ScanError> errors;
+            std::size_t            newlines = 0;
+        };
+
+        [[nodiscard]] std::vector<Chunk> split(const std::string_view source, const std::size_t count)
+        {
+            std::vector<Chunk> chunks;
+            std::size_t        begin = 0;
+            for (std::size_t i = 1; i < count && begin < source.size(); ++i) {
+                const auto line_end = source.find('\n', std::max(begin, source.size() / count * i));
+                if (line_end == std::string_view::npos) { break; }
+
+                chunks.push_back(Chunk{ begin, line_end + 1, {}, {}, 0 });
+                begin = line_end + 1;
+            }
+            chunks.push_back(Chunk{ begin, source.size(), {}, {}, 0 });
+
+            return chunks;
+        }
+
+        void scan(const std::string_view source, Chunk &chunk)
+        {
+            const auto first = source.begin() + static_cast<std::ptrdiff_t>(chunk.begin);
+            const auto last  = source.begin() + static_cast<std::ptrdiff_t>(chunk.end);
+            chunk.newlines   = static_cast<std::size_t>(std::count(first, last, '\n'));
+
+            Tokenizer tokenizer(source, 0, chunk.begin);
+            tokenizer.collect_errors(chunk.errors);
+
+            // The last token may run past the end of the chunk, ENDOF never belongs to it.
+            for (auto token = tokenizer.next_token(); token.offset < chunk.end; token = tokenizer.next_token()) {
+                chunk.tokens.push_back(std::move(token));
+            }
+        }
+
+        void scan_all(const std::string_view source, std::vector<Chunk> &chunks, const std::size_t threads)
+        {
+            std::atomic<std::size_t> next{ 0 };
+            const auto               work = [&]() {
+                for (auto i = next++; i < chunks.size(); i = next++) { scan(source, chunks[i]); }
+            };
+
+            std::vector<std::thread> workers;
+            workers.reserve(threads - 1);
+            for (std::size_t i = 1; i < threads; ++i) { workers.emplace_back(work); }
+            work();
+
+            for (auto &worker : workers) { worker.join(); }
+        }
+    }// namespace
+
+    std::vector<Token> tokenize_parallel(const std::string_view source, std::size_t threads)
+    {
+        if (threads == 0) { threads = std::max(1u, std::thread::hardware_concurrency()); }
+
+        const auto count = std::min(threads * chunks_per_thread, source.size() / min_chunk_bytes);
+        if (threads == 1 || count < 2) {
+            Tokenizer tokenizer(source);
+            return tokenizer.tokenize();
+        }
+
+        auto chunks = split(source, count);
+        scan_all(source, chunks, std::min(threads, chunks.size()));
+
+        std::size_t total = 1;
+        for (const auto &chunk : chunks) { total += chunk.tokens.size(); }
+
+        std::vector<Token>     tokens;
+        std::vector<ScanError> errors;
+        tokens.reserve(total);
+
+        // The line the chunk starts on, and where the last token kept ends.
+        std::size_t line = 1;
+        std::size_t end  = 0;
+        for (auto &chunk : chunks) {
+            const auto base = line;
+            line += chunk.newlines;
+
+            // Speculative tokens are kept from the first one the actual scan starts too, past a string running into the
+            // chunk.
+            auto first = chunk.tokens.begin();
+            auto kept  = chunk.begin;
+            if (end > chunk.begin) {
+                first = chunk.tokens.end();
+                kept  = chunk.end;
+
+                // The token ending the string carries the line it ends on.
+                Tokenizer              tokenizer(source, tokens.back().line, end);
+                std::vector<ScanError> rescan_errors;
+                tokenizer.collect_errors(rescan_errors);
+
+                auto candidate = chunk.tokens.begin();
+                for (auto token = tokenizer.next_token(); token.offset < chunk.end; token = tokenizer.next_token()) {
+                    candidate = std::lower_bound(
+                      candidate,
+                      chunk.tokens.end(),
+                      token.offset,
+                      [](const Token &speculative, const std::size_t offset) { return speculative.offset < offset; });
+                    if (candidate != chunk.tokens.end() && candidate->offset == token.offset) {
+                        first = candidate;
+                        kept  = token.offset;
+                        break;
+                    }
+
+                    tokens.push_back(std::move(token));
+                }
+
+                for (const auto &error : rescan_errors) {
+                    if (error.offset < kept) { errors.push_back(error); }
+                }
+            }
+
+            for (const auto &error : chunk.errors) {
+                if (error.offset >= kept && error.offset < chunk.end) {
+                    errors.push_back(ScanError{ error.line + base, error.offset, error.character });
+                }
+            }
+
+            for (auto token = first; token != chunk.tokens.end(); ++token) {
+                tokens.push_back(std::move(*token));
+                tokens.back().line += base;
+            }
+
+            if (!tokens.empty()) { end = std::max(end, tokens.back().offset + tokens.back().lexeme.size()); }
+        }
+
+        for (const auto &error : errors) { error.report(); }
+
+        tokens.emplace_back(TokenType::ENDOF, "", types::Literal::variant_t{ "" }, line, source.size());
+        return tokens;
+    }
+}// namespace tek::tokenizer
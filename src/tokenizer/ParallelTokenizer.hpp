@@ -0,0 +1,19 @@
+#ifndef TEK_PARALLEL_TOKENIZER_HPP
+#define TEK_PARALLEL_TOKENIZER_HPP
+
+#include "Token.hpp"
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace tek::tokenizer {
+    // Scans `source` on up to `threads` threads, 0 for one per hardware thread. The tokens, their lines and the errors
+    // reported are the same as with Tokenizer::tokenize.
+    //
+    // The source is cut into chunks at line starts, each one is scanned assuming it doesn't start inside a string.
+    // Once they are all done the chunks are checked in order, one that did start inside a string is scanned again from
+    // the end of the string until its tokens line up with the speculative ones.
+    [[nodiscard]] std::vector<Token> tokenize_parallel(std::string_view source, std::size_t threads = 0);
+}// namespace tek::tokenizer
+
+#endif// TEK_PARALLEL_TOKENIZER_HPP
@@ -3,7 +3,7 @@
 namespace tek::tokenizer {
     std::string token_type_to_str(TokenType token_type)
     {
-        static_assert(static_cast<int>(TokenType::COUNT) == 39 && "Exhaustive handling for each token is required\n");
+        static_assert(static_cast<int>(TokenType::COUNT) == 43 && "Exhaustive handling for each token is required\n");
         switch (token_type) {
             case TokenType::LEFT_PAREN:
                 return "(";
@@ -68,6 +68,9 @@ namespace tek::tokenizer {
             case TokenType::AND:
                 return "and";
                 break;
+            case TokenType::AWAIT:
+                return "await";
+                break;
             case TokenType::CLASS:
                 return "class";
                 break;
@@ -86,6 +89,9 @@ namespace tek::tokenizer {
             case TokenType::IF:
                 return "if";
                 break;
+            case TokenType::IN:
+                return "in";
+                break;
             case TokenType::NIL:
                 return "nil";
                 break;
@@ -98,6 +104,9 @@ namespace tek::tokenizer {
             case TokenType::RETURN:
                 return "return";
                 break;
+            case TokenType::SPAWN:
+                return "spawn";
+                break;
             case TokenType::SUPER:
                 return "super";
                 break;
@@ -113,6 +122,9 @@ namespace tek::tokenizer {
             case TokenType::WHILE:
                 return "while";
                 break;
+            case TokenType::YIELD:
+                return "yield";
+                break;
             case TokenType::ENDOF:
                 return "EOF";
                 break;
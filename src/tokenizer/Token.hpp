@@ -39,21 +39,25 @@ namespace tek::tokenizer {
 
         // Keywords.
         AND,
+        AWAIT,
         CLASS,
         ELSE,
         FALSE,
         FUN,
         FOR,
         IF,
+        IN,
         NIL,
         OR,
         PRINT,
         RETURN,
+        SPAWN,
         SUPER,
         THIS,
         TRUE,
         VAR,
         WHILE,
+        YIELD,
 
         ENDOF,
         COUNT
@@ -67,9 +71,18 @@ namespace tek::tokenizer {
         std::string    lexeme;
         types::Literal literal;
         std::size_t    line;
+        // Position of the first character of the lexeme in the scanned source.
+        std::size_t offset;
 
-        Token(const TokenType &type, std::string lexeme, types::Literal::variant_t literal, const size_t line)
-          : type{ type }, lexeme{ std::move(lexeme) }, literal{ std::move(literal) }, line{ line } {};
+        Token() : Token(TokenType::ENDOF, "", types::Literal::variant_t{ "" }, 0) {}
+
+        Token(
+          const TokenType          &type,
+          std::string               lexeme,
+          types::Literal::variant_t literal,
+          const size_t              line,
+          const size_t              offset = 0)
+          : type{ type }, lexeme{ std::move(lexeme) }, literal{ std::move(literal) }, line{ line }, offset{ offset } {};
 
         [[nodiscard]] std::string to_string() const noexcept;
     };
@@ -1,21 +1,48 @@
 #include "Tokenizer.hpp"
 
+#include "scan.hpp"
 #include <utility>
 
 namespace tek::tokenizer {
-    Tokenizer::Tokenizer(std::string source_code) : source{ std::move(source_code) } {}
+    void ScanError::report() const
+    {
+        logger::Logger::error(
+          Token(TokenType::ENDOF, "", types::Literal::variant_t{ "" }, this->line),
+          fmt::format("Unexpected character: {}", this->character));
+    }
 
-    std::vector<Token> Tokenizer::tokenize()
+    Tokenizer::Tokenizer(std::string_view source_code, const std::size_t line, const std::size_t offset)
+      : start{ offset }, current{ offset }, line{ line }, source{ source_code }
+    {}
+
+    Token Tokenizer::next_token()
     {
-        while (!this->is_at_end()) {
+        while (true) {
+            this->skip_trivia();
+            if (this->is_at_end()) { break; }
+
             this->start = this->current;
-            this->scan_token();
+            if (auto token = this->scan_token()) { return std::move(*token); }
         }
 
-        this->tokens.emplace_back(TokenType::ENDOF, "", "", this->line);
-        return this->tokens;
+        return Token(TokenType::ENDOF, "", types::Literal::variant_t{ "" }, this->line, this->current);
+    }
+
+    std::vector<Token> Tokenizer::tokenize()
+    {
+        std::vector<Token> tokens;
+
+        do {
+            tokens.push_back(this->next_token());
+        } while (tokens.back().type != TokenType::ENDOF);
+
+        return tokens;
     }
 
+    std::string_view Tokenizer::source_code() const { return this->source; }
+
+    void Tokenizer::collect_errors(std::vector<ScanError> &errors) { this->errors = &errors; }
+
     bool Tokenizer::is_at_end() const { return this->current >= this->source.length(); }
 
     char Tokenizer::advance() { return this->source[this->current++]; }
@@ -42,131 +69,126 @@ namespace tek::tokenizer {
         return true;
     }
 
-    void Tokenizer::add_token(const TokenType type) { this->add_token(type, types::Literal::variant_t{ "" }); }
+    const char *Tokenizer::position() const { return this->source.data() + this->current; }
+
+    const char *Tokenizer::source_end() const { return this->source.data() + this->source.length(); }
 
-    void Tokenizer::add_token(const TokenType type, const types::Literal::variant_t &literal)
+    std::size_t Tokenizer::offset_of(const char *position) const
     {
-        const auto lexeme = this->source.substr(this->start, this->current - this->start);
-        this->tokens.emplace_back(type, lexeme, literal, this->line);
+        return static_cast<std::size_t>(position - this->source.data());
     }
 
-    void Tokenizer::string_literal()
+    void Tokenizer::skip_trivia()
     {
-        while (this->peek() != '"' && !this->is_at_end()) {
-            if (this->peek() == '\n') { this->line++; }
-            this->advance();
+        while (true) {
+            this->current = this->offset_of(scan::skip_whitespace(this->position(), this->source_end(), this->line));
+
+            if (this->peek() != '/' || this->peek_next() != '/') { return; }
+            this->current = this->offset_of(scan::find_line_end(this->position(), this->source_end()));
         }
+    }
 
-        this->advance();
+    Token Tokenizer::make_token(const TokenType type) const
+    {
+        return this->make_token(type, types::Literal::variant_t{ "" });
+    }
 
-        const auto string_literal = this->source.substr(this->start + 1, this->current - this->start - 2);
-        this->add_token(TokenType::STRING, types::Literal::variant_t{ string_literal });
+    Token Tokenizer::make_token(const TokenType type, types::Literal::variant_t literal) const
+    {
+        std::string lexeme(this->source.substr(this->start, this->current - this->start));
+        return Token(type, std::move(lexeme), std::move(literal), this->line, this->start);
     }
 
-    void Tokenizer::number_literal()
+    Token Tokenizer::string_literal()
     {
-        while (std::isdigit(this->peek())) { this->advance(); }
+        const char *const closing_quote = scan::find_string_end(this->position(), this->source_end(), this->line);
+
+        // An unterminated string runs until the end of the source.
+        const auto is_terminated = closing_quote != this->source_end();
+        const auto length        = this->offset_of(closing_quote) - this->start - 1;
+        this->current            = this->offset_of(closing_quote) + (is_terminated ? 1 : 0);
 
-        if (this->peek() == '.' && std::isdigit(this->peek_next())) {
+        std::string string_literal(this->source.substr(this->start + 1, length));
+        return this->make_token(TokenType::STRING, types::Literal::variant_t{ std::move(string_literal) });
+    }
+
+    Token Tokenizer::number_literal()
+    {
+        while (scan::is_digit(this->peek())) { this->advance(); }
+
+        if (this->peek() == '.' && scan::is_digit(this->peek_next())) {
             do {
                 this->advance();
-            } while (std::isdigit(this->peek()));
+            } while (scan::is_digit(this->peek()));
         }
 
-        const auto str_number = this->source.substr(this->start, this->current - this->start);
-        double     number{};
-        std::from_chars(str_number.data(), str_number.data() + str_number.size(), number);
-        this->add_token(TokenType::NUMBER, types::Literal::variant_t{ number });
+        double number{};
+        std::from_chars(this->source.data() + this->start, this->source.data() + this->current, number);
+        return this->make_token(TokenType::NUMBER, types::Literal::variant_t{ number });
     }
 
-    void Tokenizer::identifier()
+    Token Tokenizer::identifier()
     {
-        while (std::isalnum(this->peek())) { this->advance(); }
+        this->current = this->offset_of(scan::find_identifier_end(this->position(), this->source_end()));
 
-        const auto text       = this->source.substr(this->start, this->current - this->start);
-        const auto it         = Tokenizer::keywords.find(text);
-        auto       token_type = TokenType::IDENTIFIER;
-        if (it != Tokenizer::keywords.end()) { token_type = it->second; }
-        this->add_token(token_type);
+        const std::string_view text(this->source.data() + this->start, this->current - this->start);
+        return this->make_token(scan::keyword_or_identifier(text));
     }
 
-    void Tokenizer::scan_token()
+    std::optional<Token> Tokenizer::scan_token()
     {
         const char c = this->advance();
         switch (c) {
-            case '(': {
-                this->add_token(TokenType::LEFT_PAREN);
-                break;
-            }
+            case '(':
+                return this->make_token(TokenType::LEFT_PAREN);
             case ')':
-                this->add_token(TokenType::RIGHT_PAREN);
-                break;
+                return this->make_token(TokenType::RIGHT_PAREN);
             case '{':
-                this->add_token(TokenType::LEFT_BRACE);
-                break;
+                return this->make_token(TokenType::LEFT_BRACE);
             case '}':
-                this->add_token(TokenType::RIGHT_BRACE);
-                break;
+                return this->make_token(TokenType::RIGHT_BRACE);
             case ',':
-                this->add_token(TokenType::COMMA);
-                break;
+                return this->make_token(TokenType::COMMA);
             case '.':
-                this->add_token(TokenType::DOT);
-                break;
+                return this->make_token(TokenType::DOT);
             case '-':
-                this->add_token(TokenType::MINUS);
-                break;
+                return this->make_token(TokenType::MINUS);
             case '+':
-                this->add_token(TokenType::PLUS);
-                break;
+                return this->make_token(TokenType::PLUS);
             case ';':
-                this->add_token(TokenType::SEMICOLON);
-                break;
+                return this->make_token(TokenType::SEMICOLON);
             case '*':
-                this->add_token(TokenType::STAR);
-                break;
+                return this->make_token(TokenType::STAR);
             case '!':
-                this->add_token(match_next('=') ? TokenType::BANG_EQUAL : TokenType::BANG);
-                break;
+                return this->make_token(match_next('=') ? TokenType::BANG_EQUAL : TokenType::BANG);
             case '=':
-                this->add_token(match_next('=') ? TokenType::EQUAL_EQUAL : TokenType::EQUAL);
-                break;
+                return this->make_token(match_next('=') ? TokenType::EQUAL_EQUAL : TokenType::EQUAL);
             case '<':
-                this->add_token(match_next('=') ? TokenType::LESS_EQUAL : TokenType::LESS);
-                break;
+                return this->make_token(match_next('=') ? TokenType::LESS_EQUAL : TokenType::LESS);
             case '>':
-                this->add_token(match_next('=') ? TokenType::GREATER_EQUAL : TokenType::GREATER);
-                break;
+                return this->make_token(match_next('=') ? TokenType::GREATER_EQUAL : TokenType::GREATER);
+            // Comments and whitespace are already consumed by skip_trivia
             case '/':
-                if (this->match_next('/')) {
-                    while (this->peek() != '\n' && !this->is_at_end()) { this->advance(); }
-                } else {
-                    this->add_token(TokenType::SLASH);
-                }
-                break;
-            // Ignore whitespace character
-            case ' ':
-            case '\r':
-            case '\t':
-                break;
-            case '\n':
-                this->line++;
-                break;
+                return this->make_token(TokenType::SLASH);
             case '"':
-                this->string_literal();
-                break;
+                return this->string_literal();
             default:
-                if (std::isdigit(c)) {
-                    this->number_literal();
-                } else if (std::isalpha(c)) {
-                    this->identifier();
+                if (scan::is_digit(c)) {
+                    return this->number_literal();
+                } else if (scan::is_alpha(c)) {
+                    return this->identifier();
                 } else {
-                    logger::Logger::error(
-                      Token(TokenType::ENDOF, "", types::Literal::variant_t{ "" }, this->line),
-                      fmt::format("Unexpected character: {}", c));
+                    const ScanError error{ this->line, this->start, c };
+                    if (this->errors) {
+                        this->errors->push_back(error);
+                    } else {
+                        error.report();
+                    }
                 }
                 break;
         }
+
+        return std::nullopt;
     }
 
 }// namespace tek::tokenizer
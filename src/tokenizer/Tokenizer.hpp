@@ -2,20 +2,44 @@
 #define TOKENIZER_HPP
 
 #include <charconv>
+#include <optional>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 
 #include "../logger/Logger.hpp"
 #include "Token.hpp"
 
 namespace tek::tokenizer {
+    // A character no token starts with, it is skipped.
+    struct ScanError
+    {
+        std::size_t line;
+        std::size_t offset;
+        char        character;
+
+        void report() const;
+    };
+
     class Tokenizer
     {
       public:
-        explicit Tokenizer(std::string source_code);
+        // The source is scanned in place, it has to outlive the tokenizer and every token pulled from it.
+        // `line` is the line the source starts at, for sources cut out of a larger one. Scanning can also resume at
+        // `offset`, which has to be the start of a token of an earlier scan, `line` being the line of that token.
+        explicit Tokenizer(std::string_view source_code, const std::size_t line = 1, const std::size_t offset = 0);
+
+        // Pulls the next token out of the source, scanning only as far as needed to produce it.
+        // Once the source is exhausted every further call yields an ENDOF token.
+        [[nodiscard]] Token next_token();
 
-        std::vector<Token> tokenize();
+        // Drains the whole source at once, kept for callers that really need every token up front.
+        [[nodiscard]] std::vector<Token> tokenize();
+
+        [[nodiscard]] std::string_view source_code() const;
+
+        // Collects errors into `errors` instead of reporting them, for scans that may be thrown away.
+        void collect_errors(std::vector<ScanError> &errors);
 
       private:
         [[nodiscard]] bool is_at_end() const;
@@ -28,34 +52,33 @@ namespace tek::tokenizer {
 
         [[nodiscard]] bool match_next(const char expected);
 
-        void add_token(const TokenType type);
+        [[nodiscard]] const char *position() const;
+        [[nodiscard]] const char *source_end() const;
+        [[nodiscard]] std::size_t offset_of(const char *position) const;
+
+        // Skips whitespace and line comments in bulk, keeping track of line numbers.
+        void skip_trivia();
 
-        void add_token(const TokenType type, const types::Literal::variant_t &literal);
+        [[nodiscard]] Token make_token(const TokenType type) const;
 
-        void string_literal();
+        [[nodiscard]] Token make_token(const TokenType type, types::Literal::variant_t literal) const;
 
-        void number_literal();
+        [[nodiscard]] Token string_literal();
 
-        void identifier();
+        [[nodiscard]] Token number_literal();
 
-        void scan_token();
+        [[nodiscard]] Token identifier();
+
+        [[nodiscard]] std::optional<Token> scan_token();
 
       private:
         std::size_t start   = 0;
         std::size_t current = 0;
         std::size_t line    = 1;
 
-        std::string        source;
-        std::vector<Token> tokens;
-
-        const inline static std::unordered_map<std::string, TokenType> keywords = {
-            { "and", TokenType::AND },     { "class", TokenType::CLASS },   { "else", TokenType::ELSE },
-            { "false", TokenType::FALSE }, { "for", TokenType::FOR },       { "fun", TokenType::FUN },
-            { "if", TokenType::IF },       { "nil", TokenType::NIL },       { "or", TokenType::OR },
-            { "print", TokenType::PRINT }, { "return", TokenType::RETURN }, { "super", TokenType::SUPER },
-            { "this", TokenType::THIS },   { "true", TokenType::TRUE },     { "var", TokenType::VAR },
-            { "while", TokenType::WHILE },
-        };
+        std::string_view source;
+
+        std::vector<ScanError> *errors = nullptr;
     };
 
 }// namespace tek::tokenizer
@@ -0,0 +1,365 @@
+#include "scan.hpp"
+
+#include <cassert>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define TEK_SCAN_X86 1
+#include <immintrin.h>
+// The generic kernels below pass AVX vectors around, they are only ever inlined into functions compiled for AVX2.
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+namespace tek::tokenizer::scan {
+    namespace {
+        using SkipFn = const char *(*)(const char *it, const char *end, std::size_t &newlines);
+        using FindFn = const char *(*)(const char *it, const char *end);
+
+        struct Kernels
+        {
+            SkipFn skip_whitespace;
+            FindFn find_line_end;
+            SkipFn find_string_end;
+            FindFn find_identifier_end;
+        };
+
+        [[nodiscard]] constexpr bool is_whitespace(const char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+        }
+
+        const char *skip_whitespace_scalar(const char *it, const char *end, std::size_t &newlines)
+        {
+            for (; it != end && is_whitespace(*it); ++it) {
+                if (*it == '\n') { ++newlines; }
+            }
+            return it;
+        }
+
+        const char *find_line_end_scalar(const char *it, const char *end)
+        {
+            while (it != end && *it != '\n') { ++it; }
+            return it;
+        }
+
+        const char *find_string_end_scalar(const char *it, const char *end, std::size_t &newlines)
+        {
+            for (; it != end && *it != '"'; ++it) {
+                if (*it == '\n') { ++newlines; }
+            }
+            return it;
+        }
+
+        const char *find_identifier_end_scalar(const char *it, const char *end)
+        {
+            while (it != end && is_alnum(*it)) { ++it; }
+            return it;
+        }
+
+        constexpr Kernels scalar_kernels{
+            &skip_whitespace_scalar,
+            &find_line_end_scalar,
+            &find_string_end_scalar,
+            &find_identifier_end_scalar,
+        };
+
+#ifdef TEK_SCAN_X86
+        // Mask of the bytes below `position`, i.e. the ones already consumed when the match is at `position`.
+        [[nodiscard]] inline std::uint32_t bits_below(const unsigned position) { return (1U << position) - 1U; }
+
+        [[nodiscard]] inline std::size_t popcount(const std::uint32_t mask)
+        {
+            return static_cast<std::size_t>(__builtin_popcount(mask));
+        }
+
+        [[nodiscard]] inline unsigned first_set(const std::uint32_t mask)
+        {
+            return static_cast<unsigned>(__builtin_ctz(mask));
+        }
+
+        // Both SSE2 and AVX2 implementations share their shape, only the vector width and intrinsics differ.
+        struct Sse2
+        {
+            using Vector                       = __m128i;
+            static constexpr std::size_t width = 16;
+
+            static Vector load(const char *it) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(it)); }
+            static Vector splat(const char c) { return _mm_set1_epi8(c); }
+            static Vector eq(const Vector a, const Vector b) { return _mm_cmpeq_epi8(a, b); }
+            static Vector gt(const Vector a, const Vector b) { return _mm_cmpgt_epi8(a, b); }
+            static Vector lt(const Vector a, const Vector b) { return _mm_cmplt_epi8(a, b); }
+            static Vector both(const Vector a, const Vector b) { return _mm_and_si128(a, b); }
+            static Vector either(const Vector a, const Vector b) { return _mm_or_si128(a, b); }
+
+            static std::uint32_t mask(const Vector v) { return static_cast<std::uint32_t>(_mm_movemask_epi8(v)); }
+
+            // Bytes in [low, high]. Characters above 0x7F compare as negative, so they never fall in an ASCII range.
+            static Vector in_range(const Vector chunk, const char low, const char high)
+            {
+                const auto above = gt(chunk, splat(static_cast<char>(low - 1)));
+                return both(above, lt(chunk, splat(static_cast<char>(high + 1))));
+            }
+
+            static constexpr std::uint32_t all = 0xFFFFU;
+        };
+
+        struct Avx2
+        {
+            using Vector                       = __m256i;
+            static constexpr std::size_t width = 32;
+
+            __attribute__((target("avx2"))) static Vector load(const char *it)
+            {
+                return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(it));
+            }
+            __attribute__((target("avx2"))) static Vector splat(const char c) { return _mm256_set1_epi8(c); }
+            __attribute__((target("avx2"))) static Vector eq(const Vector a, const Vector b)
+            {
+                return _mm256_cmpeq_epi8(a, b);
+            }
+            __attribute__((target("avx2"))) static Vector gt(const Vector a, const Vector b)
+            {
+                return _mm256_cmpgt_epi8(a, b);
+            }
+            __attribute__((target("avx2"))) static Vector lt(const Vector a, const Vector b)
+            {
+                return _mm256_cmpgt_epi8(b, a);
+            }
+            __attribute__((target("avx2"))) static Vector both(const Vector a, const Vector b)
+            {
+                return _mm256_and_si256(a, b);
+            }
+            __attribute__((target("avx2"))) static Vector either(const Vector a, const Vector b)
+            {
+                return _mm256_or_si256(a, b);
+            }
+
+            __attribute__((target("avx2"))) static std::uint32_t mask(const Vector v)
+            {
+                return static_cast<std::uint32_t>(_mm256_movemask_epi8(v));
+            }
+
+            __attribute__((target("avx2"))) static Vector in_range(const Vector chunk, const char low, const char high)
+            {
+                const auto above = gt(chunk, splat(static_cast<char>(low - 1)));
+                return both(above, lt(chunk, splat(static_cast<char>(high + 1))));
+            }
+
+            static constexpr std::uint32_t all = 0xFFFFFFFFU;
+        };
+
+        template<typename V>
+        __attribute__((always_inline)) inline const char *
+          skip_whitespace_vector(const char *it, const char *end, std::size_t &newlines)
+        {
+            while (static_cast<std::size_t>(end - it) >= V::width) {
+                const auto chunk      = V::load(it);
+                const auto line_feeds = V::mask(V::eq(chunk, V::splat('\n')));
+                const auto blanks     = V::mask(V::either(
+                  V::either(V::eq(chunk, V::splat(' ')), V::eq(chunk, V::splat('\t'))), V::eq(chunk, V::splat('\r'))));
+
+                const auto others = ~(line_feeds | blanks) & V::all;
+                if (others != 0) {
+                    const auto position = first_set(others);
+                    newlines += popcount(line_feeds & bits_below(position));
+                    return it + position;
+                }
+
+                newlines += popcount(line_feeds);
+                it += V::width;
+            }
+            return skip_whitespace_scalar(it, end, newlines);
+        }
+
+        template<typename V>
+        __attribute__((always_inline)) inline const char *find_line_end_vector(const char *it, const char *end)
+        {
+            while (static_cast<std::size_t>(end - it) >= V::width) {
+                const auto line_feeds = V::mask(V::eq(V::load(it), V::splat('\n')));
+                if (line_feeds != 0) { return it + first_set(line_feeds); }
+                it += V::width;
+            }
+            return find_line_end_scalar(it, end);
+        }
+
+        template<typename V>
+        __attribute__((always_inline)) inline const char *
+          find_string_end_vector(const char *it, const char *end, std::size_t &newlines)
+        {
+            while (static_cast<std::size_t>(end - it) >= V::width) {
+                const auto chunk      = V::load(it);
+                const auto quotes     = V::mask(V::eq(chunk, V::splat('"')));
+                const auto line_feeds = V::mask(V::eq(chunk, V::splat('\n')));
+
+                if (quotes != 0) {
+                    const auto position = first_set(quotes);
+                    newlines += popcount(line_feeds & bits_below(position));
+                    return it + position;
+                }
+
+                newlines += popcount(line_feeds);
+                it += V::width;
+            }
+            return find_string_end_scalar(it, end, newlines);
+        }
+
+        template<typename V>
+        __attribute__((always_inline)) inline const char *find_identifier_end_vector(const char *it, const char *end)
+        {
+            while (static_cast<std::size_t>(end - it) >= V::width) {
+                const auto chunk   = V::load(it);
+                const auto letters = V::either(
+                  V::either(V::in_range(chunk, 'a', 'z'), V::in_range(chunk, 'A', 'Z')), V::eq(chunk, V::splat('_')));
+                const auto others = ~V::mask(V::either(letters, V::in_range(chunk, '0', '9'))) & V::all;
+
+                if (others != 0) { return it + first_set(others); }
+                it += V::width;
+            }
+            return find_identifier_end_scalar(it, end);
+        }
+
+        const char *skip_whitespace_sse2(const char *it, const char *end, std::size_t &newlines)
+        {
+            return skip_whitespace_vector<Sse2>(it, end, newlines);
+        }
+
+        const char *find_line_end_sse2(const char *it, const char *end) { return find_line_end_vector<Sse2>(it, end); }
+
+        const char *find_string_end_sse2(const char *it, const char *end, std::size_t &newlines)
+        {
+            return find_string_end_vector<Sse2>(it, end, newlines);
+        }
+
+        const char *find_identifier_end_sse2(const char *it, const char *end)
+        {
+            return find_identifier_end_vector<Sse2>(it, end);
+        }
+
+        __attribute__((target("avx2"))) const char *
+          skip_whitespace_avx2(const char *it, const char *end, std::size_t &newlines)
+        {
+            return skip_whitespace_vector<Avx2>(it, end, newlines);
+        }
+
+        __attribute__((target("avx2"))) const char *find_line_end_avx2(const char *it, const char *end)
+        {
+            return find_line_end_vector<Avx2>(it, end);
+        }
+
+        __attribute__((target("avx2"))) const char *
+          find_string_end_avx2(const char *it, const char *end, std::size_t &newlines)
+        {
+            return find_string_end_vector<Avx2>(it, end, newlines);
+        }
+
+        __attribute__((target("avx2"))) const char *find_identifier_end_avx2(const char *it, const char *end)
+        {
+            return find_identifier_end_vector<Avx2>(it, end);
+        }
+
+        constexpr Kernels sse2_kernels{
+            &skip_whitespace_sse2,
+            &find_line_end_sse2,
+            &find_string_end_sse2,
+            &find_identifier_end_sse2,
+        };
+
+        constexpr Kernels avx2_kernels{
+            &skip_whitespace_avx2,
+            &find_line_end_avx2,
+            &find_string_end_avx2,
+            &find_identifier_end_avx2,
+        };
+#endif
+
+        bool is_supported(const Isa isa)
+        {
+            switch (isa) {
+                case Isa::SCALAR:
+                    return true;
+#ifdef TEK_SCAN_X86
+                case Isa::SSE2:
+                    return true;
+                case Isa::AVX2:
+                    return __builtin_cpu_supports("avx2");
+#endif
+                default:
+                    return false;
+            }
+        }
+
+        const Kernels &kernels_for(const Isa isa)
+        {
+            switch (isa) {
+#ifdef TEK_SCAN_X86
+                case Isa::SSE2:
+                    return sse2_kernels;
+                case Isa::AVX2:
+                    return avx2_kernels;
+#endif
+                default:
+                    return scalar_kernels;
+            }
+        }
+
+        struct Dispatch
+        {
+            Isa            isa;
+            const Kernels *kernels;
+        };
+
+        Dispatch make_dispatch(const Isa isa) { return Dispatch{ isa, &kernels_for(isa) }; }
+
+        // Picked once at startup, the tokenizer then pays a single indirect call per scanned run of characters.
+        Dispatch active = make_dispatch(best_supported_isa());
+    }// namespace
+
+    Isa best_supported_isa()
+    {
+        if (is_supported(Isa::AVX2)) { return Isa::AVX2; }
+        if (is_supported(Isa::SSE2)) { return Isa::SSE2; }
+        return Isa::SCALAR;
+    }
+
+    Isa active_isa() { return active.isa; }
+
+    std::string isa_to_str(const Isa isa)
+    {
+        switch (isa) {
+            case Isa::SCALAR:
+                return "scalar";
+            case Isa::SSE2:
+                return "sse2";
+            case Isa::AVX2:
+                return "avx2";
+            default:
+                assert(0 && "Unreachable");
+                return "";
+        }
+    }
+
+    bool use_isa(const Isa isa)
+    {
+        if (!is_supported(isa)) { return false; }
+
+        active = make_dispatch(isa);
+        return true;
+    }
+
+    const char *skip_whitespace(const char *it, const char *end, std::size_t &newlines)
+    {
+        return active.kernels->skip_whitespace(it, end, newlines);
+    }
+
+    const char *find_line_end(const char *it, const char *end) { return active.kernels->find_line_end(it, end); }
+
+    const char *find_string_end(const char *it, const char *end, std::size_t &newlines)
+    {
+        return active.kernels->find_string_end(it, end, newlines);
+    }
+
+    const char *find_identifier_end(const char *it, const char *end)
+    {
+        return active.kernels->find_identifier_end(it, end);
+    }
+}// namespace tek::tokenizer::scan
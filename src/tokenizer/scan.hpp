@@ -0,0 +1,121 @@
+#ifndef TEK_SCAN_HPP
+#define TEK_SCAN_HPP
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "Token.hpp"
+
+// Bulk character scanning used by the tokenizer. Each routine has a scalar implementation and, on x86-64, SSE2 and
+// AVX2 ones working on 16 and 32 bytes at a time. The fastest one supported by the CPU is picked at startup.
+namespace tek::tokenizer::scan {
+    enum class Isa {
+        SCALAR = 0,
+        SSE2,
+        AVX2,
+    };
+
+    [[nodiscard]] Isa         best_supported_isa();
+    [[nodiscard]] Isa         active_isa();
+    [[nodiscard]] std::string isa_to_str(const Isa isa);
+
+    // Switches every scanning routine to the given implementation, returns false if the CPU can't run it.
+    bool use_isa(const Isa isa);
+
+    // Returns the first character that is not one of ' ', '\t', '\r', '\n'; `newlines` is increased by the number of
+    // line feeds skipped over.
+    [[nodiscard]] const char *skip_whitespace(const char *it, const char *end, std::size_t &newlines);
+
+    // Returns the first '\n' or `end`.
+    [[nodiscard]] const char *find_line_end(const char *it, const char *end);
+
+    // Returns the first '"' or `end`; `newlines` is increased by the number of line feeds skipped over.
+    [[nodiscard]] const char *find_string_end(const char *it, const char *end, std::size_t &newlines);
+
+    // Returns the first character that is not an ASCII letter, digit or underscore.
+    [[nodiscard]] const char *find_identifier_end(const char *it, const char *end);
+
+    [[nodiscard]] constexpr bool is_digit(const char c) { return c >= '0' && c <= '9'; }
+
+    // What an identifier may start with.
+    [[nodiscard]] constexpr bool is_alpha(const char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+    }
+
+    [[nodiscard]] constexpr bool is_alnum(const char c) { return is_digit(c) || is_alpha(c); }
+
+    namespace detail {
+        struct Keyword
+        {
+            std::string_view text;
+            TokenType        type = TokenType::IDENTIFIER;
+        };
+
+        inline constexpr std::size_t keyword_table_size = 64;
+
+        inline constexpr std::array<Keyword, 20> keywords = { {
+          { "and", TokenType::AND },
+          { "await", TokenType::AWAIT },
+          { "class", TokenType::CLASS },
+          { "else", TokenType::ELSE },
+          { "false", TokenType::FALSE },
+          { "for", TokenType::FOR },
+          { "fun", TokenType::FUN },
+          { "if", TokenType::IF },
+          { "in", TokenType::IN },
+          { "nil", TokenType::NIL },
+          { "or", TokenType::OR },
+          { "print", TokenType::PRINT },
+          { "return", TokenType::RETURN },
+          { "spawn", TokenType::SPAWN },
+          { "super", TokenType::SUPER },
+          { "this", TokenType::THIS },
+          { "true", TokenType::TRUE },
+          { "var", TokenType::VAR },
+          { "while", TokenType::WHILE },
+          { "yield", TokenType::YIELD },
+        } };
+
+        // Every keyword is at least two characters long, the first two together with the length are enough to tell
+        // them apart.
+        [[nodiscard]] constexpr std::size_t keyword_hash(const std::string_view text)
+        {
+            const auto first  = static_cast<std::size_t>(static_cast<unsigned char>(text[0]));
+            const auto second = static_cast<std::size_t>(static_cast<unsigned char>(text[1]));
+            return (first * 12 + second + text.size() * 11) & (keyword_table_size - 1);
+        }
+
+        [[nodiscard]] constexpr std::array<Keyword, keyword_table_size> make_keyword_table()
+        {
+            std::array<Keyword, keyword_table_size> table{};
+            for (const auto &keyword : keywords) { table[keyword_hash(keyword.text)] = keyword; }
+            return table;
+        }
+
+        inline constexpr auto keyword_table = make_keyword_table();
+
+        [[nodiscard]] constexpr bool keyword_table_is_perfect()
+        {
+            for (const auto &keyword : keywords) {
+                if (keyword_table[keyword_hash(keyword.text)].text != keyword.text) { return false; }
+            }
+            return true;
+        }
+
+        static_assert(keyword_table_is_perfect(), "Keyword hash has collisions, pick new coefficients");
+    }// namespace detail
+
+    // Perfect hash lookup over the identifier span, no allocation involved.
+    [[nodiscard]] constexpr TokenType keyword_or_identifier(const std::string_view text)
+    {
+        if (text.size() < 2 || text.size() > 6) { return TokenType::IDENTIFIER; }
+
+        const auto &candidate = detail::keyword_table[detail::keyword_hash(text)];
+        return candidate.text == text ? candidate.type : TokenType::IDENTIFIER;
+    }
+}// namespace tek::tokenizer::scan
+
+#endif// TEK_SCAN_HPP
@@ -5,7 +5,10 @@
 #include "Callable.hpp"
 
 #include "../interpreter/Environment.hpp"
+#include "../interpreter/Generators.hpp"
 #include "../interpreter/Interpreter.hpp"
+#include "../parser/Ast.hpp"
+#include "../parser/Parser.hpp"
 #include "Literal.hpp"
 #include <utility>
 
@@ -16,27 +19,51 @@ namespace tek::types {
 
     Literal NativeCallable::call(tek::interpreter::Interpreter &interpreter, std::vector<Literal> arguments)
     {
-        return Literal("");
+        return this->cpp_function(interpreter, arguments);
     }
 
-    std::size_t NativeCallable::get_arity() const { return 0; }
+    std::size_t NativeCallable::get_arity() const { return this->arity; }
 
     std::string NativeCallable::to_string() const { return "native function"; }
 
-    TekFunction::TekFunction(TekFunction::FunctionStatementPtr declaration, EnvironmentPtr environment)
-      : declaration{ std::move(declaration) }, closure{ std::move(environment) }
+    TekFunction::TekFunction(
+      AstPtr                           ast,
+      const parser::FunctionStatement *declaration,
+      EnvironmentPtr                   environment)
+      : ast{ std::move(ast) }, declaration{ declaration }, closure{ std::move(environment) }
     {}
 
     Literal TekFunction::call(interpreter::Interpreter &interpreter, std::vector<Literal> arguments)
     {
-        auto environment = std::make_shared<interpreter::Environment>(this->closure);
-        for (std::size_t i = 0; i < this->declaration->parameters.size(); ++i) {
-            environment->define(this->declaration->parameters.at(i).lexeme, arguments.at(i));
+        // A deferred body is parsed on the first call, into an Ast of its own.
+        const AstPtr *body_ast = &this->ast;
+        auto          body     = this->declaration->body;
+        if (this->declaration->is_deferred()) {
+            auto &deferred = this->ast->deferred_body(this->declaration->deferred_body);
+            if (!parser::Parser::parse_deferred(deferred)) {
+                const auto &name = this->ast->token(this->declaration->name);
+                throw exceptions::RuntimeError(name, fmt::format("Function '{}' has an invalid body.", name.lexeme));
+            }
+            body_ast = &deferred.ast;
+            body     = deferred.statements;
+        }
+
+        auto       environment = std::make_shared<interpreter::Environment>(this->closure);
+        const auto parameters  = this->ast->tokens(this->declaration->parameters);
+        for (std::size_t i = 0; i < parameters.size(); ++i) {
+            environment->define(this->ast->token(parameters[i]).lexeme, arguments.at(i));
+        }
+
+        // Nothing of a generator's body runs before it is iterated.
+        if (this->declaration->generator) {
+            interpreter.governor.allocate(sizeof(interpreter::GeneratorState));
+            return types::Literal(
+              types::Generator(std::make_shared<interpreter::GeneratorState>(*body_ast, body, environment)));
         }
 
         // Return statement it's handled through throwing an exception. Grrrr..
         try {
-            interpreter.execute_block(this->declaration->body, environment);
+            interpreter.execute_block(*body_ast, (*body_ast)->statements(body), environment);
         } catch (const exceptions::Return &ret) {
             return ret.retval;
         }
@@ -45,6 +72,12 @@ namespace tek::types {
         return types::Literal(nullptr);
     }
 
-    std::size_t TekFunction::get_arity() const { return this->declaration->parameters.size(); }
-    std::string TekFunction::to_string() const { return fmt::format("<fn {} >", this->declaration->name.lexeme); }
+    std::size_t TekFunction::get_arity() const { return this->declaration->parameters.size; }
+
+    void TekFunction::share() const { this->closure->share(); }
+
+    std::string TekFunction::to_string() const
+    {
+        return fmt::format("<fn {} >", this->ast->token(this->declaration->name).lexeme);
+    }
 }// namespace tek::types
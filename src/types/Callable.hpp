@@ -6,12 +6,14 @@
 #include <vector>
 
 namespace tek::parser {
+    class Ast;
     class FunctionStatement;
-}
+}// namespace tek::parser
 
 namespace tek::interpreter {
     class Interpreter;
     class Environment;
+    class Snapshot;
 }// namespace tek::interpreter
 
 namespace tek::types {
@@ -20,13 +22,19 @@ namespace tek::types {
     class Callable
     {
       public:
-        using FnPtr = Literal (*)(interpreter::Interpreter &interpreter, const std::vector<Literal> &arguments);
+        // Arguments may be moved from.
+        using FnPtr = Literal (*)(interpreter::Interpreter &interpreter, std::vector<Literal> &arguments);
 
       public:
+        virtual ~Callable() = default;
+
         [[nodiscard]] virtual Literal call(interpreter::Interpreter &interpreter, std::vector<Literal> arguments) = 0;
         [[nodiscard]] virtual std::size_t get_arity() const                                                       = 0;
         [[nodiscard]] virtual std::string to_string() const                                                       = 0;
 
+        // Makes what the callable refers to safe to read from other threads, before it is run as a task.
+        virtual void share() const {}
+
         friend constexpr bool operator==(const Callable &rhs, const Callable &lhs) { return true; }
     };
 
@@ -50,19 +58,24 @@ namespace tek::types {
     class TekFunction : public Callable
     {
       public:
-        using FunctionStatementPtr = std::shared_ptr<parser::FunctionStatement>;
-        using EnvironmentPtr       = std::shared_ptr<interpreter::Environment>;
+        using AstPtr         = std::shared_ptr<parser::Ast>;
+        using EnvironmentPtr = std::shared_ptr<interpreter::Environment>;
 
       public:
-        explicit TekFunction(FunctionStatementPtr declaration, EnvironmentPtr closure);
+        // `declaration` lives in `ast`, holding on to the latter keeps the former valid.
+        TekFunction(AstPtr ast, const parser::FunctionStatement *declaration, EnvironmentPtr closure);
 
         [[nodiscard]] Literal     call(interpreter::Interpreter &interpreter, std::vector<Literal> arguments) override;
         [[nodiscard]] std::size_t get_arity() const override;
         [[nodiscard]] std::string to_string() const override;
+        void                      share() const override;
 
       private:
-        FunctionStatementPtr declaration;
-        EnvironmentPtr       closure;
+        friend class interpreter::Snapshot;
+
+        AstPtr                           ast;
+        const parser::FunctionStatement *declaration;
+        EnvironmentPtr                   closure;
     };
 }// namespace tek::types
 
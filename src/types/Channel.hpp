@@ -0,0 +1,24 @@
+#ifndef TEK_CHANNEL_HPP
+#define TEK_CHANNEL_HPP
+
+#include <memory>
+
+namespace tek::interpreter {
+    class ChannelState;
+}// namespace tek::interpreter
+
+namespace tek::types {
+    // Handle to a channel made by `channel(capacity)`, copies refer to the same one.
+    class Channel
+    {
+      public:
+        explicit Channel(std::shared_ptr<interpreter::ChannelState> state) : state{ std::move(state) } {}
+
+        friend bool operator==(const Channel &lhs, const Channel &rhs) { return lhs.state == rhs.state; }
+
+      public:
+        std::shared_ptr<interpreter::ChannelState> state;
+    };
+}// namespace tek::types
+
+#endif// TEK_CHANNEL_HPP
@@ -0,0 +1,24 @@
+#ifndef TEK_GENERATOR_HPP
+#define TEK_GENERATOR_HPP
+
+#include <memory>
+
+namespace tek::interpreter {
+    struct GeneratorState;
+}// namespace tek::interpreter
+
+namespace tek::types {
+    // Handle to what calling a `fun*` gives, iterated by `for (var x in generator)`. Copies refer to the same one.
+    class Generator
+    {
+      public:
+        explicit Generator(std::shared_ptr<interpreter::GeneratorState> state) : state{ std::move(state) } {}
+
+        friend bool operator==(const Generator &lhs, const Generator &rhs) { return lhs.state == rhs.state; }
+
+      public:
+        std::shared_ptr<interpreter::GeneratorState> state;
+    };
+}// namespace tek::types
+
+#endif// TEK_GENERATOR_HPP
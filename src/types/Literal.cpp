@@ -1,10 +1,12 @@
 #include "Literal.hpp"
 
+#include "../interpreter/Generators.hpp"
+
 namespace tek::types {
     Literal::Literal(Literal::variant_t literal) : literal{ std::move(literal) } {}
 
 
-    Literal::variant_t Literal::value() { return this->literal; }
+    Literal::variant_t Literal::value() const { return this->literal; }
 
     Literal::CallablePtr Literal::as_callable()
     {
@@ -18,6 +20,15 @@ namespace tek::types {
         return nullptr;
     }
 
+    void Literal::share() const
+    {
+        if (const auto *function = std::get_if<TekFunction>(&this->literal)) {
+            function->share();
+        } else if (const auto *generator = std::get_if<Generator>(&this->literal)) {
+            generator->state->share();
+        }
+    }
+
     std::string Literal::str() const
     {
         ValueVisitor visitor{ [](const double value) -> std::string { return std::to_string(value); },
@@ -25,7 +36,10 @@ namespace tek::types {
                               [](const bool boolean) -> std::string { return boolean ? "true" : "false"; },
                               [](const std::nullptr_t nil) -> std::string { return "nil"; },
                               [](const NativeCallable &callable) -> std::string { return "native callable"; },
-                              [](const TekFunction &callable) -> std::string { return "tek callable"; } };
+                              [](const TekFunction &callable) -> std::string { return "tek callable"; },
+                              [](const Task &task) -> std::string { return "task"; },
+                              [](const Channel &channel) -> std::string { return "channel"; },
+                              [](const Generator &generator) -> std::string { return "generator"; } };
         return std::visit(visitor, literal);
     }
 
@@ -36,7 +50,10 @@ namespace tek::types {
                               [](const bool boolean) -> std::string { return boolean ? "true" : "false"; },
                               [](const std::nullptr_t nil) -> std::string { return "nil"; },
                               [](const NativeCallable &callable) -> std::string { return "native callable"; },
-                              [](const TekFunction &callable) -> std::string { return "tek callable"; } };
+                              [](const TekFunction &callable) -> std::string { return "tek callable"; },
+                              [](const Task &task) -> std::string { return "task"; },
+                              [](const Channel &channel) -> std::string { return "channel"; },
+                              [](const Generator &generator) -> std::string { return "generator"; } };
         return std::visit(visitor, literal);
     }
 }// namespace tek::types
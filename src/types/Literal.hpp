@@ -7,6 +7,9 @@
 #include <vector>
 
 #include "Callable.hpp"
+#include "Channel.hpp"
+#include "Generator.hpp"
+#include "Task.hpp"
 
 
 namespace tek::types {
@@ -22,16 +25,29 @@ namespace tek::types {
     struct Literal
     {
       public:
-        using variant_t   = std::variant<double, std::string, bool, std::nullptr_t, NativeCallable, TekFunction>;
+        using variant_t = std::variant<
+          double,
+          std::string,
+          bool,
+          std::nullptr_t,
+          NativeCallable,
+          TekFunction,
+          Task,
+          Channel,
+          Generator>;
         using CallablePtr = std::unique_ptr<Callable>;
 
       public:
         explicit Literal(variant_t literal);
 
-        [[nodiscard]] variant_t value();
+        [[nodiscard]] variant_t value() const;
 
         [[nodiscard]] CallablePtr as_callable();
 
+        // Makes a function or a generator, and whatever its environments refer to, safe to use from other threads, see
+        // Environment::share(). Other values are copied whenever they are read.
+        void share() const;
+
         [[nodiscard]] std::string str() const;
         [[nodiscard]] std::string str();
 
@@ -0,0 +1,24 @@
+#ifndef TEK_TASK_HPP
+#define TEK_TASK_HPP
+
+#include <memory>
+
+namespace tek::interpreter {
+    struct TaskState;
+}// namespace tek::interpreter
+
+namespace tek::types {
+    // Handle to a spawned task, what `spawn` evaluates to and `await` takes. Copies refer to the same task.
+    class Task
+    {
+      public:
+        explicit Task(std::shared_ptr<interpreter::TaskState> state) : state{ std::move(state) } {}
+
+        friend bool operator==(const Task &lhs, const Task &rhs) { return lhs.state == rhs.state; }
+
+      public:
+        std::shared_ptr<interpreter::TaskState> state;
+    };
+}// namespace tek::types
+
+#endif// TEK_TASK_HPP
@@ -0,0 +1,134 @@
+#ifndef TEK_BINARY_HPP
+#define TEK_BINARY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace tek::utils {
+    // Appends values to a byte string in the native layout, for images only read back by the same build.
+    class ByteWriter
+    {
+      public:
+        template<typename T>
+        void put(const T &value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            this->bytes.append(reinterpret_cast<const char *>(&value), sizeof(T));
+        }
+
+        // LEB128, most sizes and positions fit a byte or two.
+        void put_varint(std::uint64_t value)
+        {
+            while (value >= 0x80) {
+                this->bytes.push_back(static_cast<char>((value & 0x7f) | 0x80));
+                value >>= 7;
+            }
+            this->bytes.push_back(static_cast<char>(value));
+        }
+
+        // Positions are written as the difference with the previous one, zigzag encoded.
+        void put_delta(const std::uint64_t value, std::uint64_t &previous)
+        {
+            const auto delta = static_cast<std::int64_t>(value - previous);
+            this->put_varint(static_cast<std::uint64_t>(delta) << 1 ^ static_cast<std::uint64_t>(delta >> 63));
+            previous = value;
+        }
+
+        void put_string(const std::string_view text)
+        {
+            this->put_varint(text.size());
+            this->bytes.append(text);
+        }
+
+        template<typename T>
+        void put_vector(const std::vector<T> &values)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            this->put_varint(values.size());
+            this->bytes.append(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+        }
+
+      public:
+        std::string bytes;
+    };
+
+    // Reads what a ByteWriter wrote. Every read fails rather than going past the end of the bytes.
+    class ByteReader
+    {
+      public:
+        explicit ByteReader(const std::string_view bytes) : bytes{ bytes } {}
+
+        [[nodiscard]] bool get_bytes(void *destination, const std::size_t size)
+        {
+            if (this->bytes.size() < size) { return false; }
+            std::memcpy(destination, this->bytes.data(), size);
+            this->bytes.remove_prefix(size);
+            return true;
+        }
+
+        template<typename T>
+        [[nodiscard]] bool get(T &value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            return this->get_bytes(&value, sizeof(T));
+        }
+
+        [[nodiscard]] bool get_varint(std::uint64_t &value)
+        {
+            value = 0;
+            for (unsigned shift = 0; shift < 64 && !this->bytes.empty(); shift += 7) {
+                const auto byte = static_cast<unsigned char>(this->bytes.front());
+                this->bytes.remove_prefix(1);
+
+                value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0) { return true; }
+            }
+            return false;
+        }
+
+        [[nodiscard]] bool get_delta(std::uint64_t &value, std::uint64_t &previous)
+        {
+            std::uint64_t zigzag = 0;
+            if (!this->get_varint(zigzag)) { return false; }
+
+            value    = previous + ((zigzag >> 1) ^ (~(zigzag & 1) + 1));
+            previous = value;
+            return true;
+        }
+
+        [[nodiscard]] bool get_string(std::string &text)
+        {
+            std::uint64_t size = 0;
+            if (!this->get_varint(size) || this->bytes.size() < size) { return false; }
+
+            text.assign(this->bytes.data(), size);
+            this->bytes.remove_prefix(size);
+            return true;
+        }
+
+        template<typename T>
+        [[nodiscard]] bool get_vector(std::vector<T> &values)
+        {
+            std::uint64_t size = 0;
+            if (!this->get_varint(size) || this->bytes.size() / sizeof(T) < size) { return false; }
+
+            values.resize(size);
+            return this->get_bytes(values.data(), size * sizeof(T));
+        }
+
+        [[nodiscard]] bool at_end() const { return this->bytes.empty(); }
+
+        // What is left to read.
+        [[nodiscard]] std::string_view rest() const { return this->bytes; }
+
+      private:
+        std::string_view bytes;
+    };
+}// namespace tek::utils
+
+#endif// TEK_BINARY_HPP
@@ -0,0 +1,112 @@
+#ifndef TEK_CHUNKED_VECTOR_HPP
+#define TEK_CHUNKED_VECTOR_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tek::utils {
+    // Append only sequence stored in fixed size chunks of about `ChunkBytes`. Growing never moves or copies elements,
+    // references stay valid for the lifetime of the container, and memory is released one chunk at a time.
+    template<typename T, std::size_t ChunkBytes = 16 * 1024>
+    class chunked_vector
+    {
+      private:
+        // Largest power of two number of elements fitting a chunk, so that indexing is a shift and a mask.
+        static constexpr std::size_t elements_per_chunk()
+        {
+            std::size_t count = 1;
+            while (count * 2 * sizeof(T) <= ChunkBytes) { count *= 2; }
+            return count;
+        }
+
+      public:
+        static constexpr std::size_t chunk_size = elements_per_chunk();
+
+      public:
+        chunked_vector() = default;
+
+        chunked_vector(const chunked_vector &)            = delete;
+        chunked_vector &operator=(const chunked_vector &) = delete;
+
+        chunked_vector(chunked_vector &&other) noexcept
+          : chunks{ std::move(other.chunks) }, count{ std::exchange(other.count, 0) }
+        {}
+
+        chunked_vector &operator=(chunked_vector &&other) noexcept
+        {
+            if (this != &other) {
+                this->clear();
+                this->chunks = std::move(other.chunks);
+                this->count  = std::exchange(other.count, 0);
+            }
+            return *this;
+        }
+
+        ~chunked_vector() { this->clear(); }
+
+        template<typename... Arguments>
+        T &emplace_back(Arguments &&...arguments)
+        {
+            // Chunks are left uninitialized, elements are constructed in place as they are added.
+            if (this->count == this->chunks.size() * chunk_size) { this->chunks.emplace_back(new Chunk); }
+
+            auto *element = new (this->address_of(this->count)) T(std::forward<Arguments>(arguments)...);
+            ++this->count;
+            return *element;
+        }
+
+        [[nodiscard]] T       &operator[](const std::size_t index) { return *this->address_of(index); }
+        [[nodiscard]] const T &operator[](const std::size_t index) const { return *this->address_of(index); }
+
+        // Position of `element` if it is one of ours, looked up chunk by chunk.
+        [[nodiscard]] std::optional<std::size_t> index_of(const T *element) const
+        {
+            const std::less<const T *> before;
+            for (std::size_t chunk = 0; chunk < this->chunks.size(); ++chunk) {
+                const auto *first = this->address_of(chunk * chunk_size);
+                if (before(element, first) || !before(element, first + chunk_size)) { continue; }
+
+                const auto index = chunk * chunk_size + static_cast<std::size_t>(element - first);
+                if (index < this->count) { return index; }
+                return std::nullopt;
+            }
+            return std::nullopt;
+        }
+
+        [[nodiscard]] std::size_t size() const { return this->count; }
+        [[nodiscard]] bool        empty() const { return this->count == 0; }
+
+        void clear()
+        {
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                for (std::size_t i = 0; i < this->count; ++i) { this->address_of(i)->~T(); }
+            }
+            this->chunks.clear();
+            this->count = 0;
+        }
+
+      private:
+        struct Chunk
+        {
+            alignas(T) std::byte storage[sizeof(T) * chunk_size];
+        };
+
+        [[nodiscard]] T *address_of(const std::size_t index) const
+        {
+            auto *storage = this->chunks[index / chunk_size]->storage;
+            return std::launder(reinterpret_cast<T *>(storage) + index % chunk_size);
+        }
+
+      private:
+        std::vector<std::unique_ptr<Chunk>> chunks;
+        std::size_t                         count = 0;
+    };
+}// namespace tek::utils
+
+#endif// TEK_CHUNKED_VECTOR_HPP
@@ -1,16 +1,128 @@
 #include "fs.hpp"
 
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <optional>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <system_error>
+#include <utility>
+
 namespace tek::fs {
-    std::string read_file(const std::filesystem::path &path)
+    namespace {
+        // Everything up to the end of the input, nullopt if reading failed before reaching it.
+        std::optional<std::string> read_descriptor(const int descriptor)
+        {
+            std::string out;
+            char        chunk[64 * 1024];
+
+            while (true) {
+                const auto count = read(descriptor, chunk, sizeof(chunk));
+                if (count < 0 && errno == EINTR) { continue; }
+                if (count < 0) { return std::nullopt; }
+                if (count == 0) { break; }
+                out.append(chunk, static_cast<std::size_t>(count));
+            }
+
+            return out;
+        }
+
+        // A partly read script must not run as if it were the whole of it.
+        SourceBuffer read_all(const int descriptor, const std::filesystem::path &path)
+        {
+            auto contents = read_descriptor(descriptor);
+            if (!contents) {
+                fmt::print(stderr, "Unable to read {}: {}", path.string(), std::strerror(errno));
+                return SourceBuffer();
+            }
+            return SourceBuffer(std::move(*contents));
+        }
+    }// namespace
+
+    SourceBuffer::SourceBuffer(std::string contents) : contents{ std::move(contents) } {}
+
+    SourceBuffer::~SourceBuffer() { this->release(); }
+
+    SourceBuffer::SourceBuffer(SourceBuffer &&other) noexcept
+      : mapping{ std::exchange(other.mapping, nullptr) }, mapping_size{ std::exchange(other.mapping_size, 0) },
+        contents{ std::move(other.contents) }
+    {}
+
+    SourceBuffer &SourceBuffer::operator=(SourceBuffer &&other) noexcept
+    {
+        if (this != &other) {
+            this->release();
+            this->mapping      = std::exchange(other.mapping, nullptr);
+            this->mapping_size = std::exchange(other.mapping_size, 0);
+            this->contents     = std::move(other.contents);
+        }
+        return *this;
+    }
+
+    std::string_view SourceBuffer::view() const
     {
-        if (!std::filesystem::exists(path)) { fmt::print(stderr, "No such file: {}", path.string()); }
+        if (this->mapping != nullptr) { return { static_cast<const char *>(this->mapping), this->mapping_size }; }
+        return this->contents;
+    }
 
-        std::ifstream     file{ path.string() };
-        std::stringstream ss{};
+    void SourceBuffer::release()
+    {
+        if (this->mapping != nullptr) { munmap(this->mapping, this->mapping_size); }
+        this->mapping      = nullptr;
+        this->mapping_size = 0;
+    }
+
+    SourceBuffer read_file(const std::filesystem::path &path)
+    {
+        if (path == "-") { return read_all(STDIN_FILENO, path); }
+
+        const int descriptor = open(path.c_str(), O_RDONLY);
+        if (descriptor < 0) {
+            fmt::print(stderr, "No such file: {}", path.string());
+            return SourceBuffer();
+        }
+
+        SourceBuffer buffer;
+        struct stat  status {};
+
+        if (fstat(descriptor, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0) {
+            const auto size    = static_cast<std::size_t>(status.st_size);
+            void      *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+            if (mapping != MAP_FAILED) {
+                madvise(mapping, size, MADV_SEQUENTIAL);
+                buffer.mapping      = mapping;
+                buffer.mapping_size = size;
+            }
+        }
+
+        if (!buffer.is_mapped()) { buffer = read_all(descriptor, path); }
+
+        close(descriptor);
+        return buffer;
+    }
+
+    bool write_file(const std::filesystem::path &path, const std::string_view contents)
+    {
+        const auto temporary = std::filesystem::path(fmt::format("{}.{}.tmp", path.string(), getpid()));
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+            file.close();
 
-        ss << file.rdbuf();
-        file.close();
+            std::error_code ec;
+            if (!file) {
+                std::filesystem::remove(temporary, ec);
+                return false;
+            }
+        }
 
-        return ss.str();
+        std::error_code ec;
+        std::filesystem::rename(temporary, path, ec);
+        if (ec) { std::filesystem::remove(temporary, ec); }
+        return !ec;
     }
 }// namespace tek::fs
@@ -1,15 +1,49 @@
 #ifndef FS_HPP
 #define FS_HPP
 
+#include <cstddef>
 #include <filesystem>
-#include <fstream>
-#include <sstream>
 #include <string>
+#include <string_view>
 
 #include <fmt/format.h>
 
 namespace tek::fs {
-    [[nodiscard]] std::string read_file(const std::filesystem::path &path);
+    // Read-only source text. Regular files are memory mapped and scanned in place, anything that can't be mapped
+    // (pipes, stdin, character devices) is read into an owned buffer instead.
+    class SourceBuffer
+    {
+      public:
+        SourceBuffer() = default;
+        explicit SourceBuffer(std::string contents);
+        ~SourceBuffer();
+
+        SourceBuffer(SourceBuffer &&other) noexcept;
+        SourceBuffer &operator=(SourceBuffer &&other) noexcept;
+
+        SourceBuffer(const SourceBuffer &)            = delete;
+        SourceBuffer &operator=(const SourceBuffer &) = delete;
+
+        [[nodiscard]] std::string_view view() const;
+        [[nodiscard]] bool             is_mapped() const { return this->mapping != nullptr; }
+
+      private:
+        friend SourceBuffer read_file(const std::filesystem::path &path);
+
+        void release();
+
+      private:
+        void       *mapping      = nullptr;
+        std::size_t mapping_size = 0;
+        std::string contents;
+    };
+
+    // Loads a whole source file, "-" stands for the standard input.
+    [[nodiscard]] SourceBuffer read_file(const std::filesystem::path &path);
+
+    // Writes a temporary file next to `path` and renames it over `path`, so that readers never see a partial file.
+    // False if anything failed, `path` is left as it was then.
+    [[nodiscard]] bool write_file(const std::filesystem::path &path, std::string_view contents);
 }// namespace tek::fs
 
 #endif
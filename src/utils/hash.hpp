@@ -0,0 +1,20 @@
+#ifndef TEK_HASH_HPP
+#define TEK_HASH_HPP
+
+#include <cstdint>
+#include <string_view>
+
+namespace tek::utils {
+    // FNV-1a, for telling sources apart rather than for hash tables.
+    [[nodiscard]] constexpr std::uint64_t fnv1a(const std::string_view bytes)
+    {
+        std::uint64_t value = 0xcbf29ce484222325;
+        for (const auto byte : bytes) {
+            value ^= static_cast<unsigned char>(byte);
+            value *= 0x100000001b3;
+        }
+        return value;
+    }
+}// namespace tek::utils
+
+#endif// TEK_HASH_HPP
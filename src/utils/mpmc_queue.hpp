@@ -0,0 +1,108 @@
+#ifndef TEK_MPMC_QUEUE_HPP
+#define TEK_MPMC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace tek::utils {
+    // Bounded queue any number of threads push to and pop from without locking, after Dmitry Vyukov's. Every slot
+    // carries a sequence number telling the lap of the ring it is in and whether it is filled, so a push or a pop
+    // claims its position with a single compare-exchange and hands the value over with the slot's sequence alone.
+    template<typename T>
+    class mpmc_queue
+    {
+      public:
+        explicit mpmc_queue(const std::size_t capacity)
+          : slots{ std::make_unique<slot[]>(capacity) }, capacity{ capacity }
+        {
+            for (std::size_t i = 0; i < capacity; ++i) { this->slots[i].sequence.store(2 * i); }
+        }
+
+        mpmc_queue(const mpmc_queue &)            = delete;
+        mpmc_queue &operator=(const mpmc_queue &) = delete;
+
+        // Moves `value` in unless the queue is full.
+        bool try_push(T &value)
+        {
+            auto  position = this->push_position.load(std::memory_order_relaxed);
+            slot *target   = nullptr;
+            while (true) {
+                target         = &this->slots[position % this->capacity];
+                const auto lag = static_cast<Difference>(target->sequence.load(std::memory_order_acquire))
+                               - static_cast<Difference>(2 * position);
+                if (lag == 0) {
+                    if (this->push_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (lag < 0) {
+                    // Still filled from the previous lap.
+                    return false;
+                } else {
+                    position = this->push_position.load(std::memory_order_relaxed);
+                }
+            }
+
+            target->value.emplace(std::move(value));
+            target->sequence.store(2 * position + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Empty if the queue is.
+        std::optional<T> try_pop()
+        {
+            auto  position = this->pop_position.load(std::memory_order_relaxed);
+            slot *source   = nullptr;
+            while (true) {
+                source         = &this->slots[position % this->capacity];
+                const auto lag = static_cast<Difference>(source->sequence.load(std::memory_order_acquire))
+                               - static_cast<Difference>(2 * position + 1);
+                if (lag == 0) {
+                    if (this->pop_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (lag < 0) {
+                    // Not filled yet in this lap.
+                    return std::nullopt;
+                } else {
+                    position = this->pop_position.load(std::memory_order_relaxed);
+                }
+            }
+
+            std::optional<T> value = std::move(source->value);
+            source->value.reset();
+            source->sequence.store(2 * (position + this->capacity), std::memory_order_release);
+            return value;
+        }
+
+        [[nodiscard]] std::size_t size() const { return this->capacity; }
+
+      private:
+        using Difference = std::int64_t;
+
+        // Sequences count two per lap, even while the slot waits for the push of position sequence / 2, odd once
+        // filled by it. Half steps tell the two apart even when the ring holds a single slot.
+        struct alignas(64) slot
+        {
+            std::atomic<std::size_t> sequence{ 0 };
+            std::optional<T>         value;
+        };
+
+      public:
+        // What a slot takes, padded to a cache line of its own.
+        static constexpr std::size_t slot_bytes = sizeof(slot);
+
+      private:
+        std::unique_ptr<slot[]> slots;
+        std::size_t             capacity;
+
+        // On cache lines of their own, so that producers and consumers don't contend on one.
+        alignas(64) std::atomic<std::size_t> push_position{ 0 };
+        alignas(64) std::atomic<std::size_t> pop_position{ 0 };
+    };
+}// namespace tek::utils
+
+#endif// TEK_MPMC_QUEUE_HPP
@@ -0,0 +1,35 @@
+#ifndef TEK_RING_BUFFER_HPP
+#define TEK_RING_BUFFER_HPP
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+namespace tek::utils {
+    // Fixed size window over an unbounded sequence. Elements are addressed by their absolute position in the
+    // sequence, only the last `Capacity` pushed ones are retained.
+    template<typename T, std::size_t Capacity>
+    class ring_buffer
+    {
+        static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+      public:
+        void push(T value)
+        {
+            this->slots[this->pushed & (Capacity - 1)] = std::move(value);
+            ++this->pushed;
+        }
+
+        [[nodiscard]] T       &at(const std::size_t position) { return this->slots[position & (Capacity - 1)]; }
+        [[nodiscard]] const T &at(const std::size_t position) const { return this->slots[position & (Capacity - 1)]; }
+
+        // Total number of elements ever pushed, i.e. the position the next element will take.
+        [[nodiscard]] std::size_t size() const { return this->pushed; }
+
+      private:
+        std::array<T, Capacity> slots{};
+        std::size_t             pushed = 0;
+    };
+}// namespace tek::utils
+
+#endif// TEK_RING_BUFFER_HPP
@@ -0,0 +1,29 @@
+#ifndef TEK_SPAN_HPP
+#define TEK_SPAN_HPP
+
+#include <cstddef>
+
+namespace tek::utils {
+    // Non owning view over a contiguous run of elements, a stand-in for C++20 std::span.
+    template<typename T>
+    class span
+    {
+      public:
+        constexpr span() = default;
+        constexpr span(T *first, const std::size_t count) : first{ first }, count{ count } {}
+
+        [[nodiscard]] constexpr T *begin() const { return this->first; }
+        [[nodiscard]] constexpr T *end() const { return this->first + this->count; }
+
+        [[nodiscard]] constexpr std::size_t size() const { return this->count; }
+        [[nodiscard]] constexpr bool        empty() const { return this->count == 0; }
+
+        [[nodiscard]] constexpr T &operator[](const std::size_t index) const { return this->first[index]; }
+
+      private:
+        T          *first = nullptr;
+        std::size_t count = 0;
+    };
+}// namespace tek::utils
+
+#endif// TEK_SPAN_HPP
@@ -0,0 +1,60 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace tek::utils {
+    thread_pool::thread_pool(std::size_t threads)
+    {
+        if (threads == 0) { threads = std::max(1u, std::thread::hardware_concurrency()); }
+
+        this->workers.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i) { this->workers.emplace_back(&thread_pool::work, this); }
+    }
+
+    thread_pool::~thread_pool()
+    {
+        {
+            std::lock_guard lock(this->mutex);
+            this->stopping = true;
+        }
+        this->task_ready.notify_all();
+
+        for (auto &worker : this->workers) { worker.join(); }
+    }
+
+    void thread_pool::submit(std::function<void()> task)
+    {
+        {
+            std::lock_guard lock(this->mutex);
+            this->tasks.push_back(std::move(task));
+        }
+        this->task_ready.notify_one();
+    }
+
+    void thread_pool::wait()
+    {
+        std::unique_lock lock(this->mutex);
+        this->idle.wait(lock, [this]() { return this->tasks.empty() && this->running == 0; });
+    }
+
+    void thread_pool::work()
+    {
+        std::unique_lock lock(this->mutex);
+        while (true) {
+            this->task_ready.wait(lock, [this]() { return this->stopping || !this->tasks.empty(); });
+            if (this->tasks.empty()) { return; }
+
+            auto task = std::move(this->tasks.front());
+            this->tasks.pop_front();
+            ++this->running;
+
+            lock.unlock();
+            task();
+            lock.lock();
+
+            --this->running;
+            if (this->tasks.empty() && this->running == 0) { this->idle.notify_all(); }
+        }
+    }
+}// namespace tek::utils
@@ -0,0 +1,48 @@
+#ifndef TEK_THREAD_POOL_HPP
+#define TEK_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tek::utils {
+    // Fixed set of worker threads running tasks in the order they were submitted. Tasks must not throw.
+    class thread_pool
+    {
+      public:
+        // 0 starts one worker per hardware thread.
+        explicit thread_pool(std::size_t threads = 0);
+
+        thread_pool(const thread_pool &)            = delete;
+        thread_pool &operator=(const thread_pool &) = delete;
+
+        // Waits for the queued tasks to run.
+        ~thread_pool();
+
+        void submit(std::function<void()> task);
+
+        // Blocks until every task submitted so far has run.
+        void wait();
+
+        [[nodiscard]] std::size_t size() const { return this->workers.size(); }
+
+      private:
+        void work();
+
+      private:
+        std::mutex                        mutex;
+        std::condition_variable           task_ready;
+        std::condition_variable           idle;
+        std::deque<std::function<void()>> tasks;
+        std::size_t                       running  = 0;
+        bool                              stopping = false;
+
+        std::vector<std::thread> workers;
+    };
+}// namespace tek::utils
+
+#endif// TEK_THREAD_POOL_HPP
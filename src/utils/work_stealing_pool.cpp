@@ -0,0 +1,155 @@
+#include "work_stealing_pool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace tek::utils {
+    namespace {
+        // Set on the pool's own workers, tasks they submit go to their deque.
+        thread_local const work_stealing_pool *current_pool  = nullptr;
+        thread_local std::size_t               current_index = 0;
+    }// namespace
+
+    work_stealing_pool::work_stealing_pool(std::size_t threads)
+    {
+        if (threads == 0) { threads = std::max(1u, std::thread::hardware_concurrency()); }
+
+        this->queues.reserve(threads + 1);
+        for (std::size_t i = 0; i <= threads; ++i) { this->queues.push_back(std::make_unique<queue>()); }
+
+        this->workers.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i) { this->workers.emplace_back(&work_stealing_pool::work, this, i); }
+    }
+
+    work_stealing_pool::~work_stealing_pool()
+    {
+        {
+            std::lock_guard lock(this->sleep_mutex);
+            this->stopping = true;
+        }
+        this->task_ready.notify_all();
+
+        for (auto &worker : this->workers) { worker.join(); }
+
+        std::unique_lock lock(this->spare_mutex);
+        this->spare_exited.wait(lock, [this]() { return this->spares == 0; });
+    }
+
+    void work_stealing_pool::submit(std::function<void()> task)
+    {
+        const auto own = current_pool == this ? current_index : this->workers.size();
+        {
+            auto           &target = *this->queues[own];
+            std::lock_guard lock(target.mutex);
+            target.tasks.push_back(std::move(task));
+        }
+        this->queued.fetch_add(1);
+
+        // A worker going to sleep counts itself before it looks at `queued` a last time, so one of the two sees the
+        // other. Taking the lock makes sure it is waiting by the time it is notified.
+        if (this->sleeping.load() != 0) {
+            { std::lock_guard lock(this->sleep_mutex); }
+            this->task_ready.notify_one();
+        }
+        if (this->blocked.load() != 0) { this->start_spare_if_stuck(); }
+    }
+
+    bool work_stealing_pool::run_one()
+    {
+        auto task = this->take(current_pool == this ? current_index : this->workers.size());
+        if (!task) { return false; }
+
+        (*task)();
+        return true;
+    }
+
+    void work_stealing_pool::block()
+    {
+        // Threads outside the pool don't run its tasks either way.
+        if (current_pool != this) { return; }
+
+        this->blocked.fetch_add(1);
+        this->start_spare_if_stuck();
+    }
+
+    void work_stealing_pool::unblock()
+    {
+        if (current_pool == this) { this->blocked.fetch_sub(1); }
+    }
+
+    std::optional<std::function<void()>> work_stealing_pool::take(const std::size_t own)
+    {
+        if (this->queued.load() == 0) { return std::nullopt; }
+
+        if (own < this->workers.size()) {
+            auto           &mine = *this->queues[own];
+            std::lock_guard lock(mine.mutex);
+            if (!mine.tasks.empty()) {
+                auto task = std::move(mine.tasks.back());
+                mine.tasks.pop_back();
+                this->queued.fetch_sub(1);
+                return task;
+            }
+        }
+
+        for (std::size_t i = 0; i < this->queues.size(); ++i) {
+            auto           &victim = *this->queues[(own + 1 + i) % this->queues.size()];
+            std::lock_guard lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                auto task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                this->queued.fetch_sub(1);
+                return task;
+            }
+        }
+        return std::nullopt;
+    }
+
+    void work_stealing_pool::work(const std::size_t index)
+    {
+        current_pool  = this;
+        current_index = index;
+
+        while (true) {
+            if (auto task = this->take(index)) {
+                (*task)();
+                continue;
+            }
+
+            std::unique_lock lock(this->sleep_mutex);
+            this->sleeping.fetch_add(1);
+            this->task_ready.wait(lock, [this]() { return this->stopping || this->queued.load() != 0; });
+            this->sleeping.fetch_sub(1);
+            if (this->stopping) { return; }
+        }
+    }
+
+    void work_stealing_pool::start_spare_if_stuck()
+    {
+        std::lock_guard lock(this->spare_mutex);
+        if (this->queued.load() == 0 || this->blocked.load() < this->workers.size() + this->spares) { return; }
+
+        ++this->spares;
+        std::thread(&work_stealing_pool::spare, this).detach();
+    }
+
+    void work_stealing_pool::spare()
+    {
+        // Submits to the queue of other threads, having no deque of its own.
+        current_pool  = this;
+        current_index = this->workers.size();
+
+        while (true) {
+            while (auto task = this->take(current_index)) { (*task)(); }
+
+            // Under the lock a task submitted meanwhile either is seen here or finds this thread gone.
+            std::lock_guard lock(this->spare_mutex);
+            if (this->queued.load() != 0) { continue; }
+
+            current_pool = nullptr;
+            --this->spares;
+            this->spare_exited.notify_all();
+            return;
+        }
+    }
+}// namespace tek::utils
@@ -0,0 +1,81 @@
+#ifndef TEK_WORK_STEALING_POOL_HPP
+#define TEK_WORK_STEALING_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace tek::utils {
+    // Worker threads with a deque each, for tasks that submit more tasks and wait on them. A worker submits to the back
+    // of its own deque and runs from there, newest first, while idle workers steal from the front of the others',
+    // where the oldest and usually largest pieces of work are. Other threads submit to a queue of their own that
+    // workers steal from too. Tasks must not throw.
+    class work_stealing_pool
+    {
+      public:
+        // 0 starts one worker per hardware thread.
+        explicit work_stealing_pool(std::size_t threads = 0);
+
+        work_stealing_pool(const work_stealing_pool &)            = delete;
+        work_stealing_pool &operator=(const work_stealing_pool &) = delete;
+
+        // Waits for the running tasks, those that didn't start yet are dropped.
+        ~work_stealing_pool();
+
+        void submit(std::function<void()> task);
+
+        // Runs a queued task on the calling thread if there is one, so that a thread waiting for a task to finish can
+        // help with the work in the meantime.
+        bool run_one();
+
+        // Around a task waiting for another one to make progress, rather than for work it could help with. While
+        // every thread of the pool is blocked, queued tasks are run by spare threads that last until the queues are
+        // empty, so tasks waiting on tasks that didn't start yet can't hold up the pool for good.
+        void block();
+        void unblock();
+
+        [[nodiscard]] std::size_t size() const { return this->workers.size(); }
+
+      private:
+        struct queue
+        {
+            std::mutex                        mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        // From the back of the deque of the worker `own`, or stolen from the front of any other.
+        std::optional<std::function<void()>> take(std::size_t own);
+
+        void work(std::size_t index);
+
+        void start_spare_if_stuck();
+        void spare();
+
+      private:
+        // One per worker, the last for tasks submitted by other threads.
+        std::vector<std::unique_ptr<queue>> queues;
+        std::atomic<std::size_t>            queued{ 0 };
+
+        std::mutex               sleep_mutex;
+        std::condition_variable  task_ready;
+        std::atomic<std::size_t> sleeping{ 0 };
+        bool                     stopping = false;
+
+        std::vector<std::thread> workers;
+
+        // Spare threads are detached, the pool waits for them to run out of work when destroyed.
+        std::atomic<std::size_t> blocked{ 0 };
+        std::mutex               spare_mutex;
+        std::condition_variable  spare_exited;
+        std::size_t              spares = 0;
+    };
+}// namespace tek::utils
+
+#endif// TEK_WORK_STEALING_POOL_HPP